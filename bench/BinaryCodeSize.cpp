@@ -0,0 +1,114 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * The same program gets built twice, once as it is and once with
+ * AUTOCEREAL_INTERPRETED_BINARY defined (see bench/CMakeLists.txt).
+ * Each run prints how long a binary round trip through all the
+ * message types takes. For the code size side of things compare the
+ * two executables:
+ *
+ *     size binary_code_size_templates binary_code_size_interpreted
+ *
+ * and for i-cache pressure, run both under
+ * perf stat -e instructions,L1-icache-load-misses
+ *
+ * BENCH_MESSAGE_TYPES distinct types stand in for a big schema. Each
+ * one is a different class as far as the templates are concerned, so
+ * each gets its own helper chain in the template build.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <cereal/types/string.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <spanstream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+inline constexpr int BENCH_MESSAGE_TYPES = 96;
+
+template <int N>
+struct BenchHeader {
+  uint64_t sequence;
+  uint32_t source;
+  uint32_t flags;
+};
+
+template <int N>
+struct BenchMessage {
+  BenchHeader<N> header;
+  int32_t count;
+  double value;
+  std::string name;
+  std::vector<int32_t> samples;
+  std::vector<BenchHeader<N>> history;
+};
+
+template <int N>
+BenchMessage<N> makeMessage() {
+  BenchMessage<N> message;
+  message.header = {static_cast<uint64_t>(N), 7, 1};
+  message.count = N;
+  message.value = N * 0.5;
+  message.name = "message type " + std::to_string(N);
+  message.samples.assign(16, N);
+  message.history.assign(4, message.header);
+  return message;
+}
+
+template <int N>
+size_t roundTrip(const BenchMessage<N>& message, BenchMessage<N>& copy) {
+  std::ostringstream out;
+  fr::autocereal::to_binary(message, out);
+  std::string bytes = std::move(out).str();
+  std::ispanstream in(std::span<const char>(bytes.data(), bytes.size()));
+  fr::autocereal::from_binary(copy, in);
+  return bytes.size();
+}
+
+template <int... N>
+size_t runAll(std::integer_sequence<int, N...>, size_t rounds) {
+  std::tuple<BenchMessage<N>...> messages{makeMessage<N>()...};
+  std::tuple<BenchMessage<N>...> copies;
+  size_t bytes = 0;
+  for (size_t round = 0; round < rounds; ++round) {
+    ((bytes += roundTrip(std::get<N>(messages), std::get<N>(copies))), ...);
+  }
+  return bytes;
+}
+
+int main() {
+#if defined(AUTOCEREAL_INTERPRETED_BINARY)
+  const char* mode = "interpreted";
+#else
+  const char* mode = "templates";
+#endif
+  const size_t rounds = 5000;
+
+  auto start = std::chrono::steady_clock::now();
+  size_t bytes = runAll(std::make_integer_sequence<int, BENCH_MESSAGE_TYPES>{}, rounds);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  double trips = static_cast<double>(rounds * BENCH_MESSAGE_TYPES);
+  double nanos = std::chrono::duration<double, std::nano>(elapsed).count();
+  std::cout << mode << ": " << nanos / trips << " ns per round trip, "
+            << bytes / trips << " bytes per message\n";
+}
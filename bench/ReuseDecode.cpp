@@ -0,0 +1,119 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * Decoding a stream of messages into one reused message object,
+ * versus a fresh object per message. Prints time and heap
+ * allocations per decode for each.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <cereal/types/string.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <span>
+#include <spanstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+  size_t allocations = 0;
+}
+
+void* operator new(size_t size) {
+  ++allocations;
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+struct BenchPart {
+  int number;
+  std::string label;
+  std::vector<double> readings;
+};
+
+struct BenchMessage {
+  int id;
+  std::string body;
+  std::vector<BenchPart> parts;
+};
+
+static BenchMessage makeMessage(int seed) {
+  BenchMessage message;
+  message.id = seed;
+  message.body = "message body " + std::to_string(seed) + std::string(200, 'b');
+  for (int i = 0; i < 16; ++i) {
+    message.parts.push_back({i, "part label that lives on the heap " + std::to_string(i), std::vector<double>(32, seed)});
+  }
+  return message;
+}
+
+template <typename Decode>
+static void run(const char* name, const std::vector<std::string>& encoded, size_t rounds, Decode&& decode) {
+  // Warm up, so the reused object has its capacity
+  for (const auto& bytes : encoded) {
+    decode(bytes);
+  }
+
+  size_t before = allocations;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < rounds; ++round) {
+    for (const auto& bytes : encoded) {
+      decode(bytes);
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  double decodes = static_cast<double>(rounds * encoded.size());
+  double nanos = std::chrono::duration<double, std::nano>(elapsed).count();
+  std::cout << name << ": " << nanos / decodes << " ns/decode, "
+            << static_cast<double>(allocations - before) / decodes << " allocations/decode\n";
+}
+
+int main() {
+  std::vector<std::string> encoded;
+  for (int seed = 0; seed < 64; ++seed) {
+    std::stringstream stream;
+    fr::autocereal::to_binary(makeMessage(seed), stream);
+    encoded.push_back(stream.str());
+  }
+  const size_t rounds = 2000;
+
+  run("fresh object", encoded, rounds, [](const std::string& bytes) {
+    BenchMessage message;
+    std::ispanstream stream(std::span<const char>(bytes.data(), bytes.size()));
+    fr::autocereal::from_binary(message, stream);
+  });
+
+  BenchMessage reused;
+  run("reused object", encoded, rounds, [&](const std::string& bytes) {
+    std::ispanstream stream(std::span<const char>(bytes.data(), bytes.size()));
+    fr::autocereal::from_binary(reused, stream);
+  });
+}
@@ -0,0 +1,921 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * Apache Arrow IPC file export/import for spans of flat reflected
+ * structs, without pulling in the Arrow C++ library.
+ *
+ * Each (flattened) member becomes a column. Supported member types
+ * are bool, the integer types, enums (as their underlying integer),
+ * float, double and std::string, plus std::optional of any of those,
+ * which turns into a nullable column with a validity bitmap.
+ *
+ * The output is the Arrow IPC *file* format (the "ARROW1" one you can
+ * memory map), so pyarrow.ipc.open_file, DuckDB, polars and friends
+ * can read it without reparsing anything.
+ *
+ * The Arrow metadata is flatbuffers. Rather than drag flatbuffers in
+ * as well, there's a tiny writer and reader for it down in the detail
+ * namespace that knows just enough to produce and consume Schema,
+ * RecordBatch and Footer tables.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/traits.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fr::autocereal {
+
+  /**
+   * Rows per record batch when writing. Readers handle any batch size.
+   */
+
+  inline constexpr size_t ARROW_BATCH_ROWS = 64 * 1024;
+
+  /**
+   * Body buffers are padded out to this. Arrow only requires 8, but
+   * 64 is what it recommends so that SIMD consumers can use the
+   * buffers in place.
+   */
+
+  inline constexpr size_t ARROW_BUFFER_ALIGNMENT = 64;
+
+  namespace detail::arrow {
+
+    // Enum values straight out of Schema.fbs/Message.fbs
+
+    inline constexpr int16_t METADATA_V5 = 4;
+    inline constexpr uint8_t HEADER_SCHEMA = 1;
+    inline constexpr uint8_t HEADER_RECORD_BATCH = 3;
+
+    enum class TypeId : uint8_t {
+      Int = 2,
+      FloatingPoint = 3,
+      Utf8 = 5,
+      Bool = 6
+    };
+
+    inline constexpr int16_t PRECISION_SINGLE = 1;
+    inline constexpr int16_t PRECISION_DOUBLE = 2;
+
+    inline constexpr std::string_view MAGIC = "ARROW1";
+    inline constexpr uint32_t CONTINUATION = 0xFFFFFFFF;
+
+    constexpr size_t alignUp(size_t value, size_t alignment) {
+      return (value + alignment - 1) / alignment * alignment;
+    }
+
+    /**
+     * One scalar or offset field of a flatbuffer table. Offsets get
+     * filled in later with FlatBufferWriter::link, once the thing they
+     * point to has been written.
+     */
+
+    struct FlatField {
+      uint16_t slot;
+      uint8_t size;
+      uint64_t value = 0;
+      bool offset = false;
+    };
+
+    struct FlatTableRef {
+      size_t position = 0;
+      // Position of each slot's storage in the buffer, for link()
+      std::array<size_t, 8> slots{};
+    };
+
+    /**
+     * Minimal front-to-back flatbuffer writer. Real flatbuffers builds
+     * back to front, but our documents are small and fixed in shape,
+     * so we write parents first and point their offset fields at the
+     * children as we write those. uoffsets only ever point forward, so
+     * this keeps the format happy.
+     */
+
+    class FlatBufferWriter {
+      std::vector<uint8_t> _bytes;
+
+      void pad(size_t alignment, size_t bias = 0) {
+        while ((_bytes.size() + bias) % alignment != 0) {
+          _bytes.push_back(0);
+        }
+      }
+
+      template <typename V>
+      void put(V value) {
+        size_t pos = _bytes.size();
+        _bytes.resize(pos + sizeof(V));
+        std::memcpy(_bytes.data() + pos, &value, sizeof(V));
+      }
+
+      template <typename V>
+      void putAt(size_t pos, V value) {
+        std::memcpy(_bytes.data() + pos, &value, sizeof(V));
+      }
+
+    public:
+      FlatBufferWriter() {
+        // Root table offset, linked by whoever writes the root table
+        put<uint32_t>(0);
+      }
+
+      static constexpr size_t ROOT = 0;
+
+      void link(size_t slot, size_t target) {
+        putAt<uint32_t>(slot, static_cast<uint32_t>(target - slot));
+      }
+
+      FlatTableRef table(std::initializer_list<FlatField> fields) {
+        std::vector<FlatField> sorted(fields);
+        // Largest first keeps the padding down
+        std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.size > b.size; });
+
+        uint16_t slotCount = 0;
+        std::array<uint16_t, 8> fieldOffsets{};
+        size_t inlineSize = sizeof(int32_t);
+        for (const auto& field : sorted) {
+          inlineSize = alignUp(inlineSize, field.size);
+          fieldOffsets[field.slot] = static_cast<uint16_t>(inlineSize);
+          inlineSize += field.size;
+          slotCount = std::max<uint16_t>(slotCount, field.slot + 1);
+        }
+
+        pad(2);
+        size_t vtablePos = _bytes.size();
+        put<uint16_t>(static_cast<uint16_t>(4 + 2 * slotCount));
+        put<uint16_t>(static_cast<uint16_t>(inlineSize));
+        for (uint16_t slot = 0; slot < slotCount; ++slot) {
+          put<uint16_t>(fieldOffsets[slot]);
+        }
+
+        pad(8);
+        FlatTableRef ref;
+        ref.position = _bytes.size();
+        _bytes.resize(ref.position + inlineSize, 0);
+        putAt<int32_t>(ref.position, static_cast<int32_t>(ref.position - vtablePos));
+        for (const auto& field : sorted) {
+          size_t pos = ref.position + fieldOffsets[field.slot];
+          ref.slots[field.slot] = pos;
+          if (!field.offset) {
+            std::memcpy(_bytes.data() + pos, &field.value, field.size);
+          }
+        }
+        return ref;
+      }
+
+      size_t string(std::string_view str) {
+        pad(4);
+        size_t pos = _bytes.size();
+        put<uint32_t>(static_cast<uint32_t>(str.size()));
+        _bytes.insert(_bytes.end(), str.begin(), str.end());
+        _bytes.push_back(0);
+        return pos;
+      }
+
+      // Vector of offsets to tables. Slots come back in element order
+      // for linking.
+      size_t offsetVector(size_t count, std::vector<size_t>& slots) {
+        pad(4);
+        size_t pos = _bytes.size();
+        put<uint32_t>(static_cast<uint32_t>(count));
+        for (size_t i = 0; i < count; ++i) {
+          slots.push_back(_bytes.size());
+          put<uint32_t>(0);
+        }
+        return pos;
+      }
+
+      // Vector of 8-byte aligned structs (FieldNode, Buffer, Block)
+      size_t structVector(const void* data, size_t count, size_t elementSize) {
+        pad(8, sizeof(uint32_t));
+        size_t pos = _bytes.size();
+        put<uint32_t>(static_cast<uint32_t>(count));
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        _bytes.insert(_bytes.end(), bytes, bytes + count * elementSize);
+        return pos;
+      }
+
+      std::vector<uint8_t> finish() {
+        pad(8);
+        return std::move(_bytes);
+      }
+    };
+
+    /**
+     * Read side. Everything is bounds checked since this is reading
+     * files from who knows where.
+     */
+
+    class FlatTable {
+      std::span<const uint8_t> _buffer;
+      size_t _position = 0;
+
+    public:
+      FlatTable(std::span<const uint8_t> buffer, size_t position) : _buffer(buffer), _position(position) {}
+
+      // Written so that a huge pos can't wrap around and pass
+      template <typename V>
+      V read(size_t pos) const {
+        if (pos > _buffer.size() || sizeof(V) > _buffer.size() - pos) {
+          throw cereal::Exception("Arrow metadata offset out of range");
+        }
+        V value;
+        std::memcpy(&value, _buffer.data() + pos, sizeof(V));
+        return value;
+      }
+
+      static FlatTable root(std::span<const uint8_t> buffer) {
+        FlatTable at(buffer, 0);
+        return FlatTable(buffer, at.read<uint32_t>(0));
+      }
+
+      size_t fieldPosition(uint16_t slot) const {
+        int64_t vtablePos = static_cast<int64_t>(_position) - read<int32_t>(_position);
+        if (vtablePos < 0 || static_cast<uint64_t>(vtablePos) >= _buffer.size()) {
+          throw cereal::Exception("Arrow metadata vtable out of range");
+        }
+        auto vtable = static_cast<size_t>(vtablePos);
+        auto vtableSize = read<uint16_t>(vtable);
+        if (4u + 2u * slot >= vtableSize) {
+          return 0;
+        }
+        auto offset = read<uint16_t>(vtable + 4 + 2 * slot);
+        return offset == 0 ? 0 : _position + offset;
+      }
+
+      template <typename V>
+      V scalar(uint16_t slot, V defaultValue = V{}) const {
+        size_t pos = fieldPosition(slot);
+        return pos == 0 ? defaultValue : read<V>(pos);
+      }
+
+      // Follows the uoffset at pos
+      size_t indirect(size_t pos) const {
+        auto offset = read<uint32_t>(pos);
+        // read() has checked pos is in range, so this can't wrap
+        if (offset > _buffer.size() - pos) {
+          throw cereal::Exception("Arrow metadata offset out of range");
+        }
+        return pos + offset;
+      }
+
+      std::optional<FlatTable> table(uint16_t slot) const {
+        size_t pos = fieldPosition(slot);
+        if (pos == 0) {
+          return std::nullopt;
+        }
+        return FlatTable(_buffer, indirect(pos));
+      }
+
+      std::string_view string(uint16_t slot) const {
+        size_t pos = fieldPosition(slot);
+        if (pos == 0) {
+          return {};
+        }
+        size_t start = indirect(pos);
+        auto length = read<uint32_t>(start);
+        if (length > _buffer.size() - start - 4) {
+          throw cereal::Exception("Arrow metadata string out of range");
+        }
+        return std::string_view(reinterpret_cast<const char*>(_buffer.data()) + start + 4, length);
+      }
+
+      // Returns the position of the vector's first element and its length
+      std::pair<size_t, uint32_t> vector(uint16_t slot) const {
+        size_t pos = fieldPosition(slot);
+        if (pos == 0) {
+          return {0, 0};
+        }
+        size_t start = indirect(pos);
+        return {start + 4, read<uint32_t>(start)};
+      }
+
+      FlatTable tableAt(size_t elementPos) const {
+        return FlatTable(_buffer, indirect(elementPos));
+      }
+    };
+
+    struct FieldNode {
+      int64_t length;
+      int64_t nullCount;
+    };
+
+    struct BufferRef {
+      int64_t offset;
+      int64_t length;
+    };
+
+    struct Block {
+      int64_t offset;
+      int32_t metaDataLength;
+      int32_t padding;
+      int64_t bodyLength;
+    };
+
+    static_assert(sizeof(Block) == 24);
+
+    /**
+     * What a column looks like on the Arrow side
+     */
+
+    struct ColumnType {
+      TypeId id;
+      int32_t bitWidth = 0;
+      bool isSigned = false;
+      int16_t precision = 0;
+
+      bool operator==(const ColumnType&) const = default;
+    };
+
+    template <typename Member>
+    struct ColumnTraits {
+      static constexpr bool nullable = false;
+      using Value = Member;
+    };
+
+    template <typename Member>
+    struct ColumnTraits<std::optional<Member>> {
+      static constexpr bool nullable = true;
+      using Value = Member;
+    };
+
+    template <typename Value>
+    consteval ColumnType columnTypeOf() {
+      if constexpr (std::same_as<Value, bool>) {
+        return {TypeId::Bool};
+      } else if constexpr (std::is_enum_v<Value>) {
+        return columnTypeOf<std::underlying_type_t<Value>>();
+      } else if constexpr (std::is_integral_v<Value>) {
+        return {TypeId::Int, static_cast<int32_t>(sizeof(Value) * 8), std::is_signed_v<Value>};
+      } else if constexpr (std::same_as<Value, float>) {
+        return {TypeId::FloatingPoint, 0, false, PRECISION_SINGLE};
+      } else if constexpr (std::same_as<Value, double>) {
+        return {TypeId::FloatingPoint, 0, false, PRECISION_DOUBLE};
+      } else if constexpr (IsString<Value>) {
+        return {TypeId::Utf8};
+      } else {
+        static_assert(false, "to_arrow_ipc only handles bool, integers, enums, float, double and std::string members (optionally wrapped in std::optional)");
+      }
+    }
+
+    inline size_t bufferCount(TypeId id) {
+      return id == TypeId::Utf8 ? 3 : 2;
+    }
+
+    /**
+     * Accumulates one record batch body. Buffers are appended in
+     * column order and padded to ARROW_BUFFER_ALIGNMENT.
+     */
+
+    struct BatchBuilder {
+      std::vector<uint8_t> body;
+      std::vector<FieldNode> nodes;
+      std::vector<BufferRef> buffers;
+
+      void addBuffer(const void* data, size_t length) {
+        BufferRef ref{static_cast<int64_t>(body.size()), static_cast<int64_t>(length)};
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        body.insert(body.end(), bytes, bytes + length);
+        body.resize(alignUp(body.size(), ARROW_BUFFER_ALIGNMENT), 0);
+        buffers.push_back(ref);
+      }
+
+      void clear() {
+        body.clear();
+        nodes.clear();
+        buffers.clear();
+      }
+    };
+
+    inline void setBit(std::vector<uint8_t>& bitmap, size_t index) {
+      bitmap[index / 8] |= static_cast<uint8_t>(1u << (index % 8));
+    }
+
+    inline bool getBit(const uint8_t* bitmap, size_t index) {
+      return (bitmap[index / 8] >> (index % 8)) & 1u;
+    }
+
+    /**
+     * Writes one column for rows. get pulls the member out of a row.
+     */
+
+    template <typename Member, typename Row, typename Getter>
+    void writeColumn(std::span<const Row> rows, Getter get, BatchBuilder& batch) {
+      using Traits = ColumnTraits<Member>;
+      using Value = typename Traits::Value;
+      constexpr ColumnType type = columnTypeOf<Value>();
+      const size_t count = rows.size();
+
+      // Optional-aware accessor, returns nullptr for nulls
+      auto valueOf = [&](const Row& row) -> const Value* {
+        const Member& member = get(row);
+        if constexpr (Traits::nullable) {
+          return member.has_value() ? &*member : nullptr;
+        } else {
+          return &member;
+        }
+      };
+
+      int64_t nullCount = 0;
+      if constexpr (Traits::nullable) {
+        std::vector<uint8_t> validity((count + 7) / 8, 0);
+        for (size_t i = 0; i < count; ++i) {
+          if (valueOf(rows[i]) != nullptr) {
+            setBit(validity, i);
+          } else {
+            ++nullCount;
+          }
+        }
+        // An all-valid column can skip its bitmap entirely
+        batch.addBuffer(validity.data(), nullCount > 0 ? validity.size() : 0);
+      } else {
+        batch.addBuffer(nullptr, 0);
+      }
+      batch.nodes.push_back({static_cast<int64_t>(count), nullCount});
+
+      if constexpr (type.id == TypeId::Bool) {
+        std::vector<uint8_t> bits((count + 7) / 8, 0);
+        for (size_t i = 0; i < count; ++i) {
+          const Value* value = valueOf(rows[i]);
+          if (value != nullptr && *value) {
+            setBit(bits, i);
+          }
+        }
+        batch.addBuffer(bits.data(), bits.size());
+      } else if constexpr (type.id == TypeId::Utf8) {
+        std::vector<int32_t> offsets;
+        offsets.reserve(count + 1);
+        std::string data;
+        offsets.push_back(0);
+        for (size_t i = 0; i < count; ++i) {
+          const Value* value = valueOf(rows[i]);
+          if (value != nullptr) {
+            data.append(*value);
+          }
+          offsets.push_back(static_cast<int32_t>(data.size()));
+        }
+        batch.addBuffer(offsets.data(), offsets.size() * sizeof(int32_t));
+        batch.addBuffer(data.data(), data.size());
+      } else {
+        std::vector<Value> values(count, Value{});
+        for (size_t i = 0; i < count; ++i) {
+          const Value* value = valueOf(rows[i]);
+          if (value != nullptr) {
+            values[i] = *value;
+          }
+        }
+        batch.addBuffer(values.data(), values.size() * sizeof(Value));
+      }
+    }
+
+    /**
+     * Reads one column of a decoded batch back into rows
+     */
+
+    struct ColumnSource {
+      const uint8_t* validity = nullptr;
+      std::array<std::span<const uint8_t>, 3> buffers;
+      int64_t nullCount = 0;
+    };
+
+    template <typename Member, typename Row, typename Getter>
+    void readColumn(std::span<Row> rows, Getter get, const ColumnSource& source) {
+      using Traits = ColumnTraits<Member>;
+      using Value = typename Traits::Value;
+      constexpr ColumnType type = columnTypeOf<Value>();
+      const size_t count = rows.size();
+
+      if constexpr (!Traits::nullable) {
+        if (source.nullCount > 0) {
+          throw cereal::Exception("Arrow column contains nulls but the member is not a std::optional");
+        }
+      }
+
+      auto isValid = [&](size_t i) {
+        return source.validity == nullptr || getBit(source.validity, i);
+      };
+
+      auto need = [](std::span<const uint8_t> buffer, size_t bytes) {
+        if (buffer.size() < bytes) {
+          throw cereal::Exception("Arrow buffer is shorter than its record batch");
+        }
+      };
+
+      for (size_t i = 0; i < count; ++i) {
+        Member& member = get(rows[i]);
+        if constexpr (Traits::nullable) {
+          if (!isValid(i)) {
+            member.reset();
+            continue;
+          }
+        }
+
+        Value value{};
+        if constexpr (type.id == TypeId::Bool) {
+          need(source.buffers[1], (count + 7) / 8);
+          value = getBit(source.buffers[1].data(), i);
+        } else if constexpr (type.id == TypeId::Utf8) {
+          need(source.buffers[1], (count + 1) * sizeof(int32_t));
+          int32_t begin, end;
+          std::memcpy(&begin, source.buffers[1].data() + i * sizeof(int32_t), sizeof(int32_t));
+          std::memcpy(&end, source.buffers[1].data() + (i + 1) * sizeof(int32_t), sizeof(int32_t));
+          if (begin < 0 || end < begin || static_cast<size_t>(end) > source.buffers[2].size()) {
+            throw cereal::Exception("Arrow string offsets out of range");
+          }
+          value.assign(reinterpret_cast<const char*>(source.buffers[2].data()) + begin, end - begin);
+        } else {
+          need(source.buffers[1], count * sizeof(Value));
+          std::memcpy(&value, source.buffers[1].data() + i * sizeof(Value), sizeof(Value));
+        }
+
+        if constexpr (Traits::nullable) {
+          member.emplace(std::move(value));
+        } else {
+          member = std::move(value);
+        }
+      }
+    }
+
+    /**
+     * Schema flatbuffer for Row. Used by both the schema message and
+     * the footer, which carries its own copy.
+     */
+
+    template <typename Row>
+    void writeSchema(FlatBufferWriter& fb, size_t linkSlot) {
+      constexpr size_t columnCount = flatMemberCount<Row>();
+      constexpr uint16_t endianness = std::endian::native == std::endian::little ? 0 : 1;
+
+      auto schema = fb.table({
+          {0, 2, endianness},
+          {1, 4, 0, true}
+        });
+      fb.link(linkSlot, schema.position);
+
+      std::vector<size_t> fieldSlots;
+      fb.link(schema.slots[1], fb.offsetVector(columnCount, fieldSlots));
+
+      size_t column = 0;
+      forEachMember<Row>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+        using Member = member_type_t<Owner, index>;
+        using Traits = ColumnTraits<Member>;
+        constexpr ColumnType type = columnTypeOf<typename Traits::Value>();
+
+        auto field = fb.table({
+            {0, 4, 0, true},
+            {1, 1, Traits::nullable},
+            {2, 1, static_cast<uint8_t>(type.id)},
+            {3, 4, 0, true},
+            {5, 4, 0, true}
+          });
+        fb.link(fieldSlots[column++], field.position);
+        fb.link(field.slots[0], fb.string(ClassSingleton<Owner>::instance().memberAtIndex(index)));
+
+        FlatTableRef typeTable;
+        if constexpr (type.id == TypeId::Int) {
+          typeTable = fb.table({{0, 4, static_cast<uint32_t>(type.bitWidth)}, {1, 1, type.isSigned}});
+        } else if constexpr (type.id == TypeId::FloatingPoint) {
+          typeTable = fb.table({{0, 2, static_cast<uint16_t>(type.precision)}});
+        } else {
+          typeTable = fb.table({});
+        }
+        fb.link(field.slots[3], typeTable.position);
+
+        std::vector<size_t> noChildren;
+        fb.link(field.slots[5], fb.offsetVector(0, noChildren));
+      });
+    }
+
+    /**
+     * Writes an encapsulated message: continuation marker, metadata
+     * length, metadata padded to 8, then the body. Returns the number
+     * of metadata bytes including the prefix, which is what the
+     * footer's Block wants.
+     */
+
+    template <typename Stream>
+    int32_t writeMessage(Stream& stream, const std::vector<uint8_t>& metadata, const std::vector<uint8_t>& body) {
+      int32_t metadataSize = static_cast<int32_t>(alignUp(metadata.size(), 8));
+      uint32_t continuation = CONTINUATION;
+      stream.write(reinterpret_cast<const char*>(&continuation), sizeof(continuation));
+      stream.write(reinterpret_cast<const char*>(&metadataSize), sizeof(metadataSize));
+      stream.write(reinterpret_cast<const char*>(metadata.data()), metadata.size());
+      static constexpr std::array<char, 8> zeros{};
+      stream.write(zeros.data(), metadataSize - metadata.size());
+      stream.write(reinterpret_cast<const char*>(body.data()), body.size());
+      return metadataSize + 8;
+    }
+
+    /**
+     * Decoded schema, as far as we care about it
+     */
+
+    struct SchemaField {
+      std::string name;
+      bool nullable = false;
+      ColumnType type;
+    };
+
+    inline std::vector<SchemaField> readSchema(const FlatTable& schema) {
+      std::vector<SchemaField> fields;
+      auto [fieldsPos, fieldCount] = schema.vector(1);
+      for (uint32_t i = 0; i < fieldCount; ++i) {
+        FlatTable field = schema.tableAt(fieldsPos + 4 * i);
+        SchemaField decoded;
+        decoded.name = std::string(field.string(0));
+        decoded.nullable = field.scalar<uint8_t>(1) != 0;
+        auto typeId = static_cast<TypeId>(field.scalar<uint8_t>(2));
+        auto typeTable = field.table(3);
+        switch (typeId) {
+        case TypeId::Int:
+          decoded.type = {TypeId::Int,
+                          typeTable ? typeTable->scalar<int32_t>(0) : 0,
+                          typeTable ? typeTable->scalar<uint8_t>(1) != 0 : false};
+          break;
+        case TypeId::FloatingPoint:
+          decoded.type = {TypeId::FloatingPoint, 0, false, typeTable ? typeTable->scalar<int16_t>(0) : int16_t{0}};
+          break;
+        case TypeId::Utf8:
+        case TypeId::Bool:
+          decoded.type = {typeId};
+          break;
+        default:
+          throw cereal::Exception("Unsupported Arrow column type in column " + decoded.name);
+        }
+        if (field.vector(5).second != 0) {
+          throw cereal::Exception("Nested Arrow columns are not supported: " + decoded.name);
+        }
+        fields.push_back(std::move(decoded));
+      }
+      return fields;
+    }
+
+  }
+
+  /**
+   * to_arrow_ipc writes rows to stream as an Arrow IPC file, in
+   * record batches of batchRows rows.
+   */
+
+  template <typename T, typename Stream>
+  requires IsOutputStream<Stream>
+  void to_arrow_ipc(std::span<const T> rows, Stream& stream, size_t batchRows = ARROW_BATCH_ROWS) {
+    using namespace detail::arrow;
+    batchRows = std::max<size_t>(batchRows, 1);
+
+    // Magic is padded out to 8 so the first message stays aligned
+    static constexpr std::array<char, 8> magic{'A', 'R', 'R', 'O', 'W', '1', 0, 0};
+    stream.write(magic.data(), magic.size());
+    int64_t position = magic.size();
+
+    {
+      FlatBufferWriter fb;
+      auto message = fb.table({
+          {0, 2, static_cast<uint16_t>(METADATA_V5)},
+          {1, 1, HEADER_SCHEMA},
+          {2, 4, 0, true},
+          {3, 8, 0}
+        });
+      fb.link(FlatBufferWriter::ROOT, message.position);
+      writeSchema<T>(fb, message.slots[2]);
+      position += writeMessage(stream, fb.finish(), {});
+    }
+
+    std::vector<Block> blocks;
+    BatchBuilder batch;
+    for (size_t start = 0; start < rows.size(); start += batchRows) {
+      auto slice = rows.subspan(start, std::min(batchRows, rows.size() - start));
+      batch.clear();
+
+      forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+        constexpr auto info = member_info<Owner, index>();
+        using Member = member_type_t<Owner, index>;
+        writeColumn<Member>(slice, [](const T& row) -> const Member& { return member_ref_const<Owner, info>(row); }, batch);
+      });
+
+      FlatBufferWriter fb;
+      auto message = fb.table({
+          {0, 2, static_cast<uint16_t>(METADATA_V5)},
+          {1, 1, HEADER_RECORD_BATCH},
+          {2, 4, 0, true},
+          {3, 8, batch.body.size()}
+        });
+      fb.link(FlatBufferWriter::ROOT, message.position);
+      auto recordBatch = fb.table({
+          {0, 8, slice.size()},
+          {1, 4, 0, true},
+          {2, 4, 0, true}
+        });
+      fb.link(message.slots[2], recordBatch.position);
+      fb.link(recordBatch.slots[1], fb.structVector(batch.nodes.data(), batch.nodes.size(), sizeof(FieldNode)));
+      fb.link(recordBatch.slots[2], fb.structVector(batch.buffers.data(), batch.buffers.size(), sizeof(BufferRef)));
+
+      Block block{position, 0, 0, static_cast<int64_t>(batch.body.size())};
+      block.metaDataLength = writeMessage(stream, fb.finish(), batch.body);
+      position += block.metaDataLength + block.bodyLength;
+      blocks.push_back(block);
+    }
+
+    // End of stream marker, then the footer
+    uint32_t eos[2] = {CONTINUATION, 0};
+    stream.write(reinterpret_cast<const char*>(eos), sizeof(eos));
+
+    FlatBufferWriter fb;
+    auto footer = fb.table({
+        {0, 2, static_cast<uint16_t>(METADATA_V5)},
+        {1, 4, 0, true},
+        {2, 4, 0, true},
+        {3, 4, 0, true}
+      });
+    fb.link(FlatBufferWriter::ROOT, footer.position);
+    writeSchema<T>(fb, footer.slots[1]);
+    fb.link(footer.slots[2], fb.structVector(nullptr, 0, sizeof(Block)));
+    fb.link(footer.slots[3], fb.structVector(blocks.data(), blocks.size(), sizeof(Block)));
+    auto footerBytes = fb.finish();
+    stream.write(reinterpret_cast<const char*>(footerBytes.data()), footerBytes.size());
+    int32_t footerSize = static_cast<int32_t>(footerBytes.size());
+    stream.write(reinterpret_cast<const char*>(&footerSize), sizeof(footerSize));
+    stream.write(MAGIC.data(), MAGIC.size());
+  }
+
+  /**
+   * Vector convenience version of to_arrow_ipc
+   */
+
+  template <typename T, typename Stream>
+  requires IsOutputStream<Stream>
+  void to_arrow_ipc(const std::vector<T>& rows, Stream& stream, size_t batchRows = ARROW_BATCH_ROWS) {
+    to_arrow_ipc(std::span<const T>(rows), stream, batchRows);
+  }
+
+  /**
+   * from_arrow_ipc appends the rows in an Arrow IPC file (or stream)
+   * to rows. Columns are matched to members by name and must have the
+   * exact same type. Columns we don't have a member for are skipped,
+   * members with no column are left default constructed.
+   */
+
+  template <typename T, typename Stream>
+  requires IsInputStream<Stream>
+  void from_arrow_ipc(std::vector<T>& rows, Stream& stream) {
+    using namespace detail::arrow;
+
+    auto readExactly = [&](void* data, size_t size) {
+      stream.read(static_cast<char*>(data), size);
+      if (static_cast<size_t>(stream.gcount()) != size) {
+        throw cereal::Exception("Unexpected end of Arrow IPC data");
+      }
+    };
+
+    // The file format has an 8 byte magic header, the stream format
+    // starts right in on messages.
+    std::array<char, 8> head;
+    readExactly(head.data(), head.size());
+    bool inHead = std::string_view(head.data(), MAGIC.size()) != MAGIC;
+
+    bool haveSchema = false;
+    std::vector<SchemaField> schema;
+    // Column index in the file, per flattened member. -1 for no column.
+    std::vector<int> columnFor;
+    std::vector<uint8_t> metadata;
+    std::vector<uint8_t> body;
+
+    while (true) {
+      uint32_t continuation;
+      int32_t metadataSize;
+      if (inHead) {
+        std::memcpy(&continuation, head.data(), sizeof(continuation));
+        std::memcpy(&metadataSize, head.data() + 4, sizeof(metadataSize));
+        inHead = false;
+      } else {
+        stream.read(reinterpret_cast<char*>(&continuation), sizeof(continuation));
+        if (stream.gcount() == 0) {
+          break;
+        }
+        if (stream.gcount() != sizeof(continuation)) {
+          throw cereal::Exception("Unexpected end of Arrow IPC data");
+        }
+        readExactly(&metadataSize, sizeof(metadataSize));
+      }
+      // Pre-0.15 streams without the continuation marker aren't supported
+      if (continuation != CONTINUATION) {
+        throw cereal::Exception("Not an Arrow IPC message");
+      }
+      if (metadataSize == 0) {
+        // End of stream. In a file the footer follows, which we don't need.
+        break;
+      }
+      if (metadataSize < 0) {
+        throw cereal::Exception("Bad Arrow message length");
+      }
+
+      metadata.resize(metadataSize);
+      readExactly(metadata.data(), metadata.size());
+      FlatTable message = FlatTable::root(metadata);
+      auto headerType = message.scalar<uint8_t>(1);
+      auto header = message.table(2);
+      auto bodyLength = message.scalar<int64_t>(3);
+      if (!header || bodyLength < 0) {
+        throw cereal::Exception("Arrow message has no header");
+      }
+      body.resize(bodyLength);
+      readExactly(body.data(), body.size());
+
+      if (headerType == HEADER_SCHEMA) {
+        schema = readSchema(*header);
+        haveSchema = true;
+        columnFor.clear();
+        forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+          using Member = member_type_t<Owner, index>;
+          constexpr ColumnType type = columnTypeOf<typename ColumnTraits<Member>::Value>();
+          const auto& name = ClassSingleton<Owner>::instance().memberAtIndex(index);
+          auto found = std::find_if(schema.begin(), schema.end(), [&](const auto& field) { return field.name == name; });
+          if (found != schema.end() && found->type != type) {
+            throw cereal::Exception("Arrow column " + name + " does not match the member's type");
+          }
+          columnFor.push_back(found == schema.end() ? -1 : static_cast<int>(found - schema.begin()));
+        });
+      } else if (headerType == HEADER_RECORD_BATCH) {
+        if (!haveSchema) {
+          throw cereal::Exception("Arrow record batch before schema");
+        }
+        if (header->table(3)) {
+          throw cereal::Exception("Compressed Arrow record batches are not supported");
+        }
+        auto length = header->scalar<int64_t>(0);
+        auto [nodesPos, nodeCount] = header->vector(1);
+        auto [buffersPos, bufferCountInBatch] = header->vector(2);
+        if (length < 0 || nodeCount != schema.size()) {
+          throw cereal::Exception("Arrow record batch does not match its schema");
+        }
+
+        // Work out where each column's buffers live in the body
+        std::vector<ColumnSource> sources(schema.size());
+        size_t buffer = 0;
+        for (size_t column = 0; column < schema.size(); ++column) {
+          auto& source = sources[column];
+          source.nullCount = header->read<int64_t>(nodesPos + column * sizeof(FieldNode) + sizeof(int64_t));
+          size_t needed = bufferCount(schema[column].type.id);
+          if (buffer + needed > bufferCountInBatch) {
+            throw cereal::Exception("Arrow record batch is missing buffers");
+          }
+          for (size_t i = 0; i < needed; ++i, ++buffer) {
+            auto offset = header->read<int64_t>(buffersPos + buffer * sizeof(BufferRef));
+            auto size = header->read<int64_t>(buffersPos + buffer * sizeof(BufferRef) + sizeof(int64_t));
+            if (offset < 0 || size < 0 || static_cast<uint64_t>(offset) > body.size()
+                || static_cast<uint64_t>(size) > body.size() - static_cast<size_t>(offset)) {
+              throw cereal::Exception("Arrow buffer out of range");
+            }
+            source.buffers[i] = std::span<const uint8_t>(body.data() + offset, size);
+          }
+          if (source.nullCount > 0) {
+            if (source.buffers[0].size() < static_cast<size_t>((length + 7) / 8)) {
+              throw cereal::Exception("Arrow validity bitmap too short");
+            }
+            source.validity = source.buffers[0].data();
+          }
+        }
+
+        size_t first = rows.size();
+        rows.resize(first + length);
+        std::span<T> slice(rows.data() + first, length);
+        size_t member = 0;
+        forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+          constexpr auto info = member_info<Owner, index>();
+          using Member = member_type_t<Owner, index>;
+          int column = columnFor[member++];
+          if (column >= 0) {
+            readColumn<Member>(slice, [](T& row) -> Member& { return member_ref<Owner, info>(row); }, sources[column]);
+          }
+        });
+      }
+      // Dictionary batches and anything else just get skipped
+    }
+  }
+
+}
@@ -0,0 +1,486 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * File output that doesn't make the thread doing the serializing sit
+ * and wait on write().
+ *
+ * AsyncFileStreamBuf has two buffers. When the one the archive is
+ * writing into fills up it goes to the kernel through io_uring, and
+ * the archive carries on in the other one while the write happens.
+ * The only time the producer waits is when it's filled the second
+ * buffer before the kernel's done with the first. Both buffers are
+ * registered with the ring, so the kernel doesn't have to map them
+ * for every write.
+ *
+ * io_uring is only used if the build found liburing
+ * (AUTOCEREAL_HAS_LIBURING) and the kernel lets us set up a ring --
+ * plenty of containers don't. Otherwise it quietly falls back to
+ * plain pwrite, which blocks like it always did but otherwise
+ * behaves the same. If registering the buffers fails (usually the
+ * locked memory limit) the ring gets used with ordinary writes.
+ *
+ * With fsyncOnClose set, close() doesn't return until the data is on
+ * disk. Write errors are sticky and come out of close(), so call it
+ * yourself rather than leaving it to the destructor, which has to
+ * keep quiet about them.
+ *
+ * This is POSIX only.
+ */
+
+#include <fr/autocereal/autocereal.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifdef AUTOCEREAL_HAS_LIBURING
+#include <liburing.h>
+#endif
+
+namespace fr::autocereal {
+
+  struct AsyncFileOptions {
+    // Size of each of the two buffers
+    size_t bufferSize = 1024 * 1024;
+    bool fsyncOnClose = false;
+  };
+
+  namespace detail::async_file {
+
+    // One write can't be more than this, so neither can a buffer
+    inline constexpr size_t MAX_BUFFER_BYTES = 1024 * 1024 * 1024;
+
+    inline std::string errorText(const std::string& what, int error) {
+      return what + ": " + std::strerror(error);
+    }
+
+    /**
+     * Writes buffers to the file. write() starts writing one of the
+     * two buffers, and the buffer has to be left alone until wait()
+     * for the same slot returns. Once anything fails, everything after
+     * that throws the same error.
+     */
+
+    class Writer {
+    protected:
+      std::string _error;
+
+      void fail(const std::string& error) {
+        if (_error.empty()) {
+          _error = error;
+        }
+        throw cereal::Exception(_error);
+      }
+
+      void check() {
+        if (!_error.empty()) {
+          throw cereal::Exception(_error);
+        }
+      }
+
+    public:
+      virtual ~Writer() = default;
+      virtual void write(size_t slot, const char* data, size_t size, uint64_t offset) = 0;
+      virtual void wait(size_t slot) = 0;
+      virtual void fsync() = 0;
+      virtual bool uring() const = 0;
+    };
+
+    class PwriteWriter : public Writer {
+      int _fd;
+
+    public:
+      explicit PwriteWriter(int fd) : _fd(fd) {}
+
+      void write(size_t, const char* data, size_t size, uint64_t offset) override {
+        check();
+        while (size > 0) {
+          ssize_t written = ::pwrite(_fd, data, size, static_cast<off_t>(offset));
+          if (written < 0) {
+            if (errno == EINTR) {
+              continue;
+            }
+            fail(errorText("pwrite failed", errno));
+          }
+          if (written == 0) {
+            fail("pwrite wrote nothing");
+          }
+          data += written;
+          size -= static_cast<size_t>(written);
+          offset += static_cast<uint64_t>(written);
+        }
+      }
+
+      void wait(size_t) override {
+        check();
+      }
+
+      void fsync() override {
+        check();
+        if (::fsync(_fd) != 0) {
+          fail(errorText("fsync failed", errno));
+        }
+      }
+
+      bool uring() const override {
+        return false;
+      }
+    };
+
+#ifdef AUTOCEREAL_HAS_LIBURING
+
+    class UringWriter : public Writer {
+      struct Pending {
+        const char* data = nullptr;
+        size_t left = 0;
+        uint64_t offset = 0;
+        bool busy = false;
+      };
+
+      int _fd;
+      io_uring _ring;
+      bool _ready = false;
+      bool _registered = false;
+      std::array<Pending, 2> _slots;
+
+      explicit UringWriter(int fd) : _fd(fd) {}
+
+      void submit(size_t slot) {
+        Pending& pending = _slots[slot];
+        io_uring_sqe* sqe = io_uring_get_sqe(&_ring);
+        if (sqe == nullptr) {
+          fail("io_uring submission queue is full");
+        }
+        auto size = static_cast<unsigned>(pending.left);
+        if (_registered) {
+          io_uring_prep_write_fixed(sqe, _fd, pending.data, size, pending.offset, static_cast<int>(slot));
+        } else {
+          io_uring_prep_write(sqe, _fd, pending.data, size, pending.offset);
+        }
+        io_uring_sqe_set_data64(sqe, slot);
+        int submitted = io_uring_submit(&_ring);
+        if (submitted < 0) {
+          fail(errorText("io_uring_submit failed", -submitted));
+        }
+      }
+
+      // Takes one completion off the ring and deals with it. Short
+      // writes get the rest resubmitted.
+      void reap() {
+        io_uring_cqe* cqe = nullptr;
+        int result = io_uring_wait_cqe(&_ring, &cqe);
+        if (result == -EINTR) {
+          return;
+        }
+        if (result < 0) {
+          fail(errorText("io_uring_wait_cqe failed", -result));
+        }
+        size_t slot = static_cast<size_t>(io_uring_cqe_get_data64(cqe));
+        int written = cqe->res;
+        io_uring_cqe_seen(&_ring, cqe);
+
+        Pending& pending = _slots[slot];
+        if (written == -EINTR || written == -EAGAIN) {
+          submit(slot);
+          return;
+        }
+        if (written <= 0) {
+          pending.busy = false;
+          fail(written == 0 ? std::string("io_uring write wrote nothing") : errorText("io_uring write failed", -written));
+        }
+        pending.data += written;
+        pending.left -= static_cast<size_t>(written);
+        pending.offset += static_cast<uint64_t>(written);
+        if (pending.left == 0) {
+          pending.busy = false;
+        } else {
+          submit(slot);
+        }
+      }
+
+    public:
+      /**
+       * Returns null if the kernel won't give us a ring
+       */
+
+      static std::unique_ptr<UringWriter> create(int fd, std::array<std::vector<char>, 2>& buffers) {
+        std::unique_ptr<UringWriter> writer(new UringWriter(fd));
+        if (io_uring_queue_init(4, &writer->_ring, 0) < 0) {
+          return nullptr;
+        }
+        writer->_ready = true;
+        std::array<iovec, 2> iovecs;
+        for (size_t i = 0; i < buffers.size(); ++i) {
+          iovecs[i] = {buffers[i].data(), buffers[i].size()};
+        }
+        writer->_registered = io_uring_register_buffers(&writer->_ring, iovecs.data(), iovecs.size()) == 0;
+        return writer;
+      }
+
+      ~UringWriter() override {
+        if (!_ready) {
+          return;
+        }
+        // The kernel may still be reading a buffer that's about to be
+        // freed, so let it finish even if something's gone wrong
+        for (size_t slot = 0; slot < _slots.size(); ++slot) {
+          try {
+            wait(slot);
+          } catch (...) {
+            _slots[slot].busy = false;
+          }
+        }
+        io_uring_queue_exit(&_ring);
+      }
+
+      void write(size_t slot, const char* data, size_t size, uint64_t offset) override {
+        check();
+        _slots[slot] = {data, size, offset, true};
+        submit(slot);
+      }
+
+      void wait(size_t slot) override {
+        while (_slots[slot].busy) {
+          reap();
+        }
+        check();
+      }
+
+      void fsync() override {
+        check();
+        if (::fsync(_fd) != 0) {
+          fail(errorText("fsync failed", errno));
+        }
+      }
+
+      bool uring() const override {
+        return true;
+      }
+    };
+
+#endif
+
+    inline std::unique_ptr<Writer> makeWriter(int fd, std::array<std::vector<char>, 2>& buffers) {
+#ifdef AUTOCEREAL_HAS_LIBURING
+      if (auto writer = UringWriter::create(fd, buffers)) {
+        return writer;
+      }
+#else
+      (void) buffers;
+#endif
+      return std::make_unique<PwriteWriter>(fd);
+    }
+
+  }
+
+  class AsyncFileStreamBuf : public std::streambuf {
+    int _fd = -1;
+    bool _fsyncOnClose;
+    bool _closed = false;
+    std::array<std::vector<char>, 2> _buffers;
+    size_t _current = 0;
+    uint64_t _offset = 0;
+    std::unique_ptr<detail::async_file::Writer> _writer;
+
+    // Hands the current buffer to the writer and switches to the
+    // other one, once the kernel's finished with it
+    void submitCurrent() {
+      size_t size = static_cast<size_t>(pptr() - pbase());
+      if (size > 0) {
+        _writer->write(_current, pbase(), size, _offset);
+        _offset += size;
+        _current ^= 1;
+        _writer->wait(_current);
+      }
+      setp(_buffers[_current].data(), _buffers[_current].data() + _buffers[_current].size());
+    }
+
+  protected:
+    int_type overflow(int_type ch) override {
+      if (_closed) {
+        return traits_type::eof();
+      }
+      submitCurrent();
+      if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+      }
+      return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize count) override {
+      std::streamsize written = 0;
+      while (written < count) {
+        if (pptr() == epptr() && traits_type::eq_int_type(overflow(traits_type::eof()), traits_type::eof())) {
+          break;
+        }
+        auto chunk = std::min<std::streamsize>(count - written, epptr() - pptr());
+        std::memcpy(pptr(), data + written, static_cast<size_t>(chunk));
+        pbump(static_cast<int>(chunk));
+        written += chunk;
+      }
+      return written;
+    }
+
+    /**
+     * Flushing starts the write but doesn't wait for it. close() is
+     * what waits.
+     */
+
+    int sync() override {
+      if (!_closed) {
+        submitCurrent();
+      }
+      return 0;
+    }
+
+  public:
+    AsyncFileStreamBuf(const std::filesystem::path& path, const AsyncFileOptions& options = {})
+      : _fsyncOnClose(options.fsyncOnClose) {
+      size_t size = std::clamp<size_t>(options.bufferSize, 4096, detail::async_file::MAX_BUFFER_BYTES);
+      for (auto& buffer : _buffers) {
+        buffer.resize(size);
+      }
+      _fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      if (_fd < 0) {
+        throw cereal::Exception(detail::async_file::errorText("Could not open " + path.string(), errno));
+      }
+      // The destructor doesn't run if we throw from here, so the file
+      // has to be closed on the way out
+      try {
+        _writer = detail::async_file::makeWriter(_fd, _buffers);
+      } catch (...) {
+        ::close(_fd);
+        _fd = -1;
+        throw;
+      }
+      setp(_buffers[_current].data(), _buffers[_current].data() + _buffers[_current].size());
+    }
+
+    AsyncFileStreamBuf(const AsyncFileStreamBuf&) = delete;
+    AsyncFileStreamBuf& operator=(const AsyncFileStreamBuf&) = delete;
+
+    ~AsyncFileStreamBuf() override {
+      try {
+        close();
+      } catch (...) {
+      }
+      _writer.reset();
+      if (_fd >= 0) {
+        ::close(_fd);
+      }
+    }
+
+    /**
+     * True if writes are going through io_uring, false if it fell
+     * back to pwrite
+     */
+
+    bool uring() const {
+      return _writer && _writer->uring();
+    }
+
+    /**
+     * Writes whatever's left, waits for all of it, fsyncs if you
+     * asked for that and closes the file
+     */
+
+    void close() {
+      if (_closed) {
+        return;
+      }
+      _closed = true;
+      size_t size = static_cast<size_t>(pptr() - pbase());
+      setp(nullptr, nullptr);
+      if (size > 0) {
+        _writer->write(_current, _buffers[_current].data(), size, _offset);
+        _offset += size;
+      }
+      _writer->wait(0);
+      _writer->wait(1);
+      if (_fsyncOnClose) {
+        _writer->fsync();
+      }
+      _writer.reset();
+      int fd = _fd;
+      _fd = -1;
+      if (::close(fd) != 0) {
+        throw cereal::Exception(detail::async_file::errorText("close failed", errno));
+      }
+    }
+  };
+
+  class AsyncFileOutputStream : public std::ostream {
+    AsyncFileStreamBuf _buffer;
+
+  public:
+    AsyncFileOutputStream(const std::filesystem::path& path, const AsyncFileOptions& options = {})
+      : std::ostream(nullptr), _buffer(path, options) {
+      rdbuf(&_buffer);
+    }
+
+    ~AsyncFileOutputStream() override {
+      // Destructors can't throw, call close() yourself if you want
+      // to hear about errors
+      try {
+        _buffer.close();
+      } catch (...) {
+      }
+    }
+
+    bool uring() const {
+      return _buffer.uring();
+    }
+
+    void close() {
+      _buffer.close();
+    }
+  };
+
+  /**
+   * to_binary straight to a file through AsyncFileOutputStream
+   */
+
+  template <typename T>
+  void to_binary_file(const T& obj, const std::filesystem::path& path, const AsyncFileOptions& options = {}) {
+    AsyncFileOutputStream stream(path, options);
+    {
+      cereal::BinaryOutputArchive ar(stream);
+      to_output_archive(obj, ar);
+    }
+    // close() throws the actual write error if there was one
+    stream.close();
+    if (!stream) {
+      throw cereal::Exception("Failed writing " + path.string());
+    }
+  }
+
+}
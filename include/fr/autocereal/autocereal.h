@@ -29,9 +29,20 @@
 #include <algorithm>
 #include <array>
 #include <concepts>
+#include <cstdint>
 #include <meta>
 #include <string.h>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <spanstream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 namespace fr::autocereal {
@@ -55,6 +66,100 @@ namespace fr::autocereal {
   inline constexpr size_t MAX_IDENTIFIER_LENGTH = 256;
   inline constexpr size_t MAX_CLASS_MEMBERS = 256;
 
+  /**
+   * Annotations for members you don't want serialized.
+   *
+   * [[=fr::autocereal::skip]] makes a member invisible to autocereal.
+   * It isn't saved, it isn't loaded, it doesn't count toward the
+   * member count and nothing ever touches it. Handy for mutexes,
+   * thread handles and other things cereal couldn't do anything with
+   * anyway.
+   *
+   * [[=fr::autocereal::transient]] isn't saved or loaded either, but
+   * a binary or cereal load sets it back to a value-initialized one
+   * before reading the rest of the object. That goes for the
+   * interpreter, schema_binary, indexed and chunk_loader's binary
+   * side as well as plain cereal. The native JSON, streaming JSON and
+   * streaming XML readers only fill in what's in the text and leave
+   * transients alone. That's what you want for caches
+   * and other things worked out from the serialized members, since a
+   * reused object would otherwise hang on to the one it worked out
+   * for whatever you loaded into it last time. Transient members that
+   * can't be assigned are left alone, same as skip.
+   *
+   * Both are checked when the member list is built, so every format
+   * that walks the members -- cereal, the native json and csv
+   * readers, arrow, the schema fingerprint -- leaves them out.
+   */
+
+  struct SkipAnnotation {
+    constexpr bool operator==(const SkipAnnotation&) const = default;
+  };
+
+  struct TransientAnnotation {
+    constexpr bool operator==(const TransientAnnotation&) const = default;
+  };
+
+  inline constexpr SkipAnnotation skip{};
+  inline constexpr TransientAnnotation transient{};
+
+  namespace detail {
+
+    template <typename Annotation>
+    consteval bool hasAnnotation(std::meta::info member) {
+      for (auto annotation : std::meta::annotations_of(member)) {
+        if (std::meta::remove_cv(std::meta::type_of(annotation)) == ^^Annotation) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /**
+     * The members autocereal serializes, in declaration order
+     */
+
+    consteval std::vector<std::meta::info> serializedMembers(std::meta::info cls) {
+      std::vector<std::meta::info> members;
+      for (auto member : std::meta::nonstatic_data_members_of(cls, std::meta::access_context::unchecked())) {
+        if (!hasAnnotation<SkipAnnotation>(member) && !hasAnnotation<TransientAnnotation>(member)) {
+          members.push_back(member);
+        }
+      }
+      return members;
+    }
+
+    consteval std::vector<std::meta::info> transientMembers(std::meta::info cls) {
+      std::vector<std::meta::info> members;
+      for (auto member : std::meta::nonstatic_data_members_of(cls, std::meta::access_context::unchecked())) {
+        if (hasAnnotation<TransientAnnotation>(member) && !hasAnnotation<SkipAnnotation>(member)) {
+          members.push_back(member);
+        }
+      }
+      return members;
+    }
+
+    template <typename Class>
+    inline constexpr auto TRANSIENT_MEMBERS = std::define_static_array(transientMembers(^^Class));
+
+    /**
+     * Puts Class's own transient members back to value-initialized
+     */
+
+    template <typename Class, size_t index = 0>
+    void resetTransients(Class& instance) {
+      if constexpr (index < TRANSIENT_MEMBERS<Class>.size()) {
+        auto& member = instance.[:TRANSIENT_MEMBERS<Class>[index]:];
+        using Member = std::remove_cvref_t<decltype(member)>;
+        if constexpr (std::is_default_constructible_v<Member> && std::is_move_assignable_v<Member>) {
+          member = Member{};
+        }
+        resetTransients<Class, index + 1>(instance);
+      }
+    }
+
+  }
+
   /**
    * Define a singleton for any given class, which contains
    * an array of character arrays to the methods for the class
@@ -83,7 +188,7 @@ namespace fr::autocereal {
   template <typename Class>
   class ClassSingleton {
     constexpr static auto _ctx = std::meta::access_context::unchecked();
-    static constexpr size_t _memberCount = std::meta::nonstatic_data_members_of(^^Class, _ctx).size();
+    static constexpr size_t _memberCount = detail::serializedMembers(^^Class).size();
     // Number of parents this class has
     static constexpr size_t _baseCount = std::meta::bases_of(^^Class, _ctx).size();
     static constexpr auto _bases = std::define_static_array(std::meta::bases_of(^^Class, _ctx));
@@ -99,7 +204,7 @@ namespace fr::autocereal {
     consteval auto classMemberNames() {
       std::array<std::array<char, MAX_IDENTIFIER_LENGTH>, MAX_CLASS_MEMBERS> names;
 
-      auto members = std::meta::nonstatic_data_members_of(^^Class, _ctx);
+      auto members = detail::serializedMembers(^^Class);
       // We do MAX_CLASS_MEMBERS - 1 so we know we'll always hit a null
       // terminator in this array
       assert(members.size() < MAX_CLASS_MEMBERS - 1);
@@ -134,11 +239,11 @@ namespace fr::autocereal {
       return _memberNamesStrings[index];
     }
     
-    constexpr size_t memberCount() const {
+    static constexpr size_t memberCount() {
       return _memberCount;
     }
 
-    constexpr size_t baseCount() const {
+    static constexpr size_t baseCount() {
       return _baseCount;
     }
 
@@ -160,6 +265,27 @@ namespace fr::autocereal {
     }
     ~ClassSingleton() {}
   };
+
+  namespace detail {
+
+    /**
+     * resetTransients for Class and every class it inherits from. For
+     * the loaders that work down the flattened member list themselves
+     * instead of going through loadHelper.
+     */
+
+    template <typename Class, size_t index = 0>
+    void resetAllTransients(Class& instance) {
+      if constexpr (index < ClassSingleton<Class>::baseCount()) {
+        using Parent = typename ClassSingleton<Class>::template Parent<index>::Type;
+        resetAllTransients(static_cast<Parent&>(instance));
+        resetAllTransients<Class, index + 1>(instance);
+      } else {
+        resetTransients(instance);
+      }
+    }
+
+  }
   
   /**
    * Retrieve a memberinfo for a member, by index
@@ -169,8 +295,7 @@ namespace fr::autocereal {
   
   template <typename Class, size_t idx>
   consteval auto member_info() {
-    constexpr auto ctx = std::meta::access_context::unchecked();    
-    constexpr auto member = std::meta::nonstatic_data_members_of(^^Class, ctx)[idx];
+    constexpr auto member = detail::serializedMembers(^^Class)[idx];
     
     return member;
   }
@@ -186,14 +311,336 @@ namespace fr::autocereal {
   }
 
   /**
-   * We also need a const version of member_ref
+   * We also need a const version of member_ref. This hands back a
+   * reference too -- returning by value here copied every member
+   * (strings, vectors, the lot) on every save.
    */
 
   template <typename Class, auto info>
-  constexpr const auto member_ref_const(const Class &instance) {
+  constexpr const auto& member_ref_const(const Class &instance) {
     return instance.[:info:];
   }
 
+  namespace detail {
+
+    /**
+     * The memory_resource loads on this thread should allocate from.
+     * Only set while a from_json (or from_input_archive, etc) that was
+     * handed a resource is running, null the rest of the time.
+     */
+
+    inline std::pmr::memory_resource*& loadResource() {
+      thread_local std::pmr::memory_resource* resource = nullptr;
+      return resource;
+    }
+
+    class LoadResourceScope {
+      std::pmr::memory_resource* _previous;
+
+    public:
+      explicit LoadResourceScope(std::pmr::memory_resource* resource) : _previous(loadResource()) {
+        loadResource() = resource;
+      }
+
+      ~LoadResourceScope() {
+        loadResource() = _previous;
+      }
+
+      LoadResourceScope(const LoadResourceScope&) = delete;
+      LoadResourceScope& operator=(const LoadResourceScope&) = delete;
+    };
+
+    /**
+     * Points a std::pmr member at the load resource before it gets
+     * loaded. A polymorphic allocator can't be reassigned, so the
+     * member is rebuilt in place. It's about to be overwritten by the
+     * load anyway. Anything the member creates after that (vector
+     * elements, strings inside them) picks up the same resource
+     * through uses-allocator construction.
+     */
+
+    template <typename T>
+    void rebindToLoadResource(T& member) {
+      if constexpr (std::uses_allocator_v<T, std::pmr::polymorphic_allocator<std::byte>>) {
+        std::pmr::memory_resource* resource = loadResource();
+        if (resource != nullptr && member.get_allocator().resource() != resource) {
+          std::destroy_at(&member);
+          std::construct_at(&member, typename T::allocator_type(resource));
+        }
+      }
+    }
+
+  }
+
+  namespace detail {
+
+    /**
+     * Allocator for allocate_shared that hangs on to the pool it came
+     * from. Every node's control block holds one of these, so a pool
+     * we made ourselves stays alive until the last node loaded from it
+     * goes away.
+     */
+
+    template <typename T>
+    class SharedPoolAllocator {
+    public:
+      using value_type = T;
+
+      std::shared_ptr<std::pmr::memory_resource> resource;
+
+      explicit SharedPoolAllocator(std::shared_ptr<std::pmr::memory_resource> pool) : resource(std::move(pool)) {}
+
+      template <typename U>
+      SharedPoolAllocator(const SharedPoolAllocator<U>& other) : resource(other.resource) {}
+
+      T* allocate(size_t count) {
+        return static_cast<T*>(resource->allocate(count * sizeof(T), alignof(T)));
+      }
+
+      void deallocate(T* p, size_t count) noexcept {
+        resource->deallocate(p, count * sizeof(T), alignof(T));
+      }
+
+      template <typename U>
+      bool operator==(const SharedPoolAllocator<U>& other) const {
+        return resource == other.resource;
+      }
+    };
+
+  }
+
+  /**
+   * Where shared_ptr members get allocated from when you load with
+   * one. cereal's own shared_ptr load does a new for the object and
+   * another for the control block, per pointer. Loading through a
+   * SharedPool does one allocate_shared from the pool instead, which
+   * adds up when your object graph has millions of little shared
+   * nodes.
+   *
+   * A default constructed SharedPool makes its own
+   * synchronized_pool_resource. The nodes keep that alive, so you can
+   * let the SharedPool go as soon as the load's done. Use one per
+   * archive and a graph's nodes all end up packed together in the
+   * same pool.
+   *
+   * Or hand it a memory_resource of your own. That one isn't owned,
+   * so it has to outlive every pointer loaded from it, and if the
+   * pointers are going to get dropped on other threads it had better
+   * be thread safe.
+   */
+
+  class SharedPool {
+    std::shared_ptr<std::pmr::memory_resource> _resource;
+
+  public:
+    SharedPool() : _resource(std::make_shared<std::pmr::synchronized_pool_resource>()) {}
+
+    // The aliasing constructor with an empty owner gives us a
+    // shared_ptr that doesn't count anything, so copying it into every
+    // node costs nothing.
+    explicit SharedPool(std::pmr::memory_resource* resource) : _resource(std::shared_ptr<void>(), resource) {}
+
+    std::pmr::memory_resource* resource() const {
+      return _resource.get();
+    }
+
+    template <typename T>
+    std::shared_ptr<T> make() const {
+      return std::allocate_shared<T>(detail::SharedPoolAllocator<T>(_resource));
+    }
+  };
+
+  namespace detail {
+
+    /**
+     * The SharedPool loads on this thread should allocate shared_ptr
+     * members from, same deal as loadResource
+     */
+
+    inline const SharedPool*& loadSharedPool() {
+      thread_local const SharedPool* pool = nullptr;
+      return pool;
+    }
+
+    class SharedPoolScope {
+      const SharedPool* _previous;
+
+    public:
+      explicit SharedPoolScope(const SharedPool& pool) : _previous(loadSharedPool()) {
+        loadSharedPool() = &pool;
+      }
+
+      ~SharedPoolScope() {
+        loadSharedPool() = _previous;
+      }
+
+      SharedPoolScope(const SharedPoolScope&) = delete;
+      SharedPoolScope& operator=(const SharedPoolScope&) = delete;
+    };
+
+  }
+
+  namespace detail {
+
+    template <typename T>
+    struct isStdOptional : std::false_type {};
+
+    template <typename T>
+    struct isStdOptional<std::optional<T>> : std::true_type {};
+
+    template <typename T>
+    struct isPlainUniquePtr : std::false_type {};
+
+    template <typename T>
+    struct isPlainUniquePtr<std::unique_ptr<T>> : std::true_type {};
+
+    template <typename T>
+    struct isStdSharedPtr : std::false_type {};
+
+    template <typename T>
+    struct isStdSharedPtr<std::shared_ptr<T>> : std::true_type {};
+
+    template <typename T>
+    struct isStdVector : std::false_type {};
+
+    template <typename T, typename Allocator>
+    struct isStdVector<std::vector<T, Allocator>> : std::true_type {};
+
+    /**
+     * shared_ptrs we can allocate from a SharedPool. Polymorphic ones
+     * go through cereal's type registry and anything with
+     * load_and_construct builds itself, so those are left to cereal.
+     */
+
+    template <typename Member, typename Archive>
+    constexpr bool isPoolableSharedPtr() {
+      if constexpr (isStdSharedPtr<Member>::value) {
+        using Element = std::remove_const_t<typename Member::element_type>;
+        return !std::is_polymorphic_v<Element>
+          && std::is_default_constructible_v<Element>
+          && !cereal::traits::has_load_and_construct<Element, Archive>::value;
+      } else {
+        return false;
+      }
+    }
+
+    template <typename Member, typename Archive>
+    constexpr bool isPoolableSharedPtrVector() {
+      if constexpr (isStdVector<Member>::value) {
+        return isPoolableSharedPtr<typename Member::value_type, Archive>();
+      } else {
+        return false;
+      }
+    }
+
+    /**
+     * Does what ar(value) does around a load -- name it, open its
+     * node, close it again -- with load() doing the middle part
+     */
+
+    template <typename Archive, typename Value, typename Load>
+    void loadNode(Archive& ar, const char* name, Value& value, Load&& load) {
+      if constexpr (requires { ar.setNextName(name); }) {
+        if (name != nullptr) {
+          ar.setNextName(name);
+        }
+      }
+      cereal::prologue(ar, value);
+      load();
+      cereal::epilogue(ar, value);
+    }
+
+    /**
+     * Loads one member. Strings and vectors already keep their
+     * capacity when cereal loads into them, but cereal's optional and
+     * unique_ptr loads build a brand new value every time, throwing
+     * away whatever the old one had allocated. If there's already a
+     * value there we load into it instead. The layout read is exactly
+     * what cereal's own save wrote.
+     *
+     * shared_ptrs (and vectors of them) get the same treatment when
+     * there's a SharedPool in play, so the new nodes come out of the
+     * pool. Pointers cereal has already seen in this archive are
+     * still shared rather than loaded twice.
+     */
+
+    template <typename Archive, typename Member>
+    void loadMember(Archive& ar, Member& member) {
+      if constexpr (isStdOptional<Member>::value) {
+        loadNode(ar, nullptr, member, [&] {
+          bool nullopt;
+          ar(cereal::make_nvp("nullopt", nullopt));
+          if (nullopt) {
+            member.reset();
+            return;
+          }
+          if (!member) {
+            member.emplace();
+          }
+          ar(cereal::make_nvp("data", *member));
+        });
+      } else if constexpr (isPlainUniquePtr<Member>::value
+                           && !std::is_polymorphic_v<typename Member::element_type>
+                           && std::is_default_constructible_v<typename Member::element_type>
+                           && !cereal::traits::has_load_and_construct<typename Member::element_type, Archive>::value) {
+        using Element = typename Member::element_type;
+        loadNode(ar, nullptr, member, [&] {
+          auto wrapper = cereal::memory_detail::make_ptr_wrapper(member);
+          loadNode(ar, "ptr_wrapper", wrapper, [&] {
+            uint8_t valid;
+            ar(cereal::make_nvp("valid", valid));
+            if (!valid) {
+              member.reset();
+              return;
+            }
+            if (!member) {
+              member = std::make_unique<Element>();
+            }
+            ar(cereal::make_nvp("data", *member));
+          });
+        });
+      } else if constexpr (isPoolableSharedPtr<Member, Archive>()) {
+        const SharedPool* pool = loadSharedPool();
+        if (pool == nullptr) {
+          ar(member);
+          return;
+        }
+        using Element = std::remove_const_t<typename Member::element_type>;
+        loadNode(ar, nullptr, member, [&] {
+          auto wrapper = cereal::memory_detail::make_ptr_wrapper(member);
+          loadNode(ar, "ptr_wrapper", wrapper, [&] {
+            uint32_t id;
+            ar(cereal::make_nvp("id", id));
+            if (id & cereal::detail::msb_32bit) {
+              std::shared_ptr<Element> node = pool->make<Element>();
+              ar.registerSharedPointer(id, node);
+              ar(cereal::make_nvp("data", *node));
+              member = std::move(node);
+            } else {
+              member = std::static_pointer_cast<typename Member::element_type>(ar.getSharedPointer(id));
+            }
+          });
+        });
+      } else if constexpr (isPoolableSharedPtrVector<Member, Archive>()) {
+        if (loadSharedPool() == nullptr) {
+          ar(member);
+          return;
+        }
+        loadNode(ar, nullptr, member, [&] {
+          cereal::size_type size;
+          ar(cereal::make_size_tag(size));
+          member.resize(static_cast<size_t>(size));
+          for (auto& element : member) {
+            loadMember(ar, element);
+          }
+        });
+      } else {
+        ar(member);
+      }
+    }
+
+  }
+
   /**
    * This will save any parents that need to be saved.
    * This should only be called if there ARE any parents.
@@ -249,25 +696,30 @@ namespace fr::autocereal {
   template <typename Archive, typename Class, size_t memberCount, size_t index>
   void saveHelper(Archive &ar, const Class& instance) {
     const auto& classInstance = ClassSingleton<Class>::instance();
-    static_assert(classInstance.memberCount() > 0);
-    static_assert(index < classInstance.memberCount());
 
     if constexpr(index == 0) {
       if constexpr (classInstance.baseCount() > 0) {
         fr::autocereal::saveParents<Archive, Class>(ar, instance);
       }
     }
-    
-    // Get instance ref for index
-    constexpr auto ref_info = fr::autocereal::member_info<Class, index>();
-    // Extract the data from the cass
-    const auto& constRef = fr::autocereal::member_ref_const<Class, ref_info>(instance);
-    ar(cereal::make_nvp(classInstance.memberAtIndex(index), constRef));
 
-    // Recursively unwind until all members are archived
-    if constexpr ((index + 1)  < classInstance.memberCount()) {
-      saveHelper<Archive, Class, classInstance.memberCount(), index + 1>(ar, instance);
-    }    
+    // A class can have no members of its own left to save once the
+    // skip and transient ones are taken out, in which case its
+    // parents are all there is
+    if constexpr (classInstance.memberCount() > 0) {
+      static_assert(index < classInstance.memberCount());
+
+      // Get instance ref for index
+      constexpr auto ref_info = fr::autocereal::member_info<Class, index>();
+      // Extract the data from the cass
+      const auto& constRef = fr::autocereal::member_ref_const<Class, ref_info>(instance);
+      ar(cereal::make_nvp(classInstance.memberAtIndex(index), constRef));
+
+      // Recursively unwind until all members are archived
+      if constexpr ((index + 1)  < classInstance.memberCount()) {
+        saveHelper<Archive, Class, classInstance.memberCount(), index + 1>(ar, instance);
+      }
+    }
   }
 
   /**
@@ -277,25 +729,29 @@ namespace fr::autocereal {
   template <typename Archive, typename Class, size_t memberCount, size_t index>
   void loadHelper(Archive &ar, Class& instance) {
     const auto& classInstance = ClassSingleton<Class>::instance();
-    static_assert(classInstance.memberCount() > 0);
-    static_assert(index < classInstance.memberCount());
 
     if constexpr(index == 0) {
       if constexpr (classInstance.baseCount() > 0) {
         fr::autocereal::loadParents<Archive, Class>(ar, instance);
       }
+      detail::resetTransients(instance);
     }
 
-    constexpr auto ref_info = fr::autocereal::member_info<Class, index>();
-    auto& ref = fr::autocereal::member_ref<Class, ref_info>(instance);
+    if constexpr (classInstance.memberCount() > 0) {
+      static_assert(index < classInstance.memberCount());
 
-    // We don't use cereal::make_nvp here because it can lead to weirdness
-    // As long as the order is the same as the save function, this is fine.
-    
-    ar(ref);
+      constexpr auto ref_info = fr::autocereal::member_info<Class, index>();
+      auto& ref = fr::autocereal::member_ref<Class, ref_info>(instance);
+      detail::rebindToLoadResource(ref);
+
+      // We don't use cereal::make_nvp here because it can lead to weirdness
+      // As long as the order is the same as the save function, this is fine.
 
-    if constexpr ((index + 1) < classInstance.memberCount()) {
-      loadHelper<Archive, Class, classInstance.memberCount(), index + 1>(ar, instance);
+      detail::loadMember(ar, ref);
+
+      if constexpr ((index + 1) < classInstance.memberCount()) {
+        loadHelper<Archive, Class, classInstance.memberCount(), index + 1>(ar, instance);
+      }
     }
   }
 
@@ -342,6 +798,37 @@ namespace fr::autocereal {
     ar(obj);
   }
 
+  /**
+   * from_input_archive with every std::pmr member in obj, however
+   * deeply nested, allocating from resource. Hand it a
+   * monotonic_buffer_resource and the whole object can be thrown away
+   * in one go. Anything that isn't a pmr type (plain std::string,
+   * the nodes behind smart pointers, the archive's own parse state)
+   * still uses the heap.
+   */
+
+  template <typename T, typename ArchiveType>
+  requires IsInputArchive<ArchiveType>
+  void from_input_archive(T& obj, ArchiveType &ar, std::pmr::memory_resource* resource) {
+    detail::LoadResourceScope scope(resource);
+    detail::rebindToLoadResource(obj);
+    ar(obj);
+  }
+
+  /**
+   * from_input_archive with shared_ptr members allocated from pool.
+   * Only the shared_ptrs autocereal loads itself -- members of your
+   * classes and vectors of them -- come out of the pool. One tucked
+   * inside a map or something still goes through cereal.
+   */
+
+  template <typename T, typename ArchiveType>
+  requires IsInputArchive<ArchiveType>
+  void from_input_archive(T& obj, ArchiveType &ar, const SharedPool& pool) {
+    detail::SharedPoolScope scope(pool);
+    ar(obj);
+  }
+
   /**
    * to_json writes json data into an output stream
    */
@@ -364,6 +851,72 @@ namespace fr::autocereal {
     from_input_archive(obj, ar);
   }
 
+  /**
+   * from_json allocating std::pmr members from resource
+   */
+
+  template <typename T, typename Stream>
+  requires IsInputStream<Stream>
+  void from_json(T& obj, Stream& stream, std::pmr::memory_resource* resource) {
+    cereal::JSONInputArchive ar(stream);
+    from_input_archive(obj, ar, resource);
+  }
+
+  /**
+   * from_json allocating shared_ptr members from pool
+   */
+
+  template <typename T, typename Stream>
+  requires IsInputStream<Stream>
+  void from_json(T& obj, Stream& stream, const SharedPool& pool) {
+    cereal::JSONInputArchive ar(stream);
+    from_input_archive(obj, ar, pool);
+  }
+
+  /**
+   * to_binary writes cereal's binary format to a stream
+   */
+
+  template <typename T, typename Stream>
+  requires IsOutputStream<Stream>
+  void to_binary(const T& obj, Stream& stream) {
+    cereal::BinaryOutputArchive ar(stream);
+    to_output_archive(obj, ar);
+  }
+
+  /**
+   * from_binary reads cereal's binary format into an object
+   */
+
+  template <typename T, typename Stream>
+  requires IsInputStream<Stream>
+  void from_binary(T& obj, Stream& stream) {
+    cereal::BinaryInputArchive ar(stream);
+    from_input_archive(obj, ar);
+  }
+
+  /**
+   * from_binary allocating std::pmr members from resource
+   */
+
+  template <typename T, typename Stream>
+  requires IsInputStream<Stream>
+  void from_binary(T& obj, Stream& stream, std::pmr::memory_resource* resource) {
+    cereal::BinaryInputArchive ar(stream);
+    from_input_archive(obj, ar, resource);
+  }
+
+  /**
+   * from_binary allocating shared_ptr members from pool
+   */
+
+  template <typename T, typename Stream>
+  requires IsInputStream<Stream>
+  void from_binary(T& obj, Stream& stream, const SharedPool& pool) {
+    cereal::BinaryInputArchive ar(stream);
+    from_input_archive(obj, ar, pool);
+  }
+
   /**
    * to_xml writes XML data to a stream
    */
@@ -386,33 +939,213 @@ namespace fr::autocereal {
   }
 
   /**
-   * String version of to_json
+   * Biggest buffer a thread hangs on to between calls. Anything that
+   * grew past this gets released afterwards so one giant object
+   * doesn't pin its memory on the thread forever.
+   */
+
+  inline constexpr size_t MAX_POOLED_BUFFER_BYTES = 1024 * 1024;
+
+  namespace detail {
+
+    /**
+     * streambuf that writes into a std::string it doesn't own. Unlike
+     * a stringstream it starts with whatever capacity the string
+     * already has, so writing into a string you've used before doesn't
+     * allocate once it's big enough.
+     */
+
+    class StringBuffer : public std::streambuf {
+    public:
+      explicit StringBuffer(std::string& out) : _out(out) {
+        _out.clear();
+        grow(0);
+      }
+
+      /**
+       * Trims the string down to what was written and returns it
+       */
+
+      std::string& finish() {
+        _out.resize(written());
+        setp(nullptr, nullptr);
+        return _out;
+      }
+
+    protected:
+      int_type overflow(int_type ch) override {
+        if (traits_type::eq_int_type(ch, traits_type::eof())) {
+          return traits_type::not_eof(ch);
+        }
+        grow(1);
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+        return ch;
+      }
+
+      std::streamsize xsputn(const char* data, std::streamsize size) override {
+        size_t count = static_cast<size_t>(size);
+        if (static_cast<size_t>(epptr() - pptr()) < count) {
+          grow(count);
+        }
+        size_t used = written();
+        memcpy(pptr(), data, count);
+        place(used + count);
+        return size;
+      }
+
+    private:
+      std::string& _out;
+
+      size_t written() const {
+        return pbase() ? static_cast<size_t>(pptr() - pbase()) : 0;
+      }
+
+      // Only resizes as far as it needs to, since resize zero fills and
+      // the string may have a lot more capacity than this call will use
+      void grow(size_t extra) {
+        size_t used = written();
+        size_t size = std::max({used + extra, _out.size() * 2, size_t{256}});
+        _out.resize(size);
+        place(used);
+      }
+
+      void place(size_t used) {
+        setp(_out.data(), _out.data() + _out.size());
+        while (used > 0) {
+          int step = static_cast<int>(std::min<size_t>(used, std::numeric_limits<int>::max()));
+          pbump(step);
+          used -= step;
+        }
+      }
+    };
+
+    /**
+     * Runs write with an ostream that fills out, reusing out's capacity
+     */
+
+    template <typename Write>
+    void writeToString(std::string& out, Write&& write) {
+      StringBuffer buffer(out);
+      std::ostream stream(&buffer);
+      write(stream);
+      buffer.finish();
+    }
+
+    /**
+     * Each thread keeps one output buffer around for the string
+     * versions of to_json and to_xml. busy covers an object whose save
+     * calls to_json itself; the inner call just gets a buffer of its
+     * own.
+     */
+
+    struct PooledBuffer {
+      std::string buffer;
+      bool busy = false;
+    };
+
+    inline PooledBuffer& pooledBuffer() {
+      thread_local PooledBuffer pooled;
+      return pooled;
+    }
+
+    template <typename Write>
+    std::string writeToPooledString(Write&& write) {
+      PooledBuffer& pooled = pooledBuffer();
+      if (pooled.busy) {
+        std::string out;
+        writeToString(out, write);
+        return out;
+      }
+
+      struct Release {
+        PooledBuffer& pooled;
+        ~Release() {
+          pooled.busy = false;
+          if (pooled.buffer.capacity() > MAX_POOLED_BUFFER_BYTES) {
+            std::string().swap(pooled.buffer);
+          }
+        }
+      };
+
+      pooled.busy = true;
+      Release release{pooled};
+      writeToString(pooled.buffer, write);
+      return pooled.buffer;
+    }
+
+  }
+
+  /**
+   * String version of to_json. The text is built in this thread's
+   * pooled buffer, so in steady state the only output sized
+   * allocation is the returned string. cereal's archive still
+   * allocates a little of its own every call.
    */
   template <typename T>
   std::string to_json(const T& obj) {
-    std::stringstream stream;
-    to_json(obj, stream);
-    return stream.str();
+    return detail::writeToPooledString([&](std::ostream& stream) { to_json(obj, stream); });
   }
 
   /**
-   * String version of from_json
+   * to_json into a string you hang on to. out is overwritten, and
+   * once it's grown big enough for your objects this doesn't allocate
+   * any buffer memory at all. The archive's bookkeeping still does.
    */
+
   template <typename T>
-  void from_json(T& obj, std::string json) {
-    std::stringstream stream(json);
+  void to_json(const T& obj, std::string& out) {
+    detail::writeToString(out, [&](std::ostream& stream) { to_json(obj, stream); });
+  }
+
+  /**
+   * String version of from_json. The archive reads the string where
+   * it is rather than from a copy in a stringstream.
+   */
+  template <typename T>
+  void from_json(T& obj, std::string_view json) {
+    std::ispanstream stream(std::span<const char>(json.data(), json.size()));
     from_json(obj, stream);
   }
 
   /**
-   * String version of to_xml
+   * String version of from_json allocating std::pmr members from
+   * resource
+   */
+
+  template <typename T>
+  void from_json(T& obj, std::string_view json, std::pmr::memory_resource* resource) {
+    std::ispanstream stream(std::span<const char>(json.data(), json.size()));
+    from_json(obj, stream, resource);
+  }
+
+  /**
+   * String version of from_json allocating shared_ptr members from
+   * pool
+   */
+
+  template <typename T>
+  void from_json(T& obj, std::string_view json, const SharedPool& pool) {
+    std::ispanstream stream(std::span<const char>(json.data(), json.size()));
+    from_json(obj, stream, pool);
+  }
+
+  /**
+   * String version of to_xml, using the same pooled buffer as to_json
    */
 
   template <typename T>
   std::string to_xml(const T& obj) {
-    std::stringstream stream;
-    to_xml(obj, stream);
-    return stream.str();
+    return detail::writeToPooledString([&](std::ostream& stream) { to_xml(obj, stream); });
+  }
+
+  /**
+   * to_xml into a string you hang on to, like to_json above
+   */
+
+  template <typename T>
+  void to_xml(const T& obj, std::string& out) {
+    detail::writeToString(out, [&](std::ostream& stream) { to_xml(obj, stream); });
   }
 
   /**
@@ -420,15 +1153,60 @@ namespace fr::autocereal {
    */
 
   template <typename T>
-  void from_xml(T& obj, std::string xml) {
-    std::stringstream stream(xml);
+  void from_xml(T& obj, std::string_view xml) {
+    std::ispanstream stream(std::span<const char>(xml.data(), xml.size()));
     from_xml(obj, stream);
   }
   
 }
 
+#if defined(AUTOCEREAL_INTERPRETED_BINARY)
+
+/**
+ * Binary archives go through the op-list interpreter in interpreter.h
+ * instead of saveHelper and loadHelper. That gets included at the
+ * bottom of this file.
+ */
+
+namespace fr::autocereal::detail::interp {
+
+  template <typename Class>
+  void saveObject(cereal::BinaryOutputArchive& ar, const Class& instance);
+
+  template <typename Class>
+  void loadObject(cereal::BinaryInputArchive& ar, Class& instance);
+
+}
+
+#endif
+
 namespace cereal {
 
+  /**
+   * cereal's JSON archive only knows how to write and read a plain
+   * std::string, so strings with any other allocator (std::pmr::string,
+   * mostly) go through a per-thread std::string on the way. The XML
+   * archive's string handling already takes any allocator.
+   */
+
+  template <typename Alloc>
+  requires (!std::same_as<Alloc, std::allocator<char>>)
+  void save(JSONOutputArchive& ar, const std::basic_string<char, std::char_traits<char>, Alloc>& str) {
+    thread_local std::string scratch;
+    scratch.assign(str.data(), str.size());
+    ar.saveValue(scratch);
+  }
+
+  template <typename Alloc>
+  requires (!std::same_as<Alloc, std::allocator<char>>)
+  void load(JSONInputArchive& ar, std::basic_string<char, std::char_traits<char>, Alloc>& str) {
+    thread_local std::string scratch;
+    ar.loadValue(scratch);
+    // assign keeps str's allocator, which the load has already pointed
+    // at the right resource
+    str.assign(scratch.data(), scratch.size());
+  }
+
   /**
    * Implements a save function that can be used for any class
    * Note that if you have private members you want to load or save
@@ -439,8 +1217,15 @@ namespace cereal {
 
   template <typename Archive, typename Class>
   void save(Archive &ar, const Class& instance) {
-    const auto& classInstance = fr::autocereal::ClassSingleton<Class>::instance();
-    fr::autocereal::saveHelper<Archive, Class, classInstance.memberCount()>(ar, instance);
+#if defined(AUTOCEREAL_INTERPRETED_BINARY)
+    if constexpr (std::same_as<Archive, cereal::BinaryOutputArchive>) {
+      fr::autocereal::detail::interp::saveObject(ar, instance);
+    } else
+#endif
+    {
+      const auto& classInstance = fr::autocereal::ClassSingleton<Class>::instance();
+      fr::autocereal::saveHelper<Archive, Class, classInstance.memberCount()>(ar, instance);
+    }
   }
 
   /**
@@ -449,8 +1234,19 @@ namespace cereal {
 
   template <typename Archive, typename Class>
   void load(Archive &ar, Class &instance) {
-    const auto& classInstance = fr::autocereal::ClassSingleton<Class>::instance();
-    fr::autocereal::loadHelper<Archive, Class, classInstance.memberCount()>(ar, instance);
+#if defined(AUTOCEREAL_INTERPRETED_BINARY)
+    if constexpr (std::same_as<Archive, cereal::BinaryInputArchive>) {
+      fr::autocereal::detail::interp::loadObject(ar, instance);
+    } else
+#endif
+    {
+      const auto& classInstance = fr::autocereal::ClassSingleton<Class>::instance();
+      fr::autocereal::loadHelper<Archive, Class, classInstance.memberCount()>(ar, instance);
+    }
   }
   
 }
+
+#if defined(AUTOCEREAL_INTERPRETED_BINARY)
+#include <fr/autocereal/interpreter.h>
+#endif
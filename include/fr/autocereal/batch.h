@@ -0,0 +1,151 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * Batches of small objects through one cereal archive.
+ *
+ * Calling to_json or to_binary once per message means building an
+ * archive, and for JSON a rapidjson writer, for every one of them,
+ * and for a small struct that costs more than writing the struct
+ * does. The batch versions build one archive and one stream for the
+ * whole span and write the objects through it back to back.
+ *
+ * The output is exactly what cereal writes for a std::vector of the
+ * same objects, so a batch written here can be read back with plain
+ * from_json/from_binary into a vector and the other way round. You
+ * just don't have to copy your objects into a vector to get there.
+ * Loading reads into a vector you hand in and reuses what's already in
+ * it, so pulling batch after batch into the same vector doesn't keep
+ * reallocating it.
+ */
+
+#include <fr/autocereal/autocereal.h>
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fr::autocereal {
+
+  namespace detail::batch {
+
+    template <typename Archive, typename T>
+    void saveItems(Archive& ar, std::span<const T> items) {
+      ar(cereal::make_size_tag(static_cast<cereal::size_type>(items.size())));
+      for (const T& item : items) {
+        ar(item);
+      }
+    }
+
+    template <typename Archive, typename T>
+    void loadItems(Archive& ar, std::vector<T>& items) {
+      cereal::size_type size;
+      ar(cereal::make_size_tag(size));
+      items.resize(static_cast<size_t>(size));
+      for (T& item : items) {
+        ar(item);
+      }
+    }
+
+  }
+
+  /**
+   * Writes items as one binary archive
+   */
+
+  template <typename T, typename Stream>
+  requires IsOutputStream<Stream>
+  void to_binary_batch(std::span<const T> items, Stream& stream) {
+    cereal::BinaryOutputArchive ar(stream);
+    detail::batch::saveItems(ar, items);
+  }
+
+  template <typename T, typename Stream>
+  requires IsOutputStream<Stream>
+  void to_binary_batch(const std::vector<T>& items, Stream& stream) {
+    to_binary_batch(std::span<const T>(items), stream);
+  }
+
+  /**
+   * Reads a binary batch into items, replacing what was there
+   */
+
+  template <typename T, typename Stream>
+  requires IsInputStream<Stream>
+  void from_binary_batch(std::vector<T>& items, Stream& stream) {
+    cereal::BinaryInputArchive ar(stream);
+    detail::batch::loadItems(ar, items);
+  }
+
+  /**
+   * Writes items as one JSON document, {"value0": [ ... ]}
+   */
+
+  template <typename T, typename Stream>
+  requires IsOutputStream<Stream>
+  void to_json_batch(std::span<const T> items, Stream& stream) {
+    cereal::JSONOutputArchive ar(stream);
+    // The node cereal would open for a vector; it names itself value0
+    ar.startNode();
+    detail::batch::saveItems(ar, items);
+    ar.finishNode();
+  }
+
+  template <typename T, typename Stream>
+  requires IsOutputStream<Stream>
+  void to_json_batch(const std::vector<T>& items, Stream& stream) {
+    to_json_batch(std::span<const T>(items), stream);
+  }
+
+  /**
+   * Reads a JSON batch into items, replacing what was there
+   */
+
+  template <typename T, typename Stream>
+  requires IsInputStream<Stream>
+  void from_json_batch(std::vector<T>& items, Stream& stream) {
+    cereal::JSONInputArchive ar(stream);
+    ar.startNode();
+    detail::batch::loadItems(ar, items);
+    ar.finishNode();
+  }
+
+  /**
+   * String versions of the JSON batch functions. These use the same
+   * per-thread buffer as the string version of to_json.
+   */
+
+  template <typename T>
+  std::string to_json_batch(std::span<const T> items) {
+    return detail::writeToPooledString([&](std::ostream& stream) { to_json_batch(items, stream); });
+  }
+
+  template <typename T>
+  std::string to_json_batch(const std::vector<T>& items) {
+    return to_json_batch(std::span<const T>(items));
+  }
+
+  template <typename T>
+  void from_json_batch(std::vector<T>& items, std::string_view json) {
+    std::ispanstream stream(std::span<const char>(json.data(), json.size()));
+    from_json_batch(items, stream);
+  }
+
+}
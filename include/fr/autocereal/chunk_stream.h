@@ -0,0 +1,490 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * Serializing an object a chunk at a time, so an event loop can send
+ * each chunk as soon as it exists and get on with something else in
+ * between:
+ *
+ *   for (auto chunk : fr::autocereal::serialize_chunks(big, ChunkFormat::Binary)) {
+ *     socket.send(chunk);
+ *     loop.poll();
+ *   }
+ *
+ * serialize_chunks is a std::generator. It walks the members the same
+ * way saveHelper does, with one archive that stays alive across
+ * suspensions, so the bytes are exactly what to_binary or to_json
+ * would have written. It suspends whenever the buffer fills up to
+ * chunkSize, between members and between the elements of vector
+ * members, so one huge vector doesn't have to be written in one go.
+ * A single element (or a non-vector member) still gets written all
+ * at once, so a chunk can't be cut any finer than that. Every chunk
+ * but the last is exactly chunkSize bytes. The span is only good
+ * until the generator resumes, and obj has to outlive the generator.
+ *
+ * chunk_loader is the other end. feed it chunks as they arrive, of
+ * any size, and it fills the object in as it goes. JSON goes through
+ * json_stream_reader. Binary decodes one member or vector element at
+ * a time from what's been fed so far; if an element isn't all there
+ * yet, it winds back and tries again once enough more has turned up.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/json_stream.h>
+#include <fr/autocereal/traits.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <generator>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace fr::autocereal {
+
+  enum class ChunkFormat {
+    Binary,
+    Json
+  };
+
+  /**
+   * Default chunk size
+   */
+
+  inline constexpr size_t CHUNK_STREAM_BYTES = 64 * 1024;
+
+  namespace detail::chunks {
+
+    /**
+     * Output buffer the generator hands out slices of
+     */
+
+    class ChunkBuffer : public std::streambuf {
+    public:
+      explicit ChunkBuffer(size_t capacity) : _bytes(std::max<size_t>(capacity, 256)) {
+        place(0);
+      }
+
+      size_t size() const {
+        return static_cast<size_t>(pptr() - pbase());
+      }
+
+      const char* data() const {
+        return pbase();
+      }
+
+      /**
+       * Throws away the first count bytes, which have been handed out
+       */
+
+      void drop(size_t count) {
+        size_t left = size() - count;
+        memmove(_bytes.data(), _bytes.data() + count, left);
+        place(left);
+      }
+
+    protected:
+      int_type overflow(int_type ch) override {
+        if (traits_type::eq_int_type(ch, traits_type::eof())) {
+          return traits_type::not_eof(ch);
+        }
+        grow(1);
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+        return ch;
+      }
+
+      std::streamsize xsputn(const char* data, std::streamsize size) override {
+        size_t count = static_cast<size_t>(size);
+        if (static_cast<size_t>(epptr() - pptr()) < count) {
+          grow(count);
+        }
+        size_t used = this->size();
+        memcpy(pptr(), data, count);
+        place(used + count);
+        return size;
+      }
+
+    private:
+      std::vector<char> _bytes;
+
+      void grow(size_t extra) {
+        size_t used = size();
+        _bytes.resize(std::max(used + extra, _bytes.size() * 2));
+        place(used);
+      }
+
+      void place(size_t used) {
+        setp(_bytes.data(), _bytes.data() + _bytes.size());
+        while (used > 0) {
+          int step = static_cast<int>(std::min<size_t>(used, std::numeric_limits<int>::max()));
+          pbump(step);
+          used -= step;
+        }
+      }
+    };
+
+    /**
+     * Input buffer for the binary loader. Fed bytes pile up at the
+     * end, and decoding an element that runs off the end marks the
+     * buffer starved so the loader knows to wait rather than fail.
+     */
+
+    class FeedBuffer : public std::streambuf {
+    public:
+      void append(std::span<const char> chunk) {
+        size_t position = offset();
+        // Everything before the read position has been decoded
+        _bytes.erase(0, position);
+        _bytes.append(chunk.data(), chunk.size());
+        place(0);
+      }
+
+      size_t offset() const {
+        return eback() ? static_cast<size_t>(gptr() - eback()) : 0;
+      }
+
+      size_t available() const {
+        return _bytes.size() - offset();
+      }
+
+      void rewind(size_t position) {
+        place(position);
+        _starved = false;
+      }
+
+      bool starved() const {
+        return _starved;
+      }
+
+    protected:
+      int_type underflow() override {
+        _starved = true;
+        return traits_type::eof();
+      }
+
+    private:
+      std::string _bytes;
+      bool _starved = false;
+
+      void place(size_t position) {
+        setg(_bytes.data(), _bytes.data() + position, _bytes.data() + _bytes.size());
+      }
+    };
+
+    /**
+     * Vectors get written and read an element at a time. vector<bool>
+     * is packed differently by cereal so it goes in one piece like
+     * everything else.
+     */
+
+    template <typename V>
+    concept IsSteppedVector = IsVector<V> && !std::same_as<typename V::value_type, bool>;
+
+    /**
+     * Writes member index of Owner, or as much of it as fits before
+     * the buffer reaches chunkSize. cursor is how many elements have
+     * gone out so far. Returns true once the member's all written.
+     */
+
+    template <typename Archive, typename T, typename Owner, size_t index>
+    bool saveStep(Archive& ar, const T& obj, size_t& cursor, const ChunkBuffer& buffer, size_t chunkSize) {
+      constexpr auto info = member_info<Owner, index>();
+      const auto& member = member_ref_const<Owner, info>(obj);
+      using Member = std::remove_cvref_t<decltype(member)>;
+
+      const std::string& name = ClassSingleton<Owner>::instance().memberAtIndex(index);
+
+      if constexpr (IsSteppedVector<Member>) {
+        // Same sequence cereal's own vector save goes through, named
+        // the way saveHelper's make_nvp would have named it
+        if (cursor == 0) {
+          if constexpr (requires { ar.setNextName(name.c_str()); }) {
+            ar.setNextName(name.c_str());
+          }
+          cereal::prologue(ar, member);
+          ar(cereal::make_size_tag(static_cast<cereal::size_type>(member.size())));
+        }
+        while (cursor < member.size()) {
+          ar(member[cursor++]);
+          if (buffer.size() >= chunkSize && cursor < member.size()) {
+            return false;
+          }
+        }
+        cereal::epilogue(ar, member);
+      } else {
+        ar(cereal::make_nvp(name, member));
+      }
+      return true;
+    }
+
+    /**
+     * Decodes one piece of member index of Owner: the size of a
+     * vector, one of its elements, or a whole member that isn't a
+     * vector. cursor only moves once the piece has loaded, so a piece
+     * that runs out of input can be retried. Returns true once the
+     * member's all read.
+     */
+
+    template <typename T, typename Owner, size_t index>
+    bool loadStep(cereal::BinaryInputArchive& ar, T& obj, size_t& cursor) {
+      constexpr auto info = member_info<Owner, index>();
+      auto& member = member_ref<Owner, info>(obj);
+      using Member = std::remove_cvref_t<decltype(member)>;
+
+      if constexpr (IsSteppedVector<Member>) {
+        if (cursor == 0) {
+          cereal::size_type size;
+          ar(cereal::make_size_tag(size));
+          member.resize(static_cast<size_t>(size));
+        } else {
+          ar(member[cursor - 1]);
+        }
+        ++cursor;
+        return cursor > member.size();
+      } else {
+        ar(member);
+        return true;
+      }
+    }
+
+    /**
+     * Step functions in forEachMember order, built once per type
+     */
+
+    template <typename Archive, typename T>
+    class SaveSteps {
+    public:
+      using Step = bool (*)(Archive&, const T&, size_t&, const ChunkBuffer&, size_t);
+
+      static const std::vector<Step>& instance() {
+        static const std::vector<Step> steps = build();
+        return steps;
+      }
+
+    private:
+      static std::vector<Step> build() {
+        std::vector<Step> steps;
+        forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+          steps.push_back(&saveStep<Archive, T, Owner, index>);
+        });
+        return steps;
+      }
+    };
+
+    template <typename T>
+    class LoadSteps {
+    public:
+      using Step = bool (*)(cereal::BinaryInputArchive&, T&, size_t&);
+
+      static const std::vector<Step>& instance() {
+        static const std::vector<Step> steps = build();
+        return steps;
+      }
+
+    private:
+      static std::vector<Step> build() {
+        std::vector<Step> steps;
+        forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+          steps.push_back(&loadStep<T, Owner, index>);
+        });
+        return steps;
+      }
+    };
+
+    template <typename Archive, typename T>
+    std::generator<std::span<const std::byte>> saveChunks(const T& obj, size_t chunkSize) {
+      ChunkBuffer buffer(chunkSize);
+      std::ostream stream(&buffer);
+
+      {
+        Archive ar(stream);
+        // The prologue and epilogue are what ar(obj) wraps around the
+        // members, so the output matches it byte for byte
+        cereal::prologue(ar, obj);
+        for (auto step : SaveSteps<Archive, T>::instance()) {
+          size_t cursor = 0;
+          bool finished = false;
+          while (!finished) {
+            finished = step(ar, obj, cursor, buffer, chunkSize);
+            size_t sent = 0;
+            while (buffer.size() - sent >= chunkSize) {
+              co_yield std::as_bytes(std::span<const char>(buffer.data() + sent, chunkSize));
+              sent += chunkSize;
+            }
+            buffer.drop(sent);
+          }
+        }
+        cereal::epilogue(ar, obj);
+        // The JSON archive closes the document when it goes away
+      }
+
+      size_t sent = 0;
+      while (buffer.size() - sent > 0) {
+        size_t size = std::min(chunkSize, buffer.size() - sent);
+        co_yield std::as_bytes(std::span<const char>(buffer.data() + sent, size));
+        sent += size;
+      }
+    }
+
+    /**
+     * Resumable binary decoding for chunk_loader
+     */
+
+    template <typename T>
+    class BinaryChunkLoader {
+      T& _obj;
+      FeedBuffer _buffer;
+      std::istream _stream{&_buffer};
+      cereal::BinaryInputArchive _ar{_stream};
+      size_t _member = 0;
+      size_t _cursor = 0;
+      // After running short, don't bother trying again until there's
+      // twice as much to go on. Keeps an element that spans a lot of
+      // chunks from being decoded over and over.
+      size_t _retryAt = 0;
+
+      void pump(bool last) {
+        const auto& steps = LoadSteps<T>::instance();
+        while (_member < steps.size()) {
+          if (!last && _buffer.available() < _retryAt) {
+            return;
+          }
+          size_t mark = _buffer.offset();
+          _buffer.rewind(mark);
+          try {
+            if (steps[_member](_ar, _obj, _cursor)) {
+              ++_member;
+              _cursor = 0;
+            }
+            _retryAt = 0;
+          } catch (const cereal::Exception&) {
+            if (!_buffer.starved()) {
+              throw;
+            }
+            _buffer.rewind(mark);
+            if (last) {
+              throw cereal::Exception("Chunked binary input is truncated");
+            }
+            _retryAt = std::max<size_t>(_buffer.available(), 1) * 2;
+            return;
+          }
+        }
+      }
+
+    public:
+      explicit BinaryChunkLoader(T& obj) : _obj(obj) {
+        resetAllTransients(_obj);
+      }
+
+      BinaryChunkLoader(const BinaryChunkLoader&) = delete;
+      BinaryChunkLoader& operator=(const BinaryChunkLoader&) = delete;
+
+      void feed(std::span<const char> chunk) {
+        _buffer.append(chunk);
+        pump(false);
+      }
+
+      bool done() const {
+        return _member == LoadSteps<T>::instance().size();
+      }
+
+      void finish() {
+        pump(true);
+        if (_buffer.available() > 0) {
+          throw cereal::Exception("Chunked binary input has bytes left over");
+        }
+      }
+    };
+
+  }
+
+  /**
+   * Serializes obj a chunk at a time. See the top of the file.
+   */
+
+  template <typename T>
+  std::generator<std::span<const std::byte>> serialize_chunks(const T& obj, ChunkFormat format = ChunkFormat::Binary,
+                                                              size_t chunkSize = CHUNK_STREAM_BYTES) {
+    chunkSize = std::max<size_t>(chunkSize, 1);
+    if (format == ChunkFormat::Json) {
+      return detail::chunks::saveChunks<cereal::JSONOutputArchive>(obj, chunkSize);
+    }
+    return detail::chunks::saveChunks<cereal::BinaryOutputArchive>(obj, chunkSize);
+  }
+
+  /**
+   * Loads what serialize_chunks (or to_binary / to_json) wrote, fed
+   * in whatever pieces it arrives in
+   */
+
+  template <typename T>
+  class chunk_loader {
+    std::optional<detail::chunks::BinaryChunkLoader<T>> _binary;
+    std::optional<json_stream_reader<T>> _json;
+
+  public:
+    explicit chunk_loader(T& obj, ChunkFormat format = ChunkFormat::Binary) {
+      if (format == ChunkFormat::Json) {
+        _json.emplace(obj);
+      } else {
+        _binary.emplace(obj);
+      }
+    }
+
+    chunk_loader(const chunk_loader&) = delete;
+    chunk_loader& operator=(const chunk_loader&) = delete;
+
+    void feed(std::span<const std::byte> chunk) {
+      std::span<const char> chars(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+      if (_json) {
+        _json->feed(chars);
+      } else {
+        _binary->feed(chars);
+      }
+    }
+
+    /**
+     * True once the whole object has been read
+     */
+
+    bool done() const {
+      return _json ? _json->done() : _binary->done();
+    }
+
+    /**
+     * Throws if the object isn't complete, or if there was more
+     * input than the object used
+     */
+
+    void finish() {
+      if (_json) {
+        _json->finish();
+      } else {
+        _binary->finish();
+      }
+    }
+  };
+
+}
@@ -0,0 +1,288 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * Chunked binary container for big collections, so saving and
+ * loading them can use more than one core.
+ *
+ * to_chunked_binary splits the range into chunks of chunkSize
+ * elements. Each chunk gets its own cereal::BinaryOutputArchive on its
+ * own thread, and the chunks are written out one after another in
+ * order. A footer at the end records where each chunk starts, how big
+ * it is and how many elements it holds:
+ *
+ *   chunk 0 | chunk 1 | ... | footer
+ *
+ *   footer: { offset, size, count } per chunk, then chunk count,
+ *           element count and the "ACCHUNK1" magic. Everything is a
+ *           little endian uint64, offsets are from the start of the
+ *           container.
+ *
+ * from_chunked_binary reads the footer, sizes the vector once and
+ * decodes the chunks in parallel, each straight into its own slice of
+ * the vector. Reading the bytes off the stream is still one chunk at
+ * a time (it's one stream), but that's the cheap part.
+ *
+ * Since each chunk is its own archive, cereal's shared pointer
+ * tracking only works within a chunk. Two elements in different
+ * chunks that share a pointer load with separate copies.
+ *
+ * The container has to be the last thing in the stream on the way
+ * in, since the reader finds the footer from the end. The stream also
+ * has to be seekable.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/parallel.h>
+#include <fr/autocereal/serialized_size.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <ranges>
+#include <span>
+#include <spanstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fr::autocereal {
+
+  /**
+   * Default number of elements per chunk
+   */
+
+  inline constexpr size_t CHUNKED_BINARY_ELEMENTS = 16 * 1024;
+
+  namespace detail {
+
+    /**
+     * Little endian helpers for the footers here and in indexed.h
+     */
+
+    inline void putU64(std::string& out, uint64_t value) {
+      for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>(value >> (8 * i)));
+      }
+    }
+
+    inline uint64_t getU64(const char* in) {
+      uint64_t value = 0;
+      for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+      }
+      return value;
+    }
+
+    inline void readExactly(std::istream& stream, char* out, size_t size) {
+      stream.read(out, static_cast<std::streamsize>(size));
+      if (static_cast<size_t>(stream.gcount()) != size) {
+        throw cereal::Exception("Binary data is truncated");
+      }
+    }
+
+  }
+
+  namespace detail::chunked {
+
+    inline constexpr std::string_view MAGIC = "ACCHUNK1";
+
+    // Chunk count, element count and the magic
+    inline constexpr size_t TRAILER_BYTES = 24;
+
+    struct ChunkEntry {
+      uint64_t offset;
+      uint64_t size;
+      uint64_t count;
+    };
+
+    /**
+     * Reads and checks the footer. Leaves the stream wherever.
+     * minElementBytes is the least one element can take up, which can
+     * be zero.
+     */
+
+    inline std::vector<ChunkEntry> readFooter(std::istream& stream, std::streamoff start, uint64_t& total,
+                                              uint64_t minElementBytes) {
+      stream.seekg(0, std::ios::end);
+      std::streamoff end = stream.tellg();
+      if (!stream || end - start < static_cast<std::streamoff>(TRAILER_BYTES)) {
+        throw cereal::Exception("Not a chunked binary container");
+      }
+      uint64_t length = static_cast<uint64_t>(end - start);
+
+      std::array<char, TRAILER_BYTES> trailer;
+      stream.seekg(end - static_cast<std::streamoff>(TRAILER_BYTES));
+      readExactly(stream, trailer.data(), trailer.size());
+      if (std::string_view(trailer.data() + 16, 8) != MAGIC) {
+        throw cereal::Exception("Not a chunked binary container");
+      }
+      uint64_t chunkCount = getU64(trailer.data());
+      total = getU64(trailer.data() + 8);
+      if (chunkCount > (length - TRAILER_BYTES) / 24) {
+        throw cereal::Exception("Chunked binary footer is corrupt");
+      }
+
+      uint64_t indexBytes = chunkCount * 24;
+      uint64_t dataEnd = length - TRAILER_BYTES - indexBytes;
+      std::string index(indexBytes, '\0');
+      stream.seekg(start + static_cast<std::streamoff>(dataEnd));
+      readExactly(stream, index.data(), index.size());
+
+      std::vector<ChunkEntry> chunks(chunkCount);
+      uint64_t counted = 0;
+      uint64_t bytes = 0;
+      for (size_t i = 0; i < chunkCount; ++i) {
+        const char* entry = index.data() + i * 24;
+        chunks[i] = {getU64(entry), getU64(entry + 8), getU64(entry + 16)};
+        if (chunks[i].offset > dataEnd || chunks[i].size > dataEnd - chunks[i].offset) {
+          throw cereal::Exception("Chunked binary footer points outside the data");
+        }
+        counted += chunks[i].count;
+        bytes += chunks[i].size;
+      }
+      // Elements that take up bytes can't outnumber them, which stops
+      // a corrupt count from asking for a ridiculous resize. Elements
+      // that can write nothing at all (empty structs, or records with
+      // nothing but skip and transient members) leave empty chunks, so
+      // there's nothing to check their count against.
+      if (counted != total || (minElementBytes > 0 && total > bytes / minElementBytes)) {
+        throw cereal::Exception("Chunked binary footer is corrupt");
+      }
+      return chunks;
+    }
+
+  }
+
+  /**
+   * Writes items as a chunked binary container. Chunks are built
+   * threads at a time, so there are never more than threads chunks'
+   * worth of serialized data in memory.
+   */
+
+  template <typename Range>
+  requires std::ranges::random_access_range<const Range> && std::ranges::sized_range<const Range>
+  void to_chunked_binary(const Range& items, std::ostream& stream, size_t chunkSize = CHUNKED_BINARY_ELEMENTS,
+                         size_t threads = defaultThreadCount()) {
+    chunkSize = std::max<size_t>(chunkSize, 1);
+    threads = std::max<size_t>(threads, 1);
+    size_t total = std::ranges::size(items);
+    size_t chunkCount = (total + chunkSize - 1) / chunkSize;
+    auto begin = std::ranges::begin(items);
+
+    std::vector<detail::chunked::ChunkEntry> entries;
+    entries.reserve(chunkCount);
+    uint64_t offset = 0;
+    std::vector<std::string> wave;
+
+    for (size_t first = 0; first < chunkCount; first += threads) {
+      size_t waveSize = std::min(threads, chunkCount - first);
+      wave.resize(waveSize);
+      parallelFor(waveSize, threads, [&](size_t w) {
+        size_t chunk = first + w;
+        size_t from = chunk * chunkSize;
+        size_t to = std::min(total, from + chunkSize);
+        std::ostringstream out;
+        {
+          cereal::BinaryOutputArchive ar(out);
+          for (size_t i = from; i < to; ++i) {
+            ar(begin[i]);
+          }
+        }
+        wave[w] = std::move(out).str();
+      });
+
+      for (size_t w = 0; w < waveSize; ++w) {
+        size_t from = (first + w) * chunkSize;
+        size_t count = std::min(total, from + chunkSize) - from;
+        stream.write(wave[w].data(), static_cast<std::streamsize>(wave[w].size()));
+        entries.push_back({offset, wave[w].size(), count});
+        offset += wave[w].size();
+        wave[w].clear();
+      }
+    }
+
+    std::string footer;
+    footer.reserve(entries.size() * 24 + detail::chunked::TRAILER_BYTES);
+    for (const auto& entry : entries) {
+      detail::putU64(footer, entry.offset);
+      detail::putU64(footer, entry.size);
+      detail::putU64(footer, entry.count);
+    }
+    detail::putU64(footer, entries.size());
+    detail::putU64(footer, total);
+    footer.append(detail::chunked::MAGIC);
+    stream.write(footer.data(), static_cast<std::streamsize>(footer.size()));
+    if (!stream) {
+      throw cereal::Exception("Failed writing chunked binary container");
+    }
+  }
+
+  /**
+   * Reads a chunked binary container, starting at the stream's
+   * current position, into items. Whatever was in items is replaced.
+   */
+
+  template <typename T>
+  void from_chunked_binary(std::vector<T>& items, std::istream& stream, size_t threads = defaultThreadCount()) {
+    std::streamoff start = stream.tellg();
+    if (start < 0) {
+      throw cereal::Exception("Chunked binary needs a seekable stream");
+    }
+    uint64_t total = 0;
+    auto chunks = detail::chunked::readFooter(stream, start, total, detail::size::minimumBytes<T>());
+
+    std::vector<size_t> firstElement(chunks.size());
+    size_t next = 0;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      firstElement[i] = next;
+      next += chunks[i].count;
+    }
+
+    items.clear();
+    items.resize(total);
+    std::mutex streamMutex;
+
+    parallelFor(chunks.size(), threads, [&](size_t c) {
+      const auto& chunk = chunks[c];
+      std::string bytes(chunk.size, '\0');
+      {
+        std::lock_guard lock(streamMutex);
+        stream.seekg(start + static_cast<std::streamoff>(chunk.offset));
+        detail::readExactly(stream, bytes.data(), bytes.size());
+      }
+
+      std::ispanstream in(std::span<const char>(bytes.data(), bytes.size()));
+      {
+        cereal::BinaryInputArchive ar(in);
+        for (size_t i = 0; i < chunk.count; ++i) {
+          ar(items[firstElement[c] + i]);
+        }
+      }
+      if (in.tellg() != static_cast<std::streamoff>(chunk.size)) {
+        throw cereal::Exception("Chunked binary chunk has bytes left over");
+      }
+    });
+  }
+
+}
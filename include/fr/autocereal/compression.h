@@ -0,0 +1,564 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * Streaming zstd/lz4 compression for archives.
+ *
+ * CompressedOutputStream and DecompressedInputStream are plain
+ * std::ostream/std::istream wrappers around another stream, so any
+ * cereal archive (or to_json, to_binary and friends) can sit on top
+ * of them. Data gets compressed in blockSize chunks as the archive
+ * writes, straight into the underlying stream, without building the
+ * whole uncompressed archive in memory first.
+ *
+ * Decompression works out the codec from the magic number of the
+ * first frame, so you don't need to tell it what you used. Several
+ * frames back to back (say, from appending to a file) are fine as long
+ * as they all use the same codec.
+ *
+ * Each codec is only there if the build found its library -- CMake
+ * defines AUTOCEREAL_HAS_ZSTD and AUTOCEREAL_HAS_LZ4 for you. Asking
+ * for a codec that isn't compiled in throws.
+ */
+
+#include <fr/autocereal/autocereal.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#if defined(AUTOCEREAL_HAS_ZSTD)
+#include <zstd.h>
+#endif
+
+#if defined(AUTOCEREAL_HAS_LZ4)
+#include <lz4frame.h>
+#endif
+
+namespace fr::autocereal {
+
+  enum class Codec {
+    Zstd,
+    Lz4
+  };
+
+  /**
+   * Compression settings. level is the codec's own level scale.
+   * workers only matters for zstd, and only if your libzstd was built
+   * with multithreading -- otherwise it quietly compresses on the
+   * calling thread.
+   */
+
+  struct Compression {
+    Codec codec = Codec::Zstd;
+    int level = 3;
+    size_t blockSize = 1 << 20;
+    unsigned workers = 0;
+  };
+
+  namespace detail::compression {
+
+    inline void write(std::ostream& sink, const void* data, size_t size) {
+      sink.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+      if (!sink) {
+        throw cereal::Exception("Failed writing compressed data");
+      }
+    }
+
+    /**
+     * Codec specific halves. These only see whole blocks, so the
+     * virtual calls don't matter.
+     */
+
+    class Encoder {
+    public:
+      virtual ~Encoder() = default;
+      virtual void compress(const char* data, size_t size, std::ostream& sink) = 0;
+      virtual void finish(std::ostream& sink) = 0;
+    };
+
+    class Decoder {
+    protected:
+      std::vector<char> _input;
+      size_t _inputPos = 0;
+      size_t _inputSize = 0;
+
+      // Returns false when the source has nothing left
+      bool refill(std::istream& source) {
+        if (_inputPos < _inputSize) {
+          return true;
+        }
+        source.read(_input.data(), static_cast<std::streamsize>(_input.size()));
+        _inputPos = 0;
+        _inputSize = static_cast<size_t>(source.gcount());
+        return _inputSize > 0;
+      }
+
+    public:
+      Decoder(size_t inputSize, std::span<const char> prefix) : _input(std::max(inputSize, prefix.size())) {
+        std::copy(prefix.begin(), prefix.end(), _input.begin());
+        _inputSize = prefix.size();
+      }
+
+      virtual ~Decoder() = default;
+
+      // Returns the number of bytes produced, 0 at the end of the data
+      virtual size_t decompress(std::istream& source, char* out, size_t capacity) = 0;
+    };
+
+#if defined(AUTOCEREAL_HAS_ZSTD)
+
+    inline constexpr uint32_t ZSTD_FRAME_MAGIC = 0xFD2FB528;
+
+    inline void checkZstd(size_t result) {
+      if (ZSTD_isError(result)) {
+        throw cereal::Exception(std::string("zstd: ") + ZSTD_getErrorName(result));
+      }
+    }
+
+    class ZstdEncoder : public Encoder {
+      ZSTD_CCtx* _context;
+      std::vector<char> _output;
+
+      void run(const char* data, size_t size, ZSTD_EndDirective mode, std::ostream& sink) {
+        ZSTD_inBuffer in{data, size, 0};
+        bool done = false;
+        while (!done) {
+          ZSTD_outBuffer out{_output.data(), _output.size(), 0};
+          size_t remaining = ZSTD_compressStream2(_context, &out, &in, mode);
+          checkZstd(remaining);
+          write(sink, _output.data(), out.pos);
+          done = mode == ZSTD_e_end ? remaining == 0 : in.pos == in.size;
+        }
+      }
+
+    public:
+      explicit ZstdEncoder(const Compression& options)
+        : _context(ZSTD_createCCtx()), _output(ZSTD_CStreamOutSize()) {
+        if (_context == nullptr) {
+          throw cereal::Exception("zstd: could not create compression context");
+        }
+        checkZstd(ZSTD_CCtx_setParameter(_context, ZSTD_c_compressionLevel, options.level));
+        checkZstd(ZSTD_CCtx_setParameter(_context, ZSTD_c_checksumFlag, 1));
+        if (options.workers > 0) {
+          // Fails on single threaded builds of libzstd, which is fine
+          ZSTD_CCtx_setParameter(_context, ZSTD_c_nbWorkers, static_cast<int>(options.workers));
+        }
+      }
+
+      ~ZstdEncoder() override {
+        ZSTD_freeCCtx(_context);
+      }
+
+      void compress(const char* data, size_t size, std::ostream& sink) override {
+        run(data, size, ZSTD_e_continue, sink);
+      }
+
+      void finish(std::ostream& sink) override {
+        run(nullptr, 0, ZSTD_e_end, sink);
+      }
+    };
+
+    class ZstdDecoder : public Decoder {
+      ZSTD_DCtx* _context;
+      // Non-zero while we're part way through a frame
+      size_t _pending = 0;
+
+    public:
+      explicit ZstdDecoder(std::span<const char> prefix)
+        : Decoder(ZSTD_DStreamInSize(), prefix), _context(ZSTD_createDCtx()) {
+        if (_context == nullptr) {
+          throw cereal::Exception("zstd: could not create decompression context");
+        }
+      }
+
+      ~ZstdDecoder() override {
+        ZSTD_freeDCtx(_context);
+      }
+
+      size_t decompress(std::istream& source, char* out, size_t capacity) override {
+        ZSTD_outBuffer output{out, capacity, 0};
+        while (output.pos == 0) {
+          // Even with no input left zstd may still be holding output
+          // back from the last call, so give it one more go
+          bool haveInput = refill(source);
+          if (!haveInput && _pending == 0) {
+            return 0;
+          }
+          ZSTD_inBuffer input{_input.data(), _inputSize, _inputPos};
+          _pending = ZSTD_decompressStream(_context, &output, &input);
+          checkZstd(_pending);
+          _inputPos = input.pos;
+          if (!haveInput && output.pos == 0) {
+            throw cereal::Exception("zstd: truncated frame");
+          }
+        }
+        return output.pos;
+      }
+    };
+
+#endif
+
+#if defined(AUTOCEREAL_HAS_LZ4)
+
+    inline constexpr uint32_t LZ4_FRAME_MAGIC = 0x184D2204;
+
+    inline size_t checkLz4(size_t result) {
+      if (LZ4F_isError(result)) {
+        throw cereal::Exception(std::string("lz4: ") + LZ4F_getErrorName(result));
+      }
+      return result;
+    }
+
+    class Lz4Encoder : public Encoder {
+      LZ4F_cctx* _context = nullptr;
+      LZ4F_preferences_t _preferences{};
+      std::vector<char> _output;
+      size_t _blockSize;
+      bool _started = false;
+
+      void start(std::ostream& sink) {
+        if (!_started) {
+          size_t written = checkLz4(LZ4F_compressBegin(_context, _output.data(), _output.size(), &_preferences));
+          write(sink, _output.data(), written);
+          _started = true;
+        }
+      }
+
+    public:
+      explicit Lz4Encoder(const Compression& options) : _blockSize(options.blockSize) {
+        checkLz4(LZ4F_createCompressionContext(&_context, LZ4F_VERSION));
+        _preferences.compressionLevel = options.level;
+        _preferences.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+        _preferences.frameInfo.blockSizeID =
+          options.blockSize <= 64 * 1024 ? LZ4F_max64KB :
+          options.blockSize <= 256 * 1024 ? LZ4F_max256KB :
+          options.blockSize <= 1024 * 1024 ? LZ4F_max1MB : LZ4F_max4MB;
+        _output.resize(std::max<size_t>(LZ4F_compressBound(_blockSize, &_preferences), LZ4F_HEADER_SIZE_MAX));
+      }
+
+      ~Lz4Encoder() override {
+        LZ4F_freeCompressionContext(_context);
+      }
+
+      void compress(const char* data, size_t size, std::ostream& sink) override {
+        start(sink);
+        while (size > 0) {
+          size_t chunk = std::min(size, _blockSize);
+          size_t written = checkLz4(LZ4F_compressUpdate(_context, _output.data(), _output.size(), data, chunk, nullptr));
+          write(sink, _output.data(), written);
+          data += chunk;
+          size -= chunk;
+        }
+      }
+
+      void finish(std::ostream& sink) override {
+        start(sink);
+        size_t written = checkLz4(LZ4F_compressEnd(_context, _output.data(), _output.size(), nullptr));
+        write(sink, _output.data(), written);
+      }
+    };
+
+    class Lz4Decoder : public Decoder {
+      LZ4F_dctx* _context = nullptr;
+      // LZ4F_decompress returns 0 once a frame is complete
+      size_t _pending = 0;
+
+    public:
+      explicit Lz4Decoder(std::span<const char> prefix) : Decoder(64 * 1024, prefix) {
+        checkLz4(LZ4F_createDecompressionContext(&_context, LZ4F_VERSION));
+      }
+
+      ~Lz4Decoder() override {
+        LZ4F_freeDecompressionContext(_context);
+      }
+
+      size_t decompress(std::istream& source, char* out, size_t capacity) override {
+        size_t produced = 0;
+        while (produced == 0) {
+          bool haveInput = refill(source);
+          if (!haveInput && _pending == 0) {
+            return 0;
+          }
+          size_t outSize = capacity;
+          size_t inSize = _inputSize - _inputPos;
+          _pending = checkLz4(LZ4F_decompress(_context, out, &outSize, _input.data() + _inputPos, &inSize, nullptr));
+          _inputPos += inSize;
+          produced = outSize;
+          if (!haveInput && produced == 0) {
+            throw cereal::Exception("lz4: truncated frame");
+          }
+        }
+        return produced;
+      }
+    };
+
+#endif
+
+    inline std::unique_ptr<Encoder> makeEncoder(const Compression& options) {
+      switch (options.codec) {
+      case Codec::Zstd:
+#if defined(AUTOCEREAL_HAS_ZSTD)
+        return std::make_unique<ZstdEncoder>(options);
+#else
+        throw cereal::Exception("autocereal was built without zstd support");
+#endif
+      case Codec::Lz4:
+#if defined(AUTOCEREAL_HAS_LZ4)
+        return std::make_unique<Lz4Encoder>(options);
+#else
+        throw cereal::Exception("autocereal was built without lz4 support");
+#endif
+      }
+      throw cereal::Exception("Unknown compression codec");
+    }
+
+    /**
+     * Picks a decoder from the first four bytes of the data. Returns
+     * nullptr for empty input.
+     */
+
+    inline std::unique_ptr<Decoder> makeDecoder(std::istream& source) {
+      std::array<char, 4> magicBytes;
+      source.read(magicBytes.data(), magicBytes.size());
+      auto got = static_cast<size_t>(source.gcount());
+      if (got == 0) {
+        return nullptr;
+      }
+      if (got < magicBytes.size()) {
+        throw cereal::Exception("Compressed data is too short to have a frame header");
+      }
+      uint32_t magic;
+      std::memcpy(&magic, magicBytes.data(), sizeof(magic));
+      std::span<const char> prefix(magicBytes.data(), got);
+
+#if defined(AUTOCEREAL_HAS_ZSTD)
+      if (magic == ZSTD_FRAME_MAGIC) {
+        return std::make_unique<ZstdDecoder>(prefix);
+      }
+#endif
+#if defined(AUTOCEREAL_HAS_LZ4)
+      if (magic == LZ4_FRAME_MAGIC) {
+        return std::make_unique<Lz4Decoder>(prefix);
+      }
+#endif
+      throw cereal::Exception("Unrecognized (or not compiled in) compression format");
+    }
+
+  }
+
+  /**
+   * Output side. Whatever gets written here is compressed in
+   * blockSize chunks and passed on to the stream underneath. The frame
+   * is finished when you call finish() or when this is destroyed.
+   */
+
+  class CompressingStreamBuf : public std::streambuf {
+    std::ostream& _sink;
+    std::unique_ptr<detail::compression::Encoder> _encoder;
+    std::vector<char> _buffer;
+    bool _finished = false;
+
+    void compressBuffer() {
+      if (pptr() > pbase()) {
+        _encoder->compress(pbase(), static_cast<size_t>(pptr() - pbase()), _sink);
+      }
+      setp(_buffer.data(), _buffer.data() + _buffer.size());
+    }
+
+  protected:
+    int_type overflow(int_type ch) override {
+      if (_finished) {
+        return traits_type::eof();
+      }
+      compressBuffer();
+      if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+      }
+      return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize count) override {
+      std::streamsize written = 0;
+      while (written < count) {
+        if (pptr() == epptr() && traits_type::eq_int_type(overflow(traits_type::eof()), traits_type::eof())) {
+          break;
+        }
+        auto chunk = std::min<std::streamsize>(count - written, epptr() - pptr());
+        std::memcpy(pptr(), data + written, static_cast<size_t>(chunk));
+        pbump(static_cast<int>(chunk));
+        written += chunk;
+      }
+      return written;
+    }
+
+    int sync() override {
+      if (!_finished) {
+        compressBuffer();
+      }
+      _sink.flush();
+      return 0;
+    }
+
+  public:
+    CompressingStreamBuf(std::ostream& sink, const Compression& options)
+      : _sink(sink),
+        _encoder(detail::compression::makeEncoder(options)),
+        _buffer(std::max<size_t>(options.blockSize, 4096)) {
+      setp(_buffer.data(), _buffer.data() + _buffer.size());
+    }
+
+    void finish() {
+      if (!_finished) {
+        compressBuffer();
+        _encoder->finish(_sink);
+        _finished = true;
+        _sink.flush();
+      }
+    }
+  };
+
+  class CompressedOutputStream : public std::ostream {
+    CompressingStreamBuf _buffer;
+
+  public:
+    CompressedOutputStream(std::ostream& sink, const Compression& options = {})
+      : std::ostream(nullptr), _buffer(sink, options) {
+      rdbuf(&_buffer);
+    }
+
+    ~CompressedOutputStream() override {
+      // Destructors can't throw, call finish() yourself if you want
+      // to hear about errors
+      try {
+        _buffer.finish();
+      } catch (...) {
+      }
+    }
+
+    void finish() {
+      flush();
+      _buffer.finish();
+    }
+  };
+
+  /**
+   * Input side. Pulls compressed data from the stream underneath as
+   * it's needed and hands out the decompressed bytes.
+   */
+
+  class DecompressingStreamBuf : public std::streambuf {
+    std::istream& _source;
+    std::unique_ptr<detail::compression::Decoder> _decoder;
+    std::vector<char> _buffer;
+    bool _started = false;
+
+  protected:
+    int_type underflow() override {
+      if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+      }
+      if (!_started) {
+        _decoder = detail::compression::makeDecoder(_source);
+        _started = true;
+      }
+      if (!_decoder) {
+        return traits_type::eof();
+      }
+      size_t produced = _decoder->decompress(_source, _buffer.data(), _buffer.size());
+      if (produced == 0) {
+        return traits_type::eof();
+      }
+      setg(_buffer.data(), _buffer.data(), _buffer.data() + produced);
+      return traits_type::to_int_type(*gptr());
+    }
+
+  public:
+    explicit DecompressingStreamBuf(std::istream& source, size_t bufferSize = 1 << 20)
+      : _source(source), _buffer(std::max<size_t>(bufferSize, 4096)) {
+      setg(_buffer.data(), _buffer.data(), _buffer.data());
+    }
+  };
+
+  class DecompressedInputStream : public std::istream {
+    DecompressingStreamBuf _buffer;
+
+  public:
+    explicit DecompressedInputStream(std::istream& source, size_t bufferSize = 1 << 20)
+      : std::istream(nullptr), _buffer(source, bufferSize) {
+      rdbuf(&_buffer);
+    }
+  };
+
+  /**
+   * Writes obj through an ArchiveType sitting on a compressed stream.
+   * The archive is closed before the frame gets finished, so anything
+   * it writes in its destructor ends up in the frame too.
+   */
+
+  template <typename ArchiveType, typename T, typename Stream>
+  requires IsOutputArchive<ArchiveType> && IsOutputStream<Stream>
+  void to_compressed(const T& obj, Stream& stream, const Compression& compression = {}) {
+    CompressedOutputStream compressed(stream, compression);
+    {
+      ArchiveType ar(compressed);
+      to_output_archive(obj, ar);
+    }
+    compressed.finish();
+  }
+
+  /**
+   * Reads obj through an ArchiveType, decompressing as it goes
+   */
+
+  template <typename ArchiveType, typename T, typename Stream>
+  requires IsInputArchive<ArchiveType> && IsInputStream<Stream>
+  void from_compressed(T& obj, Stream& stream) {
+    DecompressedInputStream decompressed(stream);
+    ArchiveType ar(decompressed);
+    from_input_archive(obj, ar);
+  }
+
+  /**
+   * Compressed versions of to_json and to_binary. The matching loads
+   * are from_compressed<cereal::JSONInputArchive> and
+   * from_compressed<cereal::BinaryInputArchive>.
+   */
+
+  template <typename T, typename Stream>
+  requires IsOutputStream<Stream>
+  void to_json(const T& obj, Stream& stream, const Compression& compression) {
+    to_compressed<cereal::JSONOutputArchive>(obj, stream, compression);
+  }
+
+  template <typename T, typename Stream>
+  requires IsOutputStream<Stream>
+  void to_binary(const T& obj, Stream& stream, const Compression& compression) {
+    to_compressed<cereal::BinaryOutputArchive>(obj, stream, compression);
+  }
+
+}
@@ -0,0 +1,461 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * CSV export/import for spans of flat reflected structs.
+ *
+ * The header row is the (flattened) member names. Members can be
+ * bool, numbers, enums (written as their underlying integer),
+ * std::string, or std::optional of any of those. An empty unquoted
+ * field reads back as an empty optional, and empty strings always get
+ * written as "" so the two don't get mixed up, and so a one column
+ * row holding an empty string isn't a blank line.
+ *
+ * Quoting follows RFC 4180, strictly: a quote anywhere but at the
+ * start of a field (or doubled inside a quoted one) throws a
+ * cereal::Exception, the same on one thread as on several. Numbers
+ * go through std::to_chars and std::from_chars, so they round trip
+ * exactly and don't care what locale you're in.
+ *
+ * Big inputs get parsed in parallel. The input is cut into chunks,
+ * each chunk counts its quote characters, and a running parity over
+ * those counts tells each chunk whether it starts inside a quoted
+ * field. From there each chunk can find its first real record
+ * boundary on its own and parse from there.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/parallel.h>
+#include <fr/autocereal/traits.h>
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace fr::autocereal {
+
+  /**
+   * Inputs smaller than this per thread aren't worth splitting up
+   */
+
+  inline constexpr size_t CSV_MIN_CHUNK_BYTES = 1 << 20;
+
+  namespace detail::csv {
+
+    inline bool isSpecial(char c) {
+      return c == ',' || c == '"' || c == '\n' || c == '\r';
+    }
+
+    /**
+     * Finds the first comma, quote, CR or LF in [p, end). Sixteen
+     * bytes at a time where SSE2 is available.
+     */
+
+    inline const char* findSpecial(const char* p, const char* end) {
+#if defined(__SSE2__)
+      const __m128i comma = _mm_set1_epi8(',');
+      const __m128i quote = _mm_set1_epi8('"');
+      const __m128i lf = _mm_set1_epi8('\n');
+      const __m128i cr = _mm_set1_epi8('\r');
+      while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, comma), _mm_cmpeq_epi8(chunk, quote)),
+                                    _mm_or_si128(_mm_cmpeq_epi8(chunk, lf), _mm_cmpeq_epi8(chunk, cr)));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+        if (mask != 0) {
+          return p + std::countr_zero(mask);
+        }
+        p += 16;
+      }
+#endif
+      while (p < end && !isSpecial(*p)) {
+        ++p;
+      }
+      return p;
+    }
+
+    inline size_t countQuotes(const char* p, const char* end) {
+      size_t count = 0;
+#if defined(__SSE2__)
+      const __m128i quote = _mm_set1_epi8('"');
+      while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        count += std::popcount(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote))));
+        p += 16;
+      }
+#endif
+      for (; p < end; ++p) {
+        count += (*p == '"');
+      }
+      return count;
+    }
+
+    inline void appendString(std::string& out, std::string_view value) {
+      const char* end = value.data() + value.size();
+      if (!value.empty() && findSpecial(value.data(), end) == end) {
+        out.append(value);
+        return;
+      }
+      out.push_back('"');
+      for (char c : value) {
+        if (c == '"') {
+          out.push_back('"');
+        }
+        out.push_back(c);
+      }
+      out.push_back('"');
+    }
+
+    template <typename Value>
+    void appendValue(std::string& out, const Value& value) {
+      if constexpr (IsOptional<Value>) {
+        if (value.has_value()) {
+          appendValue(out, *value);
+        }
+      } else if constexpr (std::same_as<Value, bool>) {
+        out.append(value ? "true" : "false");
+      } else if constexpr (std::is_enum_v<Value>) {
+        appendValue(out, std::to_underlying(value));
+      } else if constexpr (std::is_arithmetic_v<Value>) {
+        char buffer[64];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+      } else if constexpr (IsString<Value>) {
+        appendString(out, value);
+      } else {
+        static_assert(false, "CSV only handles bool, numbers, enums and std::string members (optionally wrapped in std::optional)");
+      }
+    }
+
+    template <typename Value>
+    bool parseValue(Value& value, std::string_view field, bool quoted) {
+      if constexpr (IsOptional<Value>) {
+        if (field.empty() && !quoted) {
+          value.reset();
+          return true;
+        }
+        if (!value.has_value()) {
+          value.emplace();
+        }
+        return parseValue(*value, field, quoted);
+      } else if constexpr (std::same_as<Value, bool>) {
+        if (field == "true" || field == "1") {
+          value = true;
+        } else if (field == "false" || field == "0") {
+          value = false;
+        } else {
+          return false;
+        }
+        return true;
+      } else if constexpr (std::is_enum_v<Value>) {
+        std::underlying_type_t<Value> underlying{};
+        if (!parseValue(underlying, field, quoted)) {
+          return false;
+        }
+        value = static_cast<Value>(underlying);
+        return true;
+      } else if constexpr (std::is_arithmetic_v<Value>) {
+        const char* end = field.data() + field.size();
+        auto result = std::from_chars(field.data(), end, value);
+        return result.ec == std::errc{} && result.ptr == end;
+      } else if constexpr (IsString<Value>) {
+        value.assign(field);
+        return true;
+      } else {
+        static_assert(false, "CSV only handles bool, numbers, enums and std::string members (optionally wrapped in std::optional)");
+      }
+    }
+
+    /**
+     * Parses one field starting at p and returns the position just
+     * past it. scratch holds the unescaped text for quoted fields
+     * that had doubled quotes in them.
+     */
+
+    inline const char* parseField(const char* p, const char* end, std::string_view& field, bool& quoted, std::string& scratch) {
+      if (p < end && *p == '"') {
+        quoted = true;
+        const char* start = ++p;
+        bool escaped = false;
+        while (true) {
+          const char* q = static_cast<const char*>(std::memchr(p, '"', end - p));
+          if (q == nullptr) {
+            throw cereal::Exception("Unterminated quoted CSV field");
+          }
+          if (q + 1 < end && q[1] == '"') {
+            escaped = true;
+            p = q + 2;
+            continue;
+          }
+          if (escaped) {
+            scratch.clear();
+            for (const char* c = start; c < q; ++c) {
+              scratch.push_back(*c);
+              if (*c == '"') {
+                ++c;
+              }
+            }
+            field = scratch;
+          } else {
+            field = std::string_view(start, q - start);
+          }
+          return q + 1;
+        }
+      }
+
+      quoted = false;
+      const char* stop = findSpecial(p, end);
+      // The parallel split counts on every quote opening or closing a
+      // quoted field, so one in the middle of an unquoted field can't
+      // just be let through as a character
+      if (stop < end && *stop == '"') {
+        throw cereal::Exception("Stray quote in unquoted CSV field");
+      }
+      field = std::string_view(p, stop - p);
+      return stop;
+    }
+
+    /**
+     * Calls onField(column, field, quoted) for every field of the
+     * record starting at p. Returns the start of the next record.
+     */
+
+    template <typename OnField>
+    const char* parseRecord(const char* p, const char* end, std::string& scratch, OnField&& onField) {
+      size_t column = 0;
+      while (true) {
+        std::string_view field;
+        bool quoted = false;
+        p = parseField(p, end, field, quoted, scratch);
+        onField(column++, field, quoted);
+        if (p == end) {
+          return p;
+        }
+        if (*p == ',') {
+          ++p;
+          continue;
+        }
+        if (*p == '\r') {
+          ++p;
+          return (p < end && *p == '\n') ? p + 1 : p;
+        }
+        if (*p == '\n') {
+          return p + 1;
+        }
+        throw cereal::Exception("Unexpected character after quoted CSV field");
+      }
+    }
+
+    template <typename T>
+    using Setter = void (*)(T&, std::string_view, bool);
+
+    /**
+     * Parses every record in [p, end) onto the end of rows. Blank lines
+     * are skipped, unless there's only the one column, in which case a
+     * blank line is a row with an empty optional in it.
+     */
+
+    template <typename T>
+    void parseRecords(const char* p, const char* end, const std::vector<Setter<T>>& setters, std::vector<T>& rows) {
+      std::string scratch;
+      const bool skipBlank = setters.size() > 1;
+      while (p < end) {
+        if (skipBlank && (*p == '\n' || *p == '\r')) {
+          ++p;
+          continue;
+        }
+        T& row = rows.emplace_back();
+        p = parseRecord(p, end, scratch, [&](size_t column, std::string_view field, bool quoted) {
+          if (column < setters.size() && setters[column] != nullptr) {
+            setters[column](row, field, quoted);
+          }
+        });
+      }
+    }
+
+  }
+
+  /**
+   * to_csv writes a header row and then one row per element of rows
+   */
+
+  template <typename T, typename Stream>
+  requires IsOutputStream<Stream>
+  void to_csv(std::span<const T> rows, Stream& stream) {
+    using namespace detail::csv;
+    std::string buffer;
+    buffer.reserve(CSV_MIN_CHUNK_BYTES + 4096);
+
+    bool first = true;
+    forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+      if (!first) {
+        buffer.push_back(',');
+      }
+      first = false;
+      appendString(buffer, ClassSingleton<Owner>::instance().memberAtIndex(index));
+    });
+    buffer.push_back('\n');
+
+    for (const T& row : rows) {
+      first = true;
+      forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+        constexpr auto info = member_info<Owner, index>();
+        if (!first) {
+          buffer.push_back(',');
+        }
+        first = false;
+        appendValue(buffer, member_ref_const<Owner, info>(row));
+      });
+      buffer.push_back('\n');
+
+      if (buffer.size() >= CSV_MIN_CHUNK_BYTES) {
+        stream.write(buffer.data(), buffer.size());
+        buffer.clear();
+      }
+    }
+    stream.write(buffer.data(), buffer.size());
+  }
+
+  template <typename T, typename Stream>
+  requires IsOutputStream<Stream>
+  void to_csv(const std::vector<T>& rows, Stream& stream) {
+    to_csv(std::span<const T>(rows), stream);
+  }
+
+  /**
+   * String version of to_csv
+   */
+
+  template <typename T>
+  std::string to_csv(std::span<const T> rows) {
+    std::stringstream stream;
+    to_csv(rows, stream);
+    return stream.str();
+  }
+
+  template <typename T>
+  std::string to_csv(const std::vector<T>& rows) {
+    return to_csv(std::span<const T>(rows));
+  }
+
+  /**
+   * from_csv appends the rows in csv to rows. Columns are matched to
+   * members by header name. Columns with no matching member are
+   * skipped, and members with no column are left default constructed.
+   */
+
+  template <typename T>
+  void from_csv(std::vector<T>& rows, std::string_view csv, size_t threads = defaultThreadCount()) {
+    using namespace detail::csv;
+    const char* p = csv.data();
+    const char* end = p + csv.size();
+    std::string scratch;
+
+    std::vector<Setter<T>> setters;
+    p = parseRecord(p, end, scratch, [&](size_t, std::string_view name, bool) {
+      Setter<T> setter = nullptr;
+      forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+        if (setter == nullptr && ClassSingleton<Owner>::instance().memberAtIndex(index) == name) {
+          setter = [](T& row, std::string_view field, bool quoted) {
+            constexpr auto info = member_info<Owner, index>();
+            if (!parseValue(member_ref<Owner, info>(row), field, quoted)) {
+              throw cereal::Exception("Bad CSV value \"" + std::string(field) + "\" for column "
+                                      + ClassSingleton<Owner>::instance().memberAtIndex(index));
+            }
+          };
+        }
+      });
+      setters.push_back(setter);
+    });
+
+    const size_t bodySize = end - p;
+    const size_t chunks = std::max<size_t>(1, std::min(threads, bodySize / CSV_MIN_CHUNK_BYTES));
+    if (chunks == 1) {
+      parseRecords(p, end, setters, rows);
+      return;
+    }
+
+    // Quote parity at each chunk's start tells us whether the chunk
+    // starts in the middle of a quoted field
+    std::vector<const char*> bounds(chunks + 1);
+    for (size_t i = 0; i < chunks; ++i) {
+      bounds[i] = p + bodySize * i / chunks;
+    }
+    bounds[chunks] = end;
+
+    std::vector<size_t> quotes(chunks);
+    parallelFor(chunks, threads, [&](size_t i) {
+      quotes[i] = countQuotes(bounds[i], bounds[i + 1]);
+    });
+
+    // Move each boundary forward to the start of the next record
+    std::vector<const char*> starts(chunks + 1);
+    starts[0] = p;
+    starts[chunks] = end;
+    bool inQuotes = false;
+    for (size_t i = 1; i < chunks; ++i) {
+      inQuotes ^= (quotes[i - 1] & 1) != 0;
+      const char* scan = bounds[i];
+      bool quoted = inQuotes;
+      while (scan < end && (quoted || *scan != '\n')) {
+        quoted ^= (*scan == '"');
+        ++scan;
+      }
+      starts[i] = std::max(starts[i - 1], scan < end ? scan + 1 : end);
+    }
+
+    std::vector<std::vector<T>> parsed(chunks);
+    parallelFor(chunks, threads, [&](size_t i) {
+      parseRecords(starts[i], starts[i + 1], setters, parsed[i]);
+    });
+
+    size_t total = rows.size();
+    for (const auto& chunk : parsed) {
+      total += chunk.size();
+    }
+    rows.reserve(total);
+    for (auto& chunk : parsed) {
+      std::move(chunk.begin(), chunk.end(), std::back_inserter(rows));
+    }
+  }
+
+  /**
+   * Stream version of from_csv. Reads the whole stream first so the
+   * parse can be split across threads.
+   */
+
+  template <typename T, typename Stream>
+  requires IsInputStream<Stream>
+  void from_csv(std::vector<T>& rows, Stream& stream, size_t threads = defaultThreadCount()) {
+    std::string data = detail::readAll(stream);
+    from_csv(rows, std::string_view(data), threads);
+  }
+
+}
@@ -0,0 +1,254 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * A 64 bit fingerprint of a type's schema, worked out at compile time.
+ *
+ * Binary loads are positional. loadHelper reads the first member, then
+ * the second, and so on, and if the struct that wrote the data had its
+ * members in a different order, or one more of them, or an int where
+ * you've now got a double, it'll cheerfully read garbage into your
+ * object. The fingerprint hashes everything that decides the binary
+ * layout -- member names, their types, their order, and the bases
+ * they came from -- so two builds that agree on the fingerprint agree
+ * on the layout.
+ *
+ * to_checked_binary writes the fingerprint ahead of the object and
+ * from_checked_binary compares it before loading anything. If they
+ * match, the load is a plain from_binary with no checking at all. If
+ * they don't, you get a SchemaMismatch up front rather than a
+ * half-loaded object. save_fingerprint and check_fingerprint do the
+ * same thing for any archive, if you've got your own header to put
+ * it in.
+ *
+ * The hash is FNV-1a over a description of the type. Records are
+ * described by their bases and members, not their own name, so
+ * renaming a struct doesn't change its fingerprint. That goes for
+ * classes with constructors and private members too, since autocereal
+ * writes those member by member as well. Scalars are described by
+ * their kind and size rather than their name, so int32_t and a 32 bit
+ * int match. Enums hash as their underlying type. Types cereal
+ * serializes itself (maps, anything with its own serialize, save or
+ * load) hash their name as the compiler prints it, which is stable
+ * for a given compiler but isn't promised to be between compilers.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/traits.h>
+
+#include <cstdint>
+#include <format>
+#include <meta>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace fr::autocereal {
+
+  namespace detail::fingerprint {
+
+    inline constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+    inline constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    constexpr uint64_t mix(uint64_t hash, std::string_view text) {
+      for (char c : text) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= FNV_PRIME;
+      }
+      return hash;
+    }
+
+    constexpr uint64_t mix(uint64_t hash, uint64_t value) {
+      for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= FNV_PRIME;
+      }
+      return hash;
+    }
+
+    template <typename T>
+    consteval uint64_t typeHash(uint64_t hash, std::vector<std::meta::info>& visiting);
+
+    template <typename Class, size_t index = 0>
+    consteval uint64_t baseHash(uint64_t hash, std::vector<std::meta::info>& visiting) {
+      if constexpr (index < ClassSingleton<Class>::baseCount()) {
+        using Parent = typename ClassSingleton<Class>::template Parent<index>::Type;
+        hash = mix(hash, "base(");
+        hash = typeHash<Parent>(hash, visiting);
+        hash = mix(hash, ")");
+        return baseHash<Class, index + 1>(hash, visiting);
+      } else {
+        return hash;
+      }
+    }
+
+    template <typename Class, size_t index = 0>
+    consteval uint64_t memberHash(uint64_t hash, std::vector<std::meta::info>& visiting) {
+      if constexpr (index < ClassSingleton<Class>::memberCount()) {
+        hash = mix(hash, std::meta::identifier_of(member_info<Class, index>()));
+        hash = mix(hash, ":");
+        hash = typeHash<member_type_t<Class, index>>(hash, visiting);
+        hash = mix(hash, ";");
+        return memberHash<Class, index + 1>(hash, visiting);
+      } else {
+        return hash;
+      }
+    }
+
+    /**
+     * Adds T's description to hash. visiting holds the records we're
+     * in the middle of, so a type that points back at itself (a tree
+     * node with shared_ptr children, say) hashes as a reference to
+     * the enclosing record instead of recursing forever.
+     */
+
+    template <typename T>
+    consteval uint64_t typeHash(uint64_t hash, std::vector<std::meta::info>& visiting) {
+      if constexpr (std::is_same_v<T, bool>) {
+        return mix(hash, "bool");
+      } else if constexpr (std::is_enum_v<T>) {
+        hash = mix(hash, "enum:");
+        return typeHash<std::underlying_type_t<T>>(hash, visiting);
+      } else if constexpr (std::is_floating_point_v<T>) {
+        return mix(mix(hash, "float"), sizeof(T));
+      } else if constexpr (std::is_integral_v<T>) {
+        return mix(mix(hash, std::is_signed_v<T> ? "int" : "uint"), sizeof(T));
+      } else if constexpr (IsString<T>) {
+        return mix(hash, "string");
+      } else if constexpr (IsVector<T>) {
+        hash = mix(hash, "vector<");
+        return mix(typeHash<typename T::value_type>(hash, visiting), ">");
+      } else if constexpr (IsStdArray<T>) {
+        hash = mix(mix(hash, "array"), std::tuple_size_v<T>);
+        hash = mix(hash, "<");
+        return mix(typeHash<typename T::value_type>(hash, visiting), ">");
+      } else if constexpr (IsOptional<T>) {
+        hash = mix(hash, "optional<");
+        return mix(typeHash<typename T::value_type>(hash, visiting), ">");
+      } else if constexpr (IsUniquePtr<T>) {
+        hash = mix(hash, "unique<");
+        return mix(typeHash<std::remove_const_t<typename T::element_type>>(hash, visiting), ">");
+      } else if constexpr (IsSharedPtr<T>) {
+        hash = mix(hash, "shared<");
+        return mix(typeHash<std::remove_const_t<typename T::element_type>>(hash, visiting), ">");
+      } else if constexpr (IsLazy<T>) {
+        // Written as a size and then T on its own, which isn't T's layout
+        hash = mix(hash, "lazy<");
+        return mix(typeHash<typename T::value_type>(hash, visiting), ">");
+      } else if constexpr (IsReflectedRecord<T>) {
+        for (size_t depth = 0; depth < visiting.size(); ++depth) {
+          if (visiting[depth] == ^^T) {
+            return mix(mix(hash, "enclosing"), visiting.size() - depth);
+          }
+        }
+        visiting.push_back(^^T);
+        hash = mix(hash, "{");
+        hash = baseHash<T>(hash, visiting);
+        hash = memberHash<T>(hash, visiting);
+        hash = mix(hash, "}");
+        visiting.pop_back();
+        return hash;
+      } else {
+        return mix(hash, std::meta::display_string_of(^^T));
+      }
+    }
+
+  }
+
+  /**
+   * T's schema fingerprint
+   */
+
+  template <typename T>
+  consteval uint64_t schema_fingerprint() {
+    std::vector<std::meta::info> visiting;
+    return detail::fingerprint::typeHash<T>(detail::fingerprint::FNV_OFFSET, visiting);
+  }
+
+  /**
+   * Thrown when the fingerprint in the data isn't the one the type
+   * you're loading into has
+   */
+
+  class SchemaMismatch : public cereal::Exception {
+  public:
+    uint64_t expected;
+    uint64_t found;
+
+    SchemaMismatch(std::string_view typeName, uint64_t expected, uint64_t found)
+      : cereal::Exception(std::format("Schema mismatch loading {}: expected fingerprint {:016x}, found {:016x}",
+                                      typeName, expected, found)),
+        expected(expected),
+        found(found) {}
+  };
+
+  /**
+   * Writes T's fingerprint to ar
+   */
+
+  template <typename T, typename Archive>
+  requires IsOutputArchive<Archive>
+  void save_fingerprint(Archive& ar) {
+    constexpr uint64_t fingerprint = schema_fingerprint<T>();
+    ar(cereal::make_nvp("fingerprint", fingerprint));
+  }
+
+  /**
+   * Reads a fingerprint from ar and throws SchemaMismatch if it isn't
+   * T's
+   */
+
+  template <typename T, typename Archive>
+  requires IsInputArchive<Archive>
+  void check_fingerprint(Archive& ar) {
+    constexpr uint64_t expected = schema_fingerprint<T>();
+    uint64_t found;
+    ar(cereal::make_nvp("fingerprint", found));
+    if (found != expected) {
+      constexpr std::string_view name = std::meta::display_string_of(^^T);
+      throw SchemaMismatch(name, expected, found);
+    }
+  }
+
+  /**
+   * to_binary with the fingerprint in front
+   */
+
+  template <typename T, typename Stream>
+  requires IsOutputStream<Stream>
+  void to_checked_binary(const T& obj, Stream& stream) {
+    cereal::BinaryOutputArchive ar(stream);
+    save_fingerprint<T>(ar);
+    ar(obj);
+  }
+
+  /**
+   * from_binary that checks the fingerprint first. Nothing gets read
+   * into obj unless it matches.
+   */
+
+  template <typename T, typename Stream>
+  requires IsInputStream<Stream>
+  void from_checked_binary(T& obj, Stream& stream) {
+    cereal::BinaryInputArchive ar(stream);
+    check_fingerprint<T>(ar);
+    ar(obj);
+  }
+
+}
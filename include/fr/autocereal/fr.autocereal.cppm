@@ -18,12 +18,38 @@
 module;
 
 #include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/traits.h>
+#include <fr/autocereal/arrow.h>
+#include <fr/autocereal/async_file.h>
+#include <fr/autocereal/batch.h>
+#include <fr/autocereal/chunk_stream.h>
+#include <fr/autocereal/chunked.h>
+#include <fr/autocereal/compression.h>
+#include <fr/autocereal/csv.h>
+#include <fr/autocereal/fingerprint.h>
+#include <fr/autocereal/indexed.h>
+#include <fr/autocereal/json.h>
+#include <fr/autocereal/json_projection.h>
+#include <fr/autocereal/json_stream.h>
+#include <fr/autocereal/lazy.h>
+#include <fr/autocereal/ndjson.h>
+#include <fr/autocereal/parallel.h>
+#include <fr/autocereal/pipeline.h>
+#include <fr/autocereal/schema_binary.h>
+#include <fr/autocereal/serialized_size.h>
+#include <fr/autocereal/xml.h>
 
 export module fr.autocereal;
 
 export namespace fr::autocereal {
     using fr::autocereal::MAX_IDENTIFIER_LENGTH;
     using fr::autocereal::MAX_CLASS_MEMBERS;
+    using fr::autocereal::SkipAnnotation;
+    using fr::autocereal::TransientAnnotation;
+    using fr::autocereal::skip;
+    using fr::autocereal::transient;
+    using fr::autocereal::MAX_POOLED_BUFFER_BYTES;
+    using fr::autocereal::SharedPool;
     using fr::autocereal::ClassSingleton;
     using fr::autocereal::IsInputStream;
     using fr::autocereal::IsOutputStream;
@@ -40,8 +66,98 @@ export namespace fr::autocereal {
     using fr::autocereal::from_input_archive;
     using fr::autocereal::to_json;
     using fr::autocereal::from_json;
+    using fr::autocereal::to_binary;
+    using fr::autocereal::from_binary;
     using fr::autocereal::to_xml;
     using fr::autocereal::from_xml;
+    using fr::autocereal::IsString;
+    using fr::autocereal::IsVector;
+    using fr::autocereal::IsOptional;
+    using fr::autocereal::IsStdArray;
+    using fr::autocereal::IsSharedPtr;
+    using fr::autocereal::IsUniquePtr;
+    using fr::autocereal::IsScalar;
+    using fr::autocereal::IsRecord;
+    using fr::autocereal::IsReflectedRecord;
+    using fr::autocereal::IsPlainRecord;
+    using fr::autocereal::member_type_t;
+    using fr::autocereal::forEachMember;
+    using fr::autocereal::flatMemberCount;
+    using fr::autocereal::ARROW_BATCH_ROWS;
+    using fr::autocereal::ARROW_BUFFER_ALIGNMENT;
+    using fr::autocereal::to_arrow_ipc;
+    using fr::autocereal::from_arrow_ipc;
+    using fr::autocereal::defaultThreadCount;
+    using fr::autocereal::parallelFor;
+    using fr::autocereal::parallelForStealing;
+    using fr::autocereal::CSV_MIN_CHUNK_BYTES;
+    using fr::autocereal::to_csv;
+    using fr::autocereal::from_csv;
+    using fr::autocereal::CHUNKED_BINARY_ELEMENTS;
+    using fr::autocereal::to_chunked_binary;
+    using fr::autocereal::from_chunked_binary;
+    using fr::autocereal::Codec;
+    using fr::autocereal::Compression;
+    using fr::autocereal::CompressingStreamBuf;
+    using fr::autocereal::DecompressingStreamBuf;
+    using fr::autocereal::CompressedOutputStream;
+    using fr::autocereal::DecompressedInputStream;
+    using fr::autocereal::to_compressed;
+    using fr::autocereal::from_compressed;
+    using fr::autocereal::JSON_ARRAY_SLICE_ELEMENTS;
+    using fr::autocereal::to_json_array;
+    using fr::autocereal::JSON_PARSE_BLOCK_ELEMENTS;
+    using fr::autocereal::JsonReuse;
+    using fr::autocereal::from_json_array;
+    using fr::autocereal::JsonLayout;
+    using fr::autocereal::JSON_STREAM_BUFFER_BYTES;
+    using fr::autocereal::json_stream_reader;
+    using fr::autocereal::from_json_stream;
+    using fr::autocereal::json_projection;
+    using fr::autocereal::lazy;
+    using fr::autocereal::IsLazy;
+    using fr::autocereal::save;
+    using fr::autocereal::load;
+    using fr::autocereal::to_indexed_binary;
+    using fr::autocereal::from_indexed_binary;
+    using fr::autocereal::ChunkFormat;
+    using fr::autocereal::CHUNK_STREAM_BYTES;
+    using fr::autocereal::serialize_chunks;
+    using fr::autocereal::chunk_loader;
+    using fr::autocereal::AsyncFileOptions;
+    using fr::autocereal::AsyncFileStreamBuf;
+    using fr::autocereal::AsyncFileOutputStream;
+    using fr::autocereal::to_binary_file;
+    using fr::autocereal::to_binary_batch;
+    using fr::autocereal::from_binary_batch;
+    using fr::autocereal::to_json_batch;
+    using fr::autocereal::from_json_batch;
+    using fr::autocereal::PIPELINE_BATCH_ITEMS;
+    using fr::autocereal::PipelineOptions;
+    using fr::autocereal::PipelineStats;
+    using fr::autocereal::to_binary_pipeline;
+    using fr::autocereal::from_binary_pipeline;
+#if defined(__cpp_lib_senders)
+    using fr::autocereal::pipeline_sender;
+#endif
+    using fr::autocereal::HasFixedSerializedSize;
+    using fr::autocereal::serialized_size;
+    using fr::autocereal::to_binary_array;
+    using fr::autocereal::schema_fingerprint;
+    using fr::autocereal::SchemaMismatch;
+    using fr::autocereal::save_fingerprint;
+    using fr::autocereal::check_fingerprint;
+    using fr::autocereal::to_checked_binary;
+    using fr::autocereal::from_checked_binary;
+    using fr::autocereal::schema_binary_writer;
+    using fr::autocereal::schema_binary_reader;
+    using fr::autocereal::to_schema_binary;
+    using fr::autocereal::from_schema_binary;
+    using fr::autocereal::NDJSON_FLUSH_BYTES;
+    using fr::autocereal::ndjson_writer;
+    using fr::autocereal::ndjson_reader;
+    using fr::autocereal::XML_READ_BUFFER_BYTES;
+    using fr::autocereal::from_xml_streaming;
 }
 
 export namespace cereal {
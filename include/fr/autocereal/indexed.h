@@ -0,0 +1,251 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * Binary format with a per-member index, so the members of one big
+ * object can load on separate threads.
+ *
+ * saveHelper/loadHelper walk the members one after another, which is
+ * fine until an object holds a few multi-gigabyte vectors and loading
+ * it is stuck on one core. to_indexed_binary writes each (flattened,
+ * parents first) member with its own cereal::BinaryOutputArchive and
+ * remembers where it landed:
+ *
+ *   member 0 | member 1 | ... | footer
+ *
+ *   footer: { offset, size } per member, then the member count and
+ *           the "ACINDEX1" magic. Little endian uint64s, offsets from
+ *           the start of the object.
+ *
+ * from_indexed_binary reads the footer and hands every member to its
+ * own task. Given a file path, each thread opens the file itself and
+ * reads its member straight off disk, so the reads happen in parallel
+ * too. Given a stream, the reads take turns on the stream and only
+ * the decoding runs in parallel.
+ *
+ * Each member is its own archive, so cereal's shared pointer tracking
+ * doesn't reach across members.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/chunked.h>
+#include <fr/autocereal/parallel.h>
+#include <fr/autocereal/traits.h>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <spanstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fr::autocereal {
+
+  namespace detail::indexed {
+
+    inline constexpr std::string_view MAGIC = "ACINDEX1";
+
+    // Member count and the magic
+    inline constexpr size_t TRAILER_BYTES = 16;
+
+    struct MemberEntry {
+      uint64_t offset;
+      uint64_t size;
+    };
+
+    inline std::vector<MemberEntry> readFooter(std::istream& stream, std::streamoff start, size_t expectedMembers) {
+      stream.seekg(0, std::ios::end);
+      std::streamoff end = stream.tellg();
+      if (!stream || end - start < static_cast<std::streamoff>(TRAILER_BYTES)) {
+        throw cereal::Exception("Not an indexed binary object");
+      }
+      uint64_t length = static_cast<uint64_t>(end - start);
+
+      std::array<char, TRAILER_BYTES> trailer;
+      stream.seekg(end - static_cast<std::streamoff>(TRAILER_BYTES));
+      readExactly(stream, trailer.data(), trailer.size());
+      if (std::string_view(trailer.data() + 8, 8) != MAGIC) {
+        throw cereal::Exception("Not an indexed binary object");
+      }
+      if (getU64(trailer.data()) != expectedMembers) {
+        throw cereal::Exception("Indexed binary object has a different number of members than this class");
+      }
+
+      uint64_t indexBytes = expectedMembers * 16;
+      if (indexBytes > length - TRAILER_BYTES) {
+        throw cereal::Exception("Indexed binary footer is corrupt");
+      }
+      uint64_t dataEnd = length - TRAILER_BYTES - indexBytes;
+      std::string index(indexBytes, '\0');
+      stream.seekg(start + static_cast<std::streamoff>(dataEnd));
+      readExactly(stream, index.data(), index.size());
+
+      std::vector<MemberEntry> members(expectedMembers);
+      for (size_t i = 0; i < expectedMembers; ++i) {
+        members[i] = {getU64(index.data() + i * 16), getU64(index.data() + i * 16 + 8)};
+        if (members[i].offset > dataEnd || members[i].size > dataEnd - members[i].offset) {
+          throw cereal::Exception("Indexed binary footer points outside the data");
+        }
+      }
+      return members;
+    }
+
+    /**
+     * Per-member load functions in forEachMember order, built once
+     * per type
+     */
+
+    template <typename T>
+    class MemberLoaders {
+    public:
+      using Loader = void (*)(cereal::BinaryInputArchive&, T&);
+
+      static const std::vector<Loader>& instance() {
+        static const std::vector<Loader> loaders = build();
+        return loaders;
+      }
+
+    private:
+      static std::vector<Loader> build() {
+        std::vector<Loader> loaders;
+        forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+          loaders.push_back([](cereal::BinaryInputArchive& ar, T& obj) {
+            constexpr auto info = member_info<Owner, index>();
+            ar(member_ref<Owner, info>(obj));
+          });
+        });
+        return loaders;
+      }
+    };
+
+    /**
+     * Loads member number member of obj from stream, which needs to
+     * be sitting at the start of it
+     */
+
+    template <typename T>
+    void loadMember(std::istream& stream, T& obj, size_t member, uint64_t size) {
+      std::streamoff start = stream.tellg();
+      {
+        cereal::BinaryInputArchive ar(stream);
+        MemberLoaders<T>::instance()[member](ar, obj);
+      }
+      if (stream.tellg() - start != static_cast<std::streamoff>(size)) {
+        throw cereal::Exception("Indexed binary member didn't use up its bytes");
+      }
+    }
+
+  }
+
+  /**
+   * Writes obj with a member index. Members go straight to the stream
+   * one after another; nothing gets buffered.
+   */
+
+  template <typename T>
+  void to_indexed_binary(const T& obj, std::ostream& stream) {
+    std::string footer;
+    uint64_t offset = 0;
+    std::streamoff start = stream.tellp();
+    if (start < 0) {
+      throw cereal::Exception("Indexed binary needs a stream that knows its position");
+    }
+
+    forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+      constexpr auto info = member_info<Owner, index>();
+      {
+        cereal::BinaryOutputArchive ar(stream);
+        ar(member_ref_const<Owner, info>(obj));
+      }
+      uint64_t end = static_cast<uint64_t>(stream.tellp() - start);
+      detail::putU64(footer, offset);
+      detail::putU64(footer, end - offset);
+      offset = end;
+    });
+
+    detail::putU64(footer, flatMemberCount<T>());
+    footer.append(detail::indexed::MAGIC);
+    stream.write(footer.data(), static_cast<std::streamsize>(footer.size()));
+    if (!stream) {
+      throw cereal::Exception("Failed writing indexed binary object");
+    }
+  }
+
+  /**
+   * Reads an indexed binary object from the stream's current position
+   * through to the end. Members decode in parallel, reads from the
+   * stream take turns.
+   */
+
+  template <typename T>
+  void from_indexed_binary(T& obj, std::istream& stream, size_t threads = defaultThreadCount()) {
+    std::streamoff start = stream.tellg();
+    if (start < 0) {
+      throw cereal::Exception("Indexed binary needs a seekable stream");
+    }
+    auto members = detail::indexed::readFooter(stream, start, flatMemberCount<T>());
+    detail::resetAllTransients(obj);
+    std::mutex streamMutex;
+
+    parallelFor(members.size(), threads, [&](size_t member) {
+      std::string bytes(members[member].size, '\0');
+      {
+        std::lock_guard lock(streamMutex);
+        stream.seekg(start + static_cast<std::streamoff>(members[member].offset));
+        detail::readExactly(stream, bytes.data(), bytes.size());
+      }
+      std::ispanstream in(std::span<const char>(bytes.data(), bytes.size()));
+      detail::indexed::loadMember(in, obj, member, members[member].size);
+    });
+  }
+
+  /**
+   * Reads an indexed binary file. Every thread opens the file for
+   * itself, so the members are read as well as decoded in parallel,
+   * and nothing is copied into an intermediate buffer.
+   */
+
+  template <typename T>
+  void from_indexed_binary(T& obj, const std::filesystem::path& path, size_t threads = defaultThreadCount()) {
+    std::vector<detail::indexed::MemberEntry> members;
+    {
+      std::ifstream file(path, std::ios::binary);
+      if (!file) {
+        throw cereal::Exception("Could not open " + path.string());
+      }
+      members = detail::indexed::readFooter(file, 0, flatMemberCount<T>());
+    }
+    detail::resetAllTransients(obj);
+
+    parallelFor(members.size(), threads, [&](size_t member) {
+      std::ifstream file(path, std::ios::binary);
+      if (!file) {
+        throw cereal::Exception("Could not open " + path.string());
+      }
+      file.seekg(static_cast<std::streamoff>(members[member].offset));
+      detail::indexed::loadMember(file, obj, member, members[member].size);
+    });
+  }
+
+}
@@ -0,0 +1,393 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * The op-list interpreter behind AUTOCEREAL_INTERPRETED_BINARY.
+ *
+ * Normally every class gets its own chain of saveHelper/loadHelper
+ * instantiations for every archive it's used with, one function per
+ * member, and with a few hundred message types that's a lot of code.
+ * With AUTOCEREAL_INTERPRETED_BINARY defined, cereal's binary archives
+ * don't go through that chain at all. Each class gets a constexpr list
+ * of ops instead -- copy this many bytes from this offset, write a
+ * string, recurse into a nested class, write a vector -- and one
+ * interpreter loop, shared by every class, walks it. A class then only
+ * costs you its op-list in rodata.
+ *
+ * Members the op-list doesn't know how to do (maps, optionals, smart
+ * pointers, pmr containers and so on) get a fallback op that hands
+ * them back to cereal, so anything that serialized before still does.
+ * The bytes written are exactly what the template path writes, so
+ * the two can read each other's output. Members that sit next to each
+ * other in memory with no padding between them are merged into a
+ * single copy.
+ *
+ * Only BinaryOutputArchive and BinaryInputArchive are interpreted.
+ * JSON and XML need member names and the portable binary archive
+ * needs byte swapping, so those still use the templates.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/traits.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <meta>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fr::autocereal::detail::interp {
+
+  enum class OpCode : uint8_t {
+    Raw,
+    String,
+    Nested,
+    RawVector,
+    NestedVector,
+    Fallback,
+    Reset
+  };
+
+  struct Op;
+  using Ops = std::span<const Op>;
+  using OpsFn = Ops (*)();
+
+  /**
+   * What the interpreter needs to know about a particular vector
+   * type, without knowing the type
+   */
+
+  struct VectorAccess {
+    size_t (*size)(const void* vector);
+    const void* (*data)(const void* vector);
+    void* (*resize)(void* vector, size_t count);
+  };
+
+  /**
+   * Save and load for a member the op-list hands off to cereal
+   */
+
+  struct FallbackAccess {
+    void (*save)(cereal::BinaryOutputArchive& ar, const void* member);
+    void (*load)(cereal::BinaryInputArchive& ar, void* member);
+  };
+
+  struct Op {
+    OpCode code = OpCode::Raw;
+    uint32_t offset = 0;
+    // Bytes to copy for Raw, size of one element for the vectors
+    uint32_t size = 0;
+    OpsFn nested = nullptr;
+    const VectorAccess* vector = nullptr;
+    const FallbackAccess* fallback = nullptr;
+    // Puts a class's transient members back on load
+    void (*reset)(void* object) = nullptr;
+  };
+
+  template <typename Vector>
+  inline constexpr VectorAccess vectorAccess{
+    [](const void* vector) -> size_t {
+      return static_cast<const Vector*>(vector)->size();
+    },
+    [](const void* vector) -> const void* {
+      return static_cast<const Vector*>(vector)->data();
+    },
+    [](void* vector, size_t count) -> void* {
+      auto* typed = static_cast<Vector*>(vector);
+      typed->resize(count);
+      return typed->data();
+    }
+  };
+
+  template <typename T>
+  inline constexpr FallbackAccess fallbackAccess{
+    [](cereal::BinaryOutputArchive& ar, const void* member) {
+      ar(*static_cast<const T*>(member));
+    },
+    [](cereal::BinaryInputArchive& ar, void* member) {
+      auto& typed = *static_cast<T*>(member);
+      rebindToLoadResource(typed);
+      loadMember(ar, typed);
+    }
+  };
+
+  /**
+   * Things cereal writes as their own bytes in a binary archive
+   */
+
+  template <typename T>
+  constexpr bool isRaw() {
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+      return true;
+    } else if constexpr (IsStdArray<T>) {
+      return std::is_arithmetic_v<typename T::value_type>;
+    } else {
+      return false;
+    }
+  }
+
+  // Plain std::vector only. A pmr vector needs rebinding on load, so
+  // it goes through the fallback.
+  template <typename T>
+  constexpr bool isPlainVector() {
+    if constexpr (IsVector<T>) {
+      return std::is_same_v<T, std::vector<typename T::value_type>>
+        && !std::is_same_v<typename T::value_type, bool>;
+    } else {
+      return false;
+    }
+  }
+
+  template <typename Class>
+  Ops descriptorOps();
+
+  template <typename Member>
+  consteval Op opFor(uint32_t offset) {
+    Op op;
+    op.offset = offset;
+    if constexpr (isRaw<Member>()) {
+      op.code = OpCode::Raw;
+      op.size = sizeof(Member);
+    } else if constexpr (std::is_same_v<Member, std::string>) {
+      op.code = OpCode::String;
+    } else if constexpr (IsPlainRecord<Member>) {
+      op.code = OpCode::Nested;
+      op.nested = &descriptorOps<Member>;
+    } else if constexpr (isPlainVector<Member>() && std::is_arithmetic_v<typename Member::value_type>) {
+      op.code = OpCode::RawVector;
+      op.size = sizeof(typename Member::value_type);
+      op.vector = &vectorAccess<Member>;
+    } else if constexpr (isPlainVector<Member>() && IsPlainRecord<typename Member::value_type>) {
+      op.code = OpCode::NestedVector;
+      op.size = sizeof(typename Member::value_type);
+      op.nested = &descriptorOps<typename Member::value_type>;
+      op.vector = &vectorAccess<Member>;
+    } else {
+      op.code = OpCode::Fallback;
+      op.fallback = &fallbackAccess<Member>;
+    }
+    return op;
+  }
+
+  /**
+   * Adds op to the list, folding it into the previous op if they're
+   * both raw copies and there's no gap between them
+   */
+
+  template <size_t N>
+  consteval void append(std::array<Op, N>& ops, size_t& used, Op op) {
+    if (op.code == OpCode::Raw && used > 0) {
+      Op& last = ops[used - 1];
+      if (last.code == OpCode::Raw && last.offset + last.size == op.offset) {
+        last.size += op.size;
+        return;
+      }
+    }
+    ops[used++] = op;
+  }
+
+  template <typename Class, size_t N>
+  consteval void appendOps(std::array<Op, N>& ops, size_t& used, uint32_t base);
+
+  template <typename Class, size_t index = 0, size_t N>
+  consteval void appendParents(std::array<Op, N>& ops, size_t& used, uint32_t base) {
+    if constexpr (index < ClassSingleton<Class>::baseCount()) {
+      using Parent = typename ClassSingleton<Class>::template Parent<index>::Type;
+      constexpr auto ctx = std::meta::access_context::unchecked();
+      constexpr auto baseInfo = std::meta::bases_of(^^Class, ctx)[index];
+      static_assert(!std::meta::is_virtual(baseInfo), "The binary interpreter can't follow virtual bases");
+      appendOps<Parent>(ops, used, base + static_cast<uint32_t>(std::meta::offset_of(baseInfo).bytes));
+      appendParents<Class, index + 1>(ops, used, base);
+    }
+  }
+
+  template <typename Class, size_t index = 0, size_t N>
+  consteval void appendOwnMembers(std::array<Op, N>& ops, size_t& used, uint32_t base) {
+    if constexpr (index < ClassSingleton<Class>::memberCount()) {
+      constexpr auto info = member_info<Class, index>();
+      using Member = member_type_t<Class, index>;
+      append(ops, used, opFor<Member>(base + static_cast<uint32_t>(std::meta::offset_of(info).bytes)));
+      appendOwnMembers<Class, index + 1>(ops, used, base);
+    }
+  }
+
+  // Resets Class's transient members, if it has any, the same place
+  // loadHelper does it
+  template <typename Class, size_t N>
+  consteval void appendReset(std::array<Op, N>& ops, size_t& used, uint32_t base) {
+    if constexpr (TRANSIENT_MEMBERS<Class>.size() > 0) {
+      Op op;
+      op.code = OpCode::Reset;
+      op.offset = base;
+      op.reset = [](void* object) {
+        resetTransients(*static_cast<Class*>(object));
+      };
+      ops[used++] = op;
+    }
+  }
+
+  // Parents first, then our own members, same order saveHelper uses
+  template <typename Class, size_t N>
+  consteval void appendOps(std::array<Op, N>& ops, size_t& used, uint32_t base) {
+    appendParents<Class>(ops, used, base);
+    appendReset<Class>(ops, used, base);
+    appendOwnMembers<Class>(ops, used, base);
+  }
+
+  // One reset op for every class in the hierarchy with transient members
+  template <typename Class>
+  consteval size_t resetCount() {
+    size_t count = TRANSIENT_MEMBERS<Class>.size() > 0 ? 1 : 0;
+    [&]<size_t... index>(std::index_sequence<index...>) {
+      ((count += resetCount<typename ClassSingleton<Class>::template Parent<index>::Type>()), ...);
+    }(std::make_index_sequence<ClassSingleton<Class>::baseCount()>());
+    return count;
+  }
+
+  /**
+   * The op-list for a class. Built at compile time, lives in rodata.
+   * There's never more ops than members plus resets, and usually fewer
+   * once the raw copies are merged.
+   */
+
+  template <typename Class>
+  struct Descriptor {
+    struct Built {
+      std::array<Op, flatMemberCount<Class>() + resetCount<Class>()> ops{};
+      size_t used = 0;
+    };
+
+    static constexpr Built built = [] consteval {
+      Built result;
+      appendOps<Class>(result.ops, result.used, 0);
+      return result;
+    }();
+  };
+
+  template <typename Class>
+  Ops descriptorOps() {
+    return Ops(Descriptor<Class>::built.ops.data(), Descriptor<Class>::built.used);
+  }
+
+  /**
+   * The interpreter proper. These two aren't templates, so there's
+   * exactly one copy of each no matter how many classes you have.
+   */
+
+  inline void saveOps(cereal::BinaryOutputArchive& ar, Ops ops, const std::byte* object) {
+    for (const Op& op : ops) {
+      const std::byte* member = object + op.offset;
+      switch (op.code) {
+        case OpCode::Raw:
+          ar.saveBinary(member, op.size);
+          break;
+        case OpCode::String: {
+          const auto& value = *reinterpret_cast<const std::string*>(member);
+          ar(cereal::make_size_tag(static_cast<cereal::size_type>(value.size())));
+          ar.saveBinary(value.data(), static_cast<std::streamsize>(value.size()));
+          break;
+        }
+        case OpCode::Nested:
+          saveOps(ar, op.nested(), member);
+          break;
+        case OpCode::RawVector: {
+          size_t count = op.vector->size(member);
+          ar(cereal::make_size_tag(static_cast<cereal::size_type>(count)));
+          ar.saveBinary(op.vector->data(member), static_cast<std::streamsize>(count * op.size));
+          break;
+        }
+        case OpCode::NestedVector: {
+          size_t count = op.vector->size(member);
+          ar(cereal::make_size_tag(static_cast<cereal::size_type>(count)));
+          Ops nested = op.nested();
+          const auto* element = static_cast<const std::byte*>(op.vector->data(member));
+          for (size_t i = 0; i < count; ++i, element += op.size) {
+            saveOps(ar, nested, element);
+          }
+          break;
+        }
+        case OpCode::Fallback:
+          op.fallback->save(ar, member);
+          break;
+        case OpCode::Reset:
+          break;
+      }
+    }
+  }
+
+  inline void loadOps(cereal::BinaryInputArchive& ar, Ops ops, std::byte* object) {
+    for (const Op& op : ops) {
+      std::byte* member = object + op.offset;
+      switch (op.code) {
+        case OpCode::Raw:
+          ar.loadBinary(member, op.size);
+          break;
+        case OpCode::String: {
+          auto& value = *reinterpret_cast<std::string*>(member);
+          cereal::size_type size;
+          ar(cereal::make_size_tag(size));
+          value.resize(static_cast<size_t>(size));
+          ar.loadBinary(value.data(), static_cast<std::streamsize>(size));
+          break;
+        }
+        case OpCode::Nested:
+          loadOps(ar, op.nested(), member);
+          break;
+        case OpCode::RawVector: {
+          cereal::size_type size;
+          ar(cereal::make_size_tag(size));
+          void* data = op.vector->resize(member, static_cast<size_t>(size));
+          ar.loadBinary(data, static_cast<std::streamsize>(static_cast<size_t>(size) * op.size));
+          break;
+        }
+        case OpCode::NestedVector: {
+          cereal::size_type size;
+          ar(cereal::make_size_tag(size));
+          Ops nested = op.nested();
+          auto* element = static_cast<std::byte*>(op.vector->resize(member, static_cast<size_t>(size)));
+          for (size_t i = 0; i < static_cast<size_t>(size); ++i, element += op.size) {
+            loadOps(ar, nested, element);
+          }
+          break;
+        }
+        case OpCode::Fallback:
+          op.fallback->load(ar, member);
+          break;
+        case OpCode::Reset:
+          op.reset(member);
+          break;
+      }
+    }
+  }
+
+  template <typename Class>
+  void saveObject(cereal::BinaryOutputArchive& ar, const Class& instance) {
+    saveOps(ar, descriptorOps<Class>(), reinterpret_cast<const std::byte*>(std::addressof(instance)));
+  }
+
+  template <typename Class>
+  void loadObject(cereal::BinaryInputArchive& ar, Class& instance) {
+    loadOps(ar, descriptorOps<Class>(), reinterpret_cast<std::byte*>(std::addressof(instance)));
+  }
+
+}
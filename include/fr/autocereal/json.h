@@ -0,0 +1,916 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * Native compact JSON for reflected types, with no cereal archive in
+ * the middle.
+ *
+ * cereal's JSON archives are great for one-off documents, but setting
+ * one up costs more than writing out a small struct does, and the
+ * input archive parses the whole document into a rapidjson DOM before
+ * it hands you anything. This walks the reflected members directly:
+ * the writer appends to a std::string you can reuse, and the reader is
+ * a pull parser working straight off the input text.
+ *
+ * Objects come out the way cereal lays out their members -- parents
+ * flattened into the same object, keyed by member name -- just
+ * without the outer "value0" wrapper and without whitespace. Members
+ * are matched by name on the way in, in any order, and keys we don't
+ * know get skipped. Supported members are bool, numbers, enums (as
+ * their underlying integer), std::string, std::vector, std::array,
+ * std::optional, std::shared_ptr and std::unique_ptr (null or the
+ * pointee, no cereal ptr_wrapper) and nested reflected structs.
+ * Optionals and lazy members are written as null or the bare value,
+ * but the reader also takes cereal's {"nullopt": ..., "data": ...}
+ * and {"value0": ...} for them. An object whose first key happens to
+ * be "nullopt" or "value0" would get taken for one of those, so don't
+ * name a member that.
+ *
+ * Non-finite floating point values have no JSON spelling, so they
+ * are written as null and null reads back as a quiet NaN.
+ *
+ * to_json_array and from_json_array at the bottom are the public
+ * face of all this, for big arrays of records. They split the work
+ * up across threads.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/lazy.h>
+#include <fr/autocereal/parallel.h>
+#include <fr/autocereal/traits.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fr::autocereal {
+
+  /**
+   * What the native reader does with elements a vector already has
+   * when it reads an array into it. Reset throws them away and reads
+   * into fresh ones, so a key missing from an element gets its
+   * default. InPlace reads over them instead, so their strings and
+   * vectors keep their capacity and decoding into a warmed up vector
+   * doesn't allocate, but a key missing from an element keeps
+   * whatever that element had before.
+   */
+
+  enum class JsonReuse {
+    Reset,
+    InPlace
+  };
+
+  namespace detail::json {
+
+    inline void appendEscaped(std::string& out, std::string_view value) {
+      static constexpr char hex[] = "0123456789abcdef";
+      out.push_back('"');
+      size_t clean = 0;
+      for (size_t i = 0; i < value.size(); ++i) {
+        auto c = static_cast<unsigned char>(value[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+          continue;
+        }
+        out.append(value.data() + clean, i - clean);
+        clean = i + 1;
+        switch (c) {
+        case '"': out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '\n': out.append("\\n"); break;
+        case '\r': out.append("\\r"); break;
+        case '\t': out.append("\\t"); break;
+        case '\b': out.append("\\b"); break;
+        case '\f': out.append("\\f"); break;
+        default:
+          out.append("\\u00");
+          out.push_back(hex[c >> 4]);
+          out.push_back(hex[c & 0xf]);
+        }
+      }
+      out.append(value.data() + clean, value.size() - clean);
+      out.push_back('"');
+    }
+
+    template <typename T>
+    void writeRecord(std::string& out, const T& obj);
+
+    template <typename T>
+    void decodeLazy(std::string_view encoded, T& value);
+
+    template <typename V>
+    void writeValue(std::string& out, const V& value) {
+      if constexpr (std::same_as<V, bool>) {
+        out.append(value ? "true" : "false");
+      } else if constexpr (std::is_enum_v<V>) {
+        writeValue(out, std::to_underlying(value));
+      } else if constexpr (std::is_floating_point_v<V>) {
+        if (!std::isfinite(value)) {
+          out.append("null");
+          return;
+        }
+        char buffer[64];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+      } else if constexpr (std::is_arithmetic_v<V>) {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+      } else if constexpr (IsString<V>) {
+        appendEscaped(out, value);
+      } else if constexpr (IsOptional<V> || IsSharedPtr<V> || IsUniquePtr<V>) {
+        if (value) {
+          writeValue(out, *value);
+        } else {
+          out.append("null");
+        }
+      } else if constexpr (IsLazy<V>) {
+        // Text we read and nobody's decoded goes back out as it was
+        if (const std::string* encoded = LazyAccess::encodedFor(value, &decodeLazy<typename V::value_type>)) {
+          out.append(*encoded);
+        } else {
+          writeValue(out, value.get());
+        }
+      } else if constexpr (IsVector<V> || IsStdArray<V>) {
+        out.push_back('[');
+        bool first = true;
+        for (const auto& element : value) {
+          if (!first) {
+            out.push_back(',');
+          }
+          first = false;
+          // The cast is a no-op except for std::vector<bool>'s proxies
+          writeValue(out, static_cast<const typename V::value_type&>(element));
+        }
+        out.push_back(']');
+      } else if constexpr (IsRecord<V>) {
+        writeRecord(out, value);
+      } else {
+        static_assert(false, "No native JSON support for this member type");
+      }
+    }
+
+    template <typename T>
+    void writeRecord(std::string& out, const T& obj) {
+      out.push_back('{');
+      bool first = true;
+      forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+        constexpr auto info = member_info<Owner, index>();
+        if (!first) {
+          out.push_back(',');
+        }
+        first = false;
+        // Identifiers never need escaping
+        out.push_back('"');
+        out.append(ClassSingleton<Owner>::instance().memberAtIndex(index));
+        out.append("\":");
+        writeValue(out, member_ref_const<Owner, info>(obj));
+      });
+      out.push_back('}');
+    }
+
+    /**
+     * Pull parser over a complete piece of JSON text. It doesn't own
+     * the text, so keep that alive while you're reading.
+     */
+
+    class JsonReader {
+      const char* _begin;
+      const char* _p;
+      const char* _end;
+      // Only used for keys that have escapes in them
+      std::string _keyScratch;
+      JsonReuse _reuse;
+
+      static bool isWhitespace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+      }
+
+      static bool isNumberChar(char c) {
+        return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+      }
+
+      static int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+      }
+
+      uint32_t readHex4() {
+        if (_end - _p < 4) {
+          fail("truncated \\u escape");
+        }
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+          int digit = hexValue(*_p++);
+          if (digit < 0) {
+            fail("bad \\u escape");
+          }
+          value = (value << 4) | digit;
+        }
+        return value;
+      }
+
+      template <typename String>
+      static void appendUtf8(String& out, uint32_t cp) {
+        if (cp < 0x80) {
+          out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+          out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+          out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+          out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+          out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+          out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+          out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+          out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+          out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+          out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+      }
+
+      // Finds the closing quote of a string whose opening quote has
+      // already been consumed, without decoding anything
+      const char* findStringEnd(const char* p) const {
+        while (true) {
+          const char* quote = static_cast<const char*>(std::memchr(p, '"', _end - p));
+          if (quote == nullptr) {
+            fail("unterminated string");
+          }
+          const char* backslash = quote;
+          while (backslash > p && backslash[-1] == '\\') {
+            --backslash;
+          }
+          if (((quote - backslash) & 1) == 0) {
+            return quote;
+          }
+          p = quote + 1;
+        }
+      }
+
+      // Decodes the body of a string with escapes in it, up to the
+      // closing quote. String is any std::basic_string<char>, whatever
+      // its allocator.
+      template <typename String>
+      void decodeString(String& out) {
+        while (true) {
+          if (_p >= _end) {
+            fail("unterminated string");
+          }
+          char c = *_p++;
+          if (c == '"') {
+            return;
+          }
+          if (c != '\\') {
+            out.push_back(c);
+            continue;
+          }
+          if (_p >= _end) {
+            fail("unterminated string");
+          }
+          switch (*_p++) {
+          case '"': out.push_back('"'); break;
+          case '\\': out.push_back('\\'); break;
+          case '/': out.push_back('/'); break;
+          case 'b': out.push_back('\b'); break;
+          case 'f': out.push_back('\f'); break;
+          case 'n': out.push_back('\n'); break;
+          case 'r': out.push_back('\r'); break;
+          case 't': out.push_back('\t'); break;
+          case 'u': {
+            uint32_t cp = readHex4();
+            if (cp >= 0xD800 && cp < 0xDC00 && _end - _p >= 6 && _p[0] == '\\' && _p[1] == 'u') {
+              _p += 2;
+              uint32_t low = readHex4();
+              if (low < 0xDC00 || low >= 0xE000) {
+                fail("bad surrogate pair");
+              }
+              cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            }
+            appendUtf8(out, cp);
+            break;
+          }
+          default:
+            fail("bad escape");
+          }
+        }
+      }
+
+    public:
+      explicit JsonReader(std::string_view text, JsonReuse reuse = JsonReuse::Reset)
+        : _begin(text.data()), _p(text.data()), _end(text.data() + text.size()), _reuse(reuse) {}
+
+      JsonReuse reuse() const {
+        return _reuse;
+      }
+
+      [[noreturn]] void fail(const char* what) const {
+        throw cereal::Exception(std::string("JSON parse error at offset ") + std::to_string(_p - _begin) + ": " + what);
+      }
+
+      size_t position() const {
+        return _p - _begin;
+      }
+
+      void skipWhitespace() {
+        while (_p < _end && isWhitespace(*_p)) {
+          ++_p;
+        }
+      }
+
+      bool atEnd() {
+        skipWhitespace();
+        return _p == _end;
+      }
+
+      // Next significant character, or 0 at the end of the text
+      char peek() {
+        skipWhitespace();
+        return _p < _end ? *_p : '\0';
+      }
+
+      bool consume(char c) {
+        if (peek() == c) {
+          ++_p;
+          return true;
+        }
+        return false;
+      }
+
+      void expect(char c) {
+        if (!consume(c)) {
+          char message[] = "expected 'x'";
+          message[10] = c;
+          fail(message);
+        }
+      }
+
+      bool consumeLiteral(std::string_view literal) {
+        skipWhitespace();
+        if (static_cast<size_t>(_end - _p) >= literal.size() && std::memcmp(_p, literal.data(), literal.size()) == 0) {
+          _p += literal.size();
+          return true;
+        }
+        return false;
+      }
+
+      template <typename String>
+      void readString(String& out) {
+        expect('"');
+        const char* close = findStringEnd(_p);
+        const char* escape = static_cast<const char*>(std::memchr(_p, '\\', close - _p));
+        if (escape == nullptr) {
+          out.assign(_p, close);
+          _p = close + 1;
+          return;
+        }
+        out.assign(_p, escape);
+        _p = escape;
+        decodeString(out);
+      }
+
+      // Keys usually don't have escapes, so most of the time this is a
+      // view straight into the input
+      std::string_view readKey() {
+        expect('"');
+        const char* close = findStringEnd(_p);
+        if (std::memchr(_p, '\\', close - _p) == nullptr) {
+          std::string_view key(_p, close - _p);
+          _p = close + 1;
+          return key;
+        }
+        _keyScratch.clear();
+        decodeString(_keyScratch);
+        return _keyScratch;
+      }
+
+      template <typename N>
+      void readNumber(N& value) {
+        skipWhitespace();
+        if constexpr (std::is_floating_point_v<N>) {
+          if (consumeLiteral("null")) {
+            value = std::numeric_limits<N>::quiet_NaN();
+            return;
+          }
+        }
+        const char* start = _p;
+        while (_p < _end && isNumberChar(*_p)) {
+          ++_p;
+        }
+        auto result = std::from_chars(start, _p, value);
+        if (result.ec != std::errc{} || result.ptr != _p) {
+          _p = start;
+          fail("bad number");
+        }
+      }
+
+      /**
+       * Skips over the next value without building anything. Strings
+       * get jumped over with memchr, containers just count brackets.
+       */
+
+      void skipValue() {
+        char c = peek();
+        if (c == '"') {
+          _p = findStringEnd(_p + 1) + 1;
+        } else if (c == '{' || c == '[') {
+          size_t depth = 0;
+          while (_p < _end) {
+            char current = *_p++;
+            if (current == '"') {
+              _p = findStringEnd(_p) + 1;
+            } else if (current == '{' || current == '[') {
+              ++depth;
+            } else if ((current == '}' || current == ']') && --depth == 0) {
+              return;
+            }
+          }
+          fail("unterminated container");
+        } else {
+          const char* start = _p;
+          while (_p < _end && *_p != ',' && *_p != '}' && *_p != ']' && !isWhitespace(*_p)) {
+            ++_p;
+          }
+          if (_p == start) {
+            fail("expected a value");
+          }
+        }
+      }
+
+      // True if the next value is an object whose first key is key.
+      // Nothing gets consumed either way.
+      bool objectStartsWith(std::string_view key) {
+        const char* saved = _p;
+        bool match = consume('{') && consume('"') && static_cast<size_t>(_end - _p) > key.size() &&
+                     std::memcmp(_p, key.data(), key.size()) == 0 && _p[key.size()] == '"';
+        _p = saved;
+        return match;
+      }
+
+      // skipValue, handing back the text it skipped
+      std::string_view rawValue() {
+        skipWhitespace();
+        const char* start = _p;
+        skipValue();
+        return std::string_view(start, _p - start);
+      }
+    };
+
+    /**
+     * The object a smart pointer member should be read into: whatever
+     * it already points at if that can be reused, otherwise a new one.
+     * readValue and json_stream.h's streaming reader both use it.
+     */
+
+    template <typename P>
+    typename P::element_type& reusePointee(P& value) {
+      using Element = typename P::element_type;
+      if constexpr (IsSharedPtr<P>) {
+        // Don't scribble over an object someone else is holding on to
+        if (!value || value.use_count() != 1) {
+          value = std::make_shared<Element>();
+        }
+      } else if (!value) {
+        value = std::make_unique<Element>();
+      }
+      return *value;
+    }
+
+    template <typename T>
+    void readRecord(JsonReader& in, T& obj);
+
+    template <typename V>
+    void readValue(JsonReader& in, V& value) {
+      if constexpr (std::same_as<V, bool>) {
+        if (in.consumeLiteral("true")) {
+          value = true;
+        } else if (in.consumeLiteral("false")) {
+          value = false;
+        } else {
+          in.fail("expected true or false");
+        }
+      } else if constexpr (std::is_enum_v<V>) {
+        std::underlying_type_t<V> underlying{};
+        in.readNumber(underlying);
+        value = static_cast<V>(underlying);
+      } else if constexpr (std::is_arithmetic_v<V>) {
+        in.readNumber(value);
+      } else if constexpr (IsString<V>) {
+        in.readString(value);
+      } else if constexpr (IsOptional<V>) {
+        if (in.consumeLiteral("null")) {
+          value.reset();
+          return;
+        }
+        if (in.objectStartsWith("nullopt")) {
+          // cereal's {"nullopt": false, "data": ...}
+          in.expect('{');
+          do {
+            std::string_view key = in.readKey();
+            in.expect(':');
+            if (key == "nullopt") {
+              bool empty = false;
+              readValue(in, empty);
+              if (empty) {
+                value.reset();
+              }
+            } else if (key == "data") {
+              if (!value.has_value()) {
+                value.emplace();
+              }
+              readValue(in, *value);
+            } else {
+              in.skipValue();
+            }
+          } while (in.consume(','));
+          in.expect('}');
+          return;
+        }
+        if (!value.has_value()) {
+          value.emplace();
+        }
+        readValue(in, *value);
+      } else if constexpr (IsSharedPtr<V> || IsUniquePtr<V>) {
+        if (in.consumeLiteral("null")) {
+          value.reset();
+          return;
+        }
+        readValue(in, reusePointee(value));
+      } else if constexpr (IsVector<V>) {
+        in.expect('[');
+        if constexpr (std::same_as<typename V::value_type, bool>) {
+          value.clear();
+          if (in.consume(']')) {
+            return;
+          }
+          do {
+            bool element = false;
+            readValue(in, element);
+            value.push_back(element);
+          } while (in.consume(','));
+        } else if (in.reuse() == JsonReuse::Reset) {
+          value.clear();
+          if (in.consume(']')) {
+            return;
+          }
+          do {
+            readValue(in, value.emplace_back());
+          } while (in.consume(','));
+        } else {
+          // Read over the elements that are already there, so their
+          // strings and vectors keep what they'd allocated, and only
+          // trim or grow the vector at the end
+          size_t count = 0;
+          if (in.consume(']')) {
+            value.clear();
+            return;
+          }
+          do {
+            if (count < value.size()) {
+              readValue(in, value[count]);
+            } else {
+              readValue(in, value.emplace_back());
+            }
+            ++count;
+          } while (in.consume(','));
+          value.resize(count);
+        }
+        in.expect(']');
+      } else if constexpr (IsLazy<V>) {
+        std::string_view text;
+        if (in.objectStartsWith("value0")) {
+          // cereal wraps the value in {"value0": ...}. Keep just the
+          // inside, which is what we'd have written ourselves
+          in.expect('{');
+          do {
+            std::string_view key = in.readKey();
+            in.expect(':');
+            if (key == "value0") {
+              text = in.rawValue();
+            } else {
+              in.skipValue();
+            }
+          } while (in.consume(','));
+          in.expect('}');
+        } else {
+          text = in.rawValue();
+        }
+        LazyAccess::beginEncoded(value, &decodeLazy<typename V::value_type>).assign(text);
+      } else if constexpr (IsStdArray<V>) {
+        in.expect('[');
+        for (size_t i = 0; i < value.size(); ++i) {
+          if (i > 0) {
+            in.expect(',');
+          }
+          readValue(in, value[i]);
+        }
+        in.expect(']');
+      } else if constexpr (IsRecord<V>) {
+        readRecord(in, value);
+      } else {
+        static_assert(false, "No native JSON support for this member type");
+      }
+    }
+
+    /**
+     * Name to loader table for a record, built once per type
+     */
+
+    template <typename T>
+    class RecordLoaders {
+    public:
+      struct Entry {
+        std::string_view name;
+        void (*load)(JsonReader&, T&);
+      };
+
+      static const RecordLoaders& instance() {
+        static const RecordLoaders loaders;
+        return loaders;
+      }
+
+      const std::vector<Entry>& entries() const {
+        return _entries;
+      }
+
+    private:
+      std::vector<Entry> _entries;
+
+      RecordLoaders() {
+        forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+          _entries.push_back({ClassSingleton<Owner>::instance().memberAtIndex(index), [](JsonReader& in, T& obj) {
+            constexpr auto info = member_info<Owner, index>();
+            readValue(in, member_ref<Owner, info>(obj));
+          }});
+        });
+      }
+    };
+
+    /**
+     * Index of the entry called key, or entries.size() if there isn't
+     * one. Keys almost always come in the order we write them, so the
+     * member after the last one we found gets checked before searching.
+     */
+
+    template <typename Entry>
+    size_t findEntry(const std::vector<Entry>& entries, std::string_view key, size_t expected) {
+      if (expected < entries.size() && entries[expected].name == key) {
+        return expected;
+      }
+      for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].name == key) {
+          return i;
+        }
+      }
+      return entries.size();
+    }
+
+    template <typename T>
+    void readRecord(JsonReader& in, T& obj) {
+      const auto& entries = RecordLoaders<T>::instance().entries();
+      in.expect('{');
+      if (in.consume('}')) {
+        return;
+      }
+      size_t expected = 0;
+      do {
+        std::string_view key = in.readKey();
+        in.expect(':');
+        size_t found = findEntry(entries, key, expected);
+        if (found < entries.size()) {
+          entries[found].load(in, obj);
+          expected = found + 1;
+        } else {
+          in.skipValue();
+        }
+      } while (in.consume(','));
+      in.expect('}');
+    }
+
+    /**
+     * Decoder for lazy members read by readValue. Their text is one
+     * whole JSON value.
+     */
+
+    template <typename T>
+    void decodeLazy(std::string_view encoded, T& value) {
+      JsonReader in(encoded);
+      readValue(in, value);
+      if (!in.atEnd()) {
+        in.fail("trailing characters after a lazy value");
+      }
+    }
+
+  }
+
+  /**
+   * Elements per slice for to_json_array. Each thread formats a whole
+   * slice into its own buffer at a time.
+   */
+
+  inline constexpr size_t JSON_ARRAY_SLICE_ELEMENTS = 8 * 1024;
+
+  /**
+   * Writes items as one compact JSON array, formatting slices of it on
+   * several threads. Slices go out a wave at a time, in order, with
+   * the commas between them put back, so the output is byte for byte
+   * what writing the whole thing on one thread gives you. Only one
+   * wave's worth of text is held in memory at once.
+   */
+
+  template <typename T>
+  void to_json_array(std::span<const T> items, std::ostream& stream, size_t threads = defaultThreadCount()) {
+    threads = std::max<size_t>(threads, 1);
+    size_t sliceCount = (items.size() + JSON_ARRAY_SLICE_ELEMENTS - 1) / JSON_ARRAY_SLICE_ELEMENTS;
+    // One buffer per slot in the wave, reused from wave to wave
+    std::vector<std::string> buffers(std::min(threads, sliceCount));
+
+    stream.put('[');
+    for (size_t first = 0; first < sliceCount; first += threads) {
+      size_t waveSize = std::min(threads, sliceCount - first);
+      parallelFor(waveSize, threads, [&](size_t w) {
+        size_t from = (first + w) * JSON_ARRAY_SLICE_ELEMENTS;
+        size_t to = std::min(items.size(), from + JSON_ARRAY_SLICE_ELEMENTS);
+        std::string& out = buffers[w];
+        out.clear();
+        for (size_t i = from; i < to; ++i) {
+          if (i > 0) {
+            out.push_back(',');
+          }
+          detail::json::writeValue(out, items[i]);
+        }
+      });
+      for (size_t w = 0; w < waveSize; ++w) {
+        stream.write(buffers[w].data(), static_cast<std::streamsize>(buffers[w].size()));
+      }
+    }
+    stream.put(']');
+  }
+
+  template <typename T>
+  void to_json_array(const std::vector<T>& items, std::ostream& stream, size_t threads = defaultThreadCount()) {
+    to_json_array(std::span<const T>(items), stream, threads);
+  }
+
+  /**
+   * String versions of to_json_array
+   */
+
+  template <typename T>
+  std::string to_json_array(std::span<const T> items, size_t threads = defaultThreadCount()) {
+    std::ostringstream stream;
+    to_json_array(items, stream, threads);
+    return std::move(stream).str();
+  }
+
+  template <typename T>
+  std::string to_json_array(const std::vector<T>& items, size_t threads = defaultThreadCount()) {
+    return to_json_array(std::span<const T>(items), threads);
+  }
+
+  /**
+   * Elements per unit of work for from_json_array. The pre-scan keeps
+   * where every one of these blocks starts, and threads steal whole
+   * blocks from each other.
+   */
+
+  inline constexpr size_t JSON_PARSE_BLOCK_ELEMENTS = 256;
+
+  /**
+   * Reads a top level JSON array into items, on several threads.
+   * items ends up the length of the array. By default whatever was in
+   * it is replaced. With JsonReuse::InPlace the elements that were
+   * already there are read over instead, so they keep their capacity,
+   * but a key missing from an element leaves its old value.
+   *
+   * A quick structural pass finds the elements first -- it only looks
+   * at brackets, commas and where strings end -- which tells us how
+   * big to make items and where each block of elements starts. The
+   * blocks then get parsed straight into their slots in items by a
+   * work stealing pool, so a run of unusually big records doesn't
+   * leave everybody else waiting on one thread.
+   *
+   * Takes either a bare array, like to_json_array writes, or the array
+   * wrapped in cereal's {"value0": [...]}. Elements are read with the
+   * native reader in this header. It takes both its own layout for
+   * optionals and lazy members and the ones to_json writes, so
+   * to_json's output reads back fine as long as there are no smart
+   * pointers in it. Those have to be null or the bare pointee, not
+   * cereal's ptr_wrapper.
+   */
+
+  template <typename T>
+  void from_json_array(std::vector<T>& items, std::string_view json, size_t threads = defaultThreadCount(),
+                       JsonReuse reuse = JsonReuse::Reset) {
+    using detail::json::JsonReader;
+    JsonReader scan(json);
+    bool wrapped = scan.consume('{');
+    if (wrapped) {
+      scan.readKey();
+      scan.expect(':');
+    }
+
+    // Pre-scan. The block list is kept per thread so that decoding
+    // into the same vector again doesn't allocate.
+    thread_local std::vector<size_t> blockStarts;
+    blockStarts.clear();
+    size_t count = 0;
+    scan.expect('[');
+    if (!scan.consume(']')) {
+      do {
+        scan.skipWhitespace();
+        if (count % JSON_PARSE_BLOCK_ELEMENTS == 0) {
+          blockStarts.push_back(scan.position());
+        }
+        ++count;
+        scan.skipValue();
+      } while (scan.consume(','));
+      scan.skipWhitespace();
+      blockStarts.push_back(scan.position());
+      scan.expect(']');
+    }
+
+    if (wrapped) {
+      // cereal only ever writes the one member, but be forgiving
+      while (scan.consume(',')) {
+        scan.readKey();
+        scan.expect(':');
+        scan.skipValue();
+      }
+      scan.expect('}');
+    }
+    if (!scan.atEnd()) {
+      scan.fail("trailing characters after the array");
+    }
+
+    if (reuse == JsonReuse::Reset) {
+      items.clear();
+    }
+    items.resize(count);
+    size_t blocks = blockStarts.empty() ? 0 : blockStarts.size() - 1;
+
+    // The workers have thread_locals of their own, so they need a
+    // reference to this thread's list
+    const std::vector<size_t>& starts = blockStarts;
+    parallelForStealing(blocks, threads, [&](size_t block) {
+      // Everything from this block's first element up to the next
+      // block's first element (or the closing bracket)
+      std::string_view text = json.substr(starts[block], starts[block + 1] - starts[block]);
+      JsonReader in(text, reuse);
+      size_t first = block * JSON_PARSE_BLOCK_ELEMENTS;
+      size_t last = std::min(count, first + JSON_PARSE_BLOCK_ELEMENTS);
+      for (size_t i = first; i < last; ++i) {
+        if (i > first) {
+          in.expect(',');
+        }
+        detail::json::readValue(in, items[i]);
+      }
+      if (last < count) {
+        in.expect(',');
+      }
+      if (!in.atEnd()) {
+        in.fail("unexpected characters between array elements");
+      }
+    });
+  }
+
+  /**
+   * Stream version of from_json_array. Reads the whole stream first
+   * so the parse can be split up.
+   */
+
+  template <typename T, typename Stream>
+  requires IsInputStream<Stream>
+  void from_json_array(std::vector<T>& items, Stream& stream, size_t threads = defaultThreadCount(),
+                       JsonReuse reuse = JsonReuse::Reset) {
+    std::string data = detail::readAll(stream);
+    from_json_array(items, std::string_view(data), threads, reuse);
+  }
+
+}
@@ -0,0 +1,215 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * Projection loads: read just the members you ask for out of a JSON
+ * object and don't decode anything else.
+ *
+ * If all you want out of a big message is a couple of header fields,
+ * a full from_json builds every string and vector in it just so you
+ * can look at two ints. These use the native pull parser from json.h
+ * instead. The members you picked get read into the object as usual.
+ * Everything else gets jumped over with JsonReader::skipValue, which
+ * only looks for quotes and brackets, and once the last member you
+ * asked for has turned up we stop reading altogether. A routing
+ * header near the front of a megabyte of payload costs you about the
+ * header.
+ *
+ * Pick the members at compile time with member pointers:
+ *
+ *   fr::autocereal::from_json<Message, &Message::route, &Message::priority>(message, json);
+ *
+ * or at runtime by name with a json_projection, which you can build
+ * once and keep:
+ *
+ *   fr::autocereal::json_projection<Message> header{"route", "priority"};
+ *   fr::autocereal::from_json(message, json, header);
+ *
+ * Members you didn't pick are left exactly as they were. Since we
+ * stop early, anything wrong with the text after the last member we
+ * wanted won't be noticed. Takes the bare object json.h writes or
+ * to_json's {"value0": {...}}. The members you pick are read with the
+ * native reader, which takes anything to_json writes except smart
+ * pointers in cereal's ptr_wrapper.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/json.h>
+#include <fr/autocereal/traits.h>
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace fr::autocereal {
+
+  namespace detail::json {
+
+    /**
+     * Where Member sits among T's members, parents first, the same
+     * order RecordLoaders uses. flatMemberCount<T>() if it isn't one
+     * of them (or it's marked skip or transient).
+     */
+
+    template <typename T, auto Member>
+    consteval size_t projectedIndex() {
+      size_t found = flatMemberCount<T>();
+      size_t position = 0;
+      forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+        constexpr auto info = member_info<Owner, index>();
+        if constexpr (std::is_same_v<decltype(Member), decltype(&[:info:])>) {
+          if (Member == &[:info:]) {
+            found = position;
+          }
+        }
+        ++position;
+      });
+      return found;
+    }
+
+    template <typename T, auto... Members>
+    consteval std::array<uint8_t, flatMemberCount<T>()> projectionMask() {
+      std::array<uint8_t, flatMemberCount<T>()> mask{};
+      ((mask[projectedIndex<T, Members>()] = 1), ...);
+      return mask;
+    }
+
+    constexpr size_t projectionCount(std::span<const uint8_t> wanted) {
+      size_t count = 0;
+      for (uint8_t flag : wanted) {
+        count += flag;
+      }
+      return count;
+    }
+
+    /**
+     * Reads the members flagged in wanted and skips the rest, returning
+     * as soon as the last one wanted has been read. If the object turns
+     * out to be cereal's wrapper we go in after the object inside it.
+     */
+
+    template <typename T>
+    void readProjected(JsonReader& in, T& obj, std::span<const uint8_t> wanted, size_t wantedCount, bool unwrap) {
+      const auto& entries = RecordLoaders<T>::instance().entries();
+      in.expect('{');
+      if (wantedCount == 0 || in.consume('}')) {
+        return;
+      }
+      // A key that shows up twice only gets read the first time, so it
+      // can't be counted twice
+      std::array<uint8_t, flatMemberCount<T>()> seen{};
+      size_t remaining = wantedCount;
+      size_t expected = 0;
+      bool first = true;
+      do {
+        std::string_view key = in.readKey();
+        in.expect(':');
+        size_t found = findEntry(entries, key, expected);
+        if (first && unwrap && found == entries.size() && key == "value0" && in.peek() == '{') {
+          readProjected(in, obj, wanted, wantedCount, false);
+          return;
+        }
+        first = false;
+        if (found < entries.size() && wanted[found] && !seen[found]) {
+          entries[found].load(in, obj);
+          seen[found] = 1;
+          if (--remaining == 0) {
+            return;
+          }
+        } else {
+          in.skipValue();
+        }
+        if (found < entries.size()) {
+          expected = found + 1;
+        }
+      } while (in.consume(','));
+      in.expect('}');
+    }
+
+  }
+
+  /**
+   * A set of T's members, picked by name at runtime, for from_json
+   * to read. Names are checked when you build it and an unknown one
+   * throws a cereal::Exception.
+   */
+
+  template <typename T>
+  class json_projection {
+    std::vector<uint8_t> _wanted;
+    size_t _count = 0;
+
+  public:
+    explicit json_projection(std::span<const std::string_view> fields) {
+      const auto& entries = detail::json::RecordLoaders<T>::instance().entries();
+      _wanted.resize(entries.size());
+      for (std::string_view field : fields) {
+        size_t found = detail::json::findEntry(entries, field, 0);
+        if (found == entries.size()) {
+          throw cereal::Exception("Can't project " + std::string(field) + ", there's no serialized member by that name");
+        }
+        if (!_wanted[found]) {
+          _wanted[found] = 1;
+          ++_count;
+        }
+      }
+    }
+
+    json_projection(std::initializer_list<std::string_view> fields)
+      : json_projection(std::span<const std::string_view>(fields.begin(), fields.size())) {}
+
+    std::span<const uint8_t> wanted() const {
+      return _wanted;
+    }
+
+    size_t count() const {
+      return _count;
+    }
+  };
+
+  /**
+   * Reads only the listed members of T out of json
+   */
+
+  template <typename T, auto... Members>
+  requires (sizeof...(Members) > 0)
+  void from_json(T& obj, std::string_view json) {
+    static_assert(((detail::json::projectedIndex<T, Members>() < flatMemberCount<T>()) && ...),
+                  "Projected members have to be serialized members of T or its parents");
+    static constexpr auto mask = detail::json::projectionMask<T, Members...>();
+    static constexpr size_t count = detail::json::projectionCount(mask);
+    detail::json::JsonReader in(json);
+    detail::json::readProjected(in, obj, mask, count, true);
+  }
+
+  /**
+   * Reads only the members in projection out of json
+   */
+
+  template <typename T>
+  void from_json(T& obj, std::string_view json, const json_projection<T>& projection) {
+    detail::json::JsonReader in(json);
+    detail::json::readProjected(in, obj, projection.wanted(), projection.count(), true);
+  }
+
+}
@@ -0,0 +1,812 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * Incremental JSON input. You hand json_stream_reader bytes as they
+ * turn up, in chunks of whatever size, and it fills in the object as
+ * it goes:
+ *
+ *   Message message;
+ *   fr::autocereal::json_stream_reader<Message> reader(message);
+ *   while (auto chunk = pipe.read()) {
+ *     reader.feed(chunk);
+ *   }
+ *   reader.finish();
+ *
+ * There's no DOM anywhere. The tokenizer emits SAX style events and a
+ * stack of frames, one per open object or array, routes each one to
+ * the member it belongs to. The only things kept between chunks are
+ * that stack and whatever token got split across the end of a chunk,
+ * so memory follows how deeply the document nests rather than how big
+ * it is.
+ *
+ * JsonLayout::Cereal reads what to_json writes: the object wrapped in
+ * {"value0": ...}, and smart pointers in cereal's ptr_wrapper objects.
+ * JsonLayout::Native reads what json.h and ndjson.h write: a bare
+ * object, with pointers and optionals as null or their value.
+ * Members are matched by name either way, and keys we don't know get
+ * skipped.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/json.h>
+#include <fr/autocereal/traits.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fr::autocereal {
+
+  enum class JsonLayout {
+    Cereal,
+    Native
+  };
+
+  /**
+   * Chunk size from_json_stream reads with
+   */
+
+  inline constexpr size_t JSON_STREAM_BUFFER_BYTES = 64 * 1024;
+
+  namespace detail::json {
+
+    class SaxParser;
+
+    enum class SaxToken {
+      Null,
+      True,
+      False,
+      Number,
+      String
+    };
+
+    struct SaxOps;
+
+    /**
+     * Where the next value goes. A null ops means skip it.
+     */
+
+    struct SaxSlot {
+      const SaxOps* ops = nullptr;
+      void* target = nullptr;
+    };
+
+    /**
+     * One open object or array we're filling in
+     */
+
+    struct SaxFrame {
+      const SaxOps* ops = nullptr;
+      void* target = nullptr;
+      size_t count = 0;
+    };
+
+    /**
+     * What to do with events for one type. scalar takes a finished
+     * scalar (strings still quoted and escaped, see decodeString),
+     * open starts an object or array, child says where the next
+     * member or element goes and close finishes up.
+     */
+
+    struct SaxOps {
+      void (*scalar)(SaxParser&, void* target, SaxToken token, std::string_view text);
+      void (*open)(SaxParser&, void* target, bool object, SaxFrame& frame);
+      SaxSlot (*child)(SaxParser&, SaxFrame& frame, std::string_view key);
+      void (*close)(SaxParser&, SaxFrame& frame);
+    };
+
+    class SaxParser {
+      enum class State {
+        Value,
+        AfterValue,
+        Key,
+        Colon,
+        String,
+        Bare,
+        Done
+      };
+
+      SaxSlot _root;
+      JsonLayout _layout;
+      State _state = State::Value;
+      // '{' and '[' for every open container, skipped ones included
+      std::vector<char> _containers;
+      // Frames for the containers we're actually filling in
+      std::vector<SaxFrame> _frames;
+      // How many of the innermost containers are being skipped
+      size_t _skipDepth = 0;
+      // Set when the value we're in the middle of gets skipped
+      bool _skipThis = false;
+      // A '}' or ']' is fine here because the container just opened
+      bool _allowClose = false;
+      bool _stringIsKey = false;
+      bool _escaped = false;
+      SaxSlot _current;
+      SaxSlot _keySlot;
+      // The string or bare token we're in the middle of
+      std::string _token;
+      // Bytes fed before the current chunk, and where we are in it
+      size_t _offset = 0;
+      const char* _chunk = nullptr;
+      const char* _chunkEnd = nullptr;
+      const char* _p = nullptr;
+      std::unordered_map<uint32_t, std::shared_ptr<void>> _sharedPointers;
+
+      static bool isWhitespace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+      }
+
+      static bool isBareChar(char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+          || c == '-' || c == '+' || c == '.';
+      }
+
+      void beginValue() {
+        _allowClose = false;
+        SaxSlot slot;
+        if (_skipDepth > 0) {
+          _skipThis = true;
+          return;
+        }
+        if (_containers.empty()) {
+          slot = _root;
+        } else if (_containers.back() == '[') {
+          auto& frame = _frames.back();
+          slot = frame.ops->child(*this, frame, {});
+        } else {
+          slot = _keySlot;
+        }
+        _current = slot;
+        _skipThis = slot.ops == nullptr;
+      }
+
+      void valueDone() {
+        _state = _containers.empty() ? State::Done : State::AfterValue;
+      }
+
+      void openContainer(bool object) {
+        _containers.push_back(object ? '{' : '[');
+        if (_skipThis) {
+          ++_skipDepth;
+        } else {
+          SaxFrame frame;
+          _current.ops->open(*this, _current.target, object, frame);
+          _frames.push_back(frame);
+        }
+        _state = object ? State::Key : State::Value;
+        _allowClose = true;
+      }
+
+      void closeContainer(char close) {
+        if (_containers.empty() || _containers.back() != (close == '}' ? '{' : '[')) {
+          fail("mismatched close");
+        }
+        _containers.pop_back();
+        if (_skipDepth > 0) {
+          --_skipDepth;
+        } else {
+          auto& frame = _frames.back();
+          frame.ops->close(*this, frame);
+          _frames.pop_back();
+        }
+        _allowClose = false;
+        valueDone();
+      }
+
+      void completeScalar(SaxToken token, std::string_view text) {
+        if (!_skipThis) {
+          _current.ops->scalar(*this, _current.target, token, text);
+        }
+        valueDone();
+      }
+
+      void finishBare() {
+        SaxToken token = SaxToken::Number;
+        if (_token == "null") {
+          token = SaxToken::Null;
+        } else if (_token == "true") {
+          token = SaxToken::True;
+        } else if (_token == "false") {
+          token = SaxToken::False;
+        }
+        completeScalar(token, _token);
+      }
+
+      void finishString() {
+        if (!_stringIsKey) {
+          completeScalar(SaxToken::String, _token);
+          return;
+        }
+        _state = State::Colon;
+        if (_skipDepth == 0) {
+          JsonReader in(_token);
+          auto& frame = _frames.back();
+          _keySlot = frame.ops->child(*this, frame, in.readKey());
+        }
+      }
+
+      void scanString() {
+        while (_p < _chunkEnd) {
+          if (_escaped) {
+            // The character after a backslash never ends the string
+            _token.push_back(*_p++);
+            _escaped = false;
+            continue;
+          }
+          const char* end = _p;
+          while (end < _chunkEnd && *end != '"' && *end != '\\') {
+            ++end;
+          }
+          _token.append(_p, end);
+          _p = end;
+          if (_p == _chunkEnd) {
+            return;
+          }
+          char c = *_p++;
+          _token.push_back(c);
+          if (c == '\\') {
+            _escaped = true;
+            continue;
+          }
+          finishString();
+          return;
+        }
+      }
+
+      void scanBare() {
+        const char* start = _p;
+        while (_p < _chunkEnd && isBareChar(*_p)) {
+          ++_p;
+        }
+        _token.append(start, _p);
+        if (_p < _chunkEnd) {
+          finishBare();
+        }
+      }
+
+      void structural(char c) {
+        switch (_state) {
+        case State::Value:
+          if (c == '{' || c == '[') {
+            beginValue();
+            openContainer(c == '{');
+          } else if (c == ']' && _allowClose) {
+            closeContainer(c);
+          } else if (c == '"') {
+            beginValue();
+            _token.assign(1, '"');
+            _stringIsKey = false;
+            _state = State::String;
+          } else if (isBareChar(c)) {
+            beginValue();
+            _token.clear();
+            _state = State::Bare;
+            // scanBare picks this character up
+            return;
+          } else {
+            fail("expected a value");
+          }
+          break;
+        case State::AfterValue:
+          if (c == ',') {
+            _state = _containers.back() == '{' ? State::Key : State::Value;
+          } else if (c == '}' || c == ']') {
+            closeContainer(c);
+          } else {
+            fail("expected ',' or a close");
+          }
+          break;
+        case State::Key:
+          if (c == '"') {
+            _token.assign(1, '"');
+            _stringIsKey = true;
+            _state = State::String;
+          } else if (c == '}' && _allowClose) {
+            closeContainer(c);
+          } else {
+            fail("expected a key");
+          }
+          break;
+        case State::Colon:
+          if (c != ':') {
+            fail("expected ':'");
+          }
+          _state = State::Value;
+          break;
+        case State::Done:
+          fail("trailing characters after the document");
+        default:
+          break;
+        }
+        ++_p;
+      }
+
+    public:
+      SaxParser(SaxSlot root, JsonLayout layout) : _root(root), _layout(layout) {}
+
+      [[noreturn]] void fail(const char* what) const {
+        throw cereal::Exception(std::string("JSON parse error at offset ") + std::to_string(_offset + (_p - _chunk)) + ": " + what);
+      }
+
+      JsonLayout layout() const {
+        return _layout;
+      }
+
+      std::unordered_map<uint32_t, std::shared_ptr<void>>& sharedPointers() {
+        return _sharedPointers;
+      }
+
+      /**
+       * Unescapes a string token, quotes and all, into any
+       * std::basic_string<char>
+       */
+
+      template <typename String>
+      void decodeString(std::string_view raw, String& out) const {
+        JsonReader in(raw);
+        in.readString(out);
+      }
+
+      void feed(std::span<const char> chunk) {
+        _chunk = chunk.data();
+        _p = _chunk;
+        _chunkEnd = _chunk + chunk.size();
+        while (_p < _chunkEnd) {
+          if (_state == State::String) {
+            scanString();
+          } else if (_state == State::Bare) {
+            scanBare();
+          } else if (isWhitespace(*_p)) {
+            ++_p;
+          } else {
+            structural(*_p);
+          }
+        }
+        _offset += chunk.size();
+        _chunk = _p = _chunkEnd = nullptr;
+      }
+
+      bool done() const {
+        return _state == State::Done;
+      }
+
+      /**
+       * Call once there's no more input. A number at the very end of
+       * the document has nothing after it to say it's finished, so
+       * this finishes it.
+       */
+
+      void finish() {
+        if (_state == State::Bare) {
+          finishBare();
+        }
+        if (_state != State::Done) {
+          fail("unexpected end of document");
+        }
+      }
+    };
+
+    template <typename V>
+    struct SaxType;
+
+    template <typename V>
+    inline constexpr SaxOps saxOps{&SaxType<V>::scalar, &SaxType<V>::open, &SaxType<V>::child, &SaxType<V>::close};
+
+    template <typename V>
+    SaxSlot saxSlot(V& value) {
+      return {&saxOps<V>, &value};
+    }
+
+    /**
+     * Defaults for everything. Scalars don't open, containers don't
+     * take scalars.
+     */
+
+    struct SaxDefaults {
+      static void scalar(SaxParser& in, void*, SaxToken, std::string_view) {
+        in.fail("expected an object or array");
+      }
+
+      static void open(SaxParser& in, void*, bool, SaxFrame&) {
+        in.fail("unexpected object or array");
+      }
+
+      static SaxSlot child(SaxParser&, SaxFrame&, std::string_view) {
+        return {};
+      }
+
+      static void close(SaxParser&, SaxFrame&) {}
+    };
+
+    template <typename N>
+    void parseSaxNumber(SaxParser& in, SaxToken token, std::string_view text, N& value) {
+      if constexpr (std::is_floating_point_v<N>) {
+        if (token == SaxToken::Null) {
+          value = std::numeric_limits<N>::quiet_NaN();
+          return;
+        }
+      }
+      if (token != SaxToken::Number) {
+        in.fail("expected a number");
+      }
+      auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+      if (result.ec != std::errc{} || result.ptr != text.data() + text.size()) {
+        in.fail("bad number");
+      }
+    }
+
+    template <typename T>
+    class SaxRecordTable {
+    public:
+      struct Entry {
+        std::string_view name;
+        SaxSlot (*slot)(T&);
+      };
+
+      static const SaxRecordTable& instance() {
+        static const SaxRecordTable table;
+        return table;
+      }
+
+      const std::vector<Entry>& entries() const {
+        return _entries;
+      }
+
+    private:
+      std::vector<Entry> _entries;
+
+      SaxRecordTable() {
+        forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+          _entries.push_back({ClassSingleton<Owner>::instance().memberAtIndex(index), [](T& obj) {
+            constexpr auto info = member_info<Owner, index>();
+            return saxSlot(member_ref<Owner, info>(obj));
+          }});
+        });
+      }
+    };
+
+    template <typename V>
+    struct SaxType : SaxDefaults {
+      static void scalar(SaxParser& in, void* target, SaxToken token, std::string_view text) {
+        V& value = *static_cast<V*>(target);
+        if constexpr (std::same_as<V, bool>) {
+          if (token != SaxToken::True && token != SaxToken::False) {
+            in.fail("expected true or false");
+          }
+          value = token == SaxToken::True;
+        } else if constexpr (std::is_enum_v<V>) {
+          std::underlying_type_t<V> underlying{};
+          parseSaxNumber(in, token, text, underlying);
+          value = static_cast<V>(underlying);
+        } else if constexpr (std::is_arithmetic_v<V>) {
+          parseSaxNumber(in, token, text, value);
+        } else if constexpr (IsString<V>) {
+          if (token != SaxToken::String) {
+            in.fail("expected a string");
+          }
+          in.decodeString(text, value);
+        } else if constexpr (IsOptional<V>) {
+          if (token == SaxToken::Null) {
+            value.reset();
+          } else if (in.layout() == JsonLayout::Cereal) {
+            in.fail("expected cereal's optional object");
+          } else {
+            SaxType<typename V::value_type>::scalar(in, &value.emplace(), token, text);
+          }
+        } else if constexpr (IsLazy<V>) {
+          // The streaming reader never has the whole value's text to
+          // hold on to, so lazy members get decoded as they arrive
+          if (in.layout() == JsonLayout::Cereal) {
+            in.fail("expected an object holding value0");
+          }
+          SaxType<typename V::value_type>::scalar(in, &LazyAccess::beginDecoded(value), token, text);
+        } else if constexpr (IsSharedPtr<V> || IsUniquePtr<V>) {
+          if (token == SaxToken::Null) {
+            value.reset();
+          } else if (in.layout() == JsonLayout::Cereal) {
+            in.fail("expected cereal's ptr_wrapper object");
+          } else {
+            SaxType<typename V::element_type>::scalar(in, allocate(value), token, text);
+          }
+        } else {
+          SaxDefaults::scalar(in, target, token, text);
+        }
+      }
+
+      static void open(SaxParser& in, void* target, bool object, SaxFrame& frame) {
+        V& value = *static_cast<V*>(target);
+        frame = {&saxOps<V>, target, 0};
+        if constexpr (IsVector<V>) {
+          if (object) {
+            in.fail("expected an array");
+          }
+          value.clear();
+        } else if constexpr (IsStdArray<V>) {
+          if (object) {
+            in.fail("expected an array");
+          }
+        } else if constexpr (IsOptional<V>) {
+          if (in.layout() == JsonLayout::Cereal) {
+            // {"nullopt": bool, "data": value}
+            if (!object) {
+              in.fail("expected cereal's optional object");
+            }
+            value.reset();
+          } else {
+            SaxType<typename V::value_type>::open(in, &value.emplace(), object, frame);
+          }
+        } else if constexpr (IsLazy<V>) {
+          if (in.layout() == JsonLayout::Cereal) {
+            // {"value0": value}
+            if (!object) {
+              in.fail("expected an object holding value0");
+            }
+          } else {
+            SaxType<typename V::value_type>::open(in, &LazyAccess::beginDecoded(value), object, frame);
+          }
+        } else if constexpr (IsSharedPtr<V> || IsUniquePtr<V>) {
+          if (in.layout() == JsonLayout::Cereal) {
+            // {"ptr_wrapper": {...}}
+            if (!object) {
+              in.fail("expected cereal's ptr_wrapper object");
+            }
+          } else {
+            SaxType<typename V::element_type>::open(in, allocate(value), object, frame);
+          }
+        } else if constexpr (IsRecord<V>) {
+          if (!object) {
+            in.fail("expected an object");
+          }
+        } else {
+          SaxDefaults::open(in, target, object, frame);
+        }
+      }
+
+      static SaxSlot child(SaxParser& in, SaxFrame& frame, std::string_view key) {
+        V& value = *static_cast<V*>(frame.target);
+        if constexpr (IsVector<V>) {
+          if constexpr (std::same_as<typename V::value_type, bool>) {
+            return {&vectorBoolOps, &value};
+          } else {
+            return saxSlot(value.emplace_back());
+          }
+        } else if constexpr (IsStdArray<V>) {
+          if (frame.count == value.size()) {
+            in.fail("too many elements for std::array");
+          }
+          return saxSlot(value[frame.count++]);
+        } else if constexpr (IsOptional<V>) {
+          if (key == "data") {
+            return saxSlot(value.emplace());
+          }
+          return {};
+        } else if constexpr (IsLazy<V>) {
+          if (key == "value0") {
+            return saxSlot(LazyAccess::beginDecoded(value));
+          }
+          return {};
+        } else if constexpr (IsSharedPtr<V> || IsUniquePtr<V>) {
+          if (key == "ptr_wrapper") {
+            return {&ptrWrapperOps, &value};
+          }
+          return {};
+        } else if constexpr (IsRecord<V>) {
+          const auto& entries = SaxRecordTable<V>::instance().entries();
+          // Keys almost always come in order, so try the next one first
+          if (frame.count < entries.size() && entries[frame.count].name == key) {
+            return entries[frame.count++].slot(value);
+          }
+          for (size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].name == key) {
+              frame.count = i + 1;
+              return entries[i].slot(value);
+            }
+          }
+          return {};
+        } else {
+          return SaxDefaults::child(in, frame, key);
+        }
+      }
+
+      static void close(SaxParser& in, SaxFrame& frame) {
+        if constexpr (IsStdArray<V>) {
+          if (frame.count != static_cast<V*>(frame.target)->size()) {
+            in.fail("too few elements for std::array");
+          }
+        }
+      }
+
+    private:
+      template <typename P>
+      static void* allocate(P& value) {
+        return &reusePointee(value);
+      }
+
+      /**
+       * std::vector<bool> has no element to point at, so its elements
+       * get appended straight onto the vector
+       */
+
+      static void appendBool(SaxParser& in, void* target, SaxToken token, std::string_view) {
+        if (token != SaxToken::True && token != SaxToken::False) {
+          in.fail("expected true or false");
+        }
+        static_cast<std::vector<bool>*>(target)->push_back(token == SaxToken::True);
+      }
+
+      static constexpr SaxOps vectorBoolOps{&appendBool, &SaxDefaults::open, &SaxDefaults::child, &SaxDefaults::close};
+
+      /**
+       * Inside cereal's ptr_wrapper: {"id": n, "data": ...} for
+       * shared_ptr, {"valid": 0 or 1, "data": ...} for unique_ptr
+       */
+
+      static void openPtrWrapper(SaxParser& in, void* target, bool object, SaxFrame& frame) {
+        if (!object) {
+          in.fail("expected a ptr_wrapper object");
+        }
+        static_cast<V*>(target)->reset();
+        frame = {&ptrWrapperOps, target, 0};
+      }
+
+      static SaxSlot ptrWrapperChild(SaxParser& in, SaxFrame& frame, std::string_view key) {
+        if constexpr (IsSharedPtr<V> || IsUniquePtr<V>) {
+          V& value = *static_cast<V*>(frame.target);
+          if (key == "data") {
+            if (!value) {
+              in.fail("ptr_wrapper data for a null pointer");
+            }
+            return saxSlot(*value);
+          }
+          if (key == "id" || key == "valid") {
+            return {&pointerIdOps, &value};
+          }
+        }
+        return {};
+      }
+
+      static void pointerId(SaxParser& in, void* target, SaxToken token, std::string_view text) {
+        if constexpr (IsSharedPtr<V>) {
+          V& value = *static_cast<V*>(target);
+          uint32_t id = 0;
+          parseSaxNumber(in, token, text, id);
+          // 0 is null, the high bit marks the first time cereal saw a
+          // pointer (the one with the data), anything else points back
+          // at one we've already read
+          constexpr uint32_t firstTime = 0x80000000;
+          auto& pointers = in.sharedPointers();
+          if (id & firstTime) {
+            value = std::make_shared<typename V::element_type>();
+            pointers[id & ~firstTime] = value;
+          } else if (id != 0) {
+            auto found = pointers.find(id);
+            if (found == pointers.end()) {
+              in.fail("shared pointer id we haven't seen");
+            }
+            value = std::static_pointer_cast<typename V::element_type>(found->second);
+          }
+        } else if constexpr (IsUniquePtr<V>) {
+          uint32_t valid = 0;
+          parseSaxNumber(in, token, text, valid);
+          if (valid) {
+            *static_cast<V*>(target) = std::make_unique<typename V::element_type>();
+          }
+        }
+      }
+
+      static constexpr SaxOps ptrWrapperOps{&SaxDefaults::scalar, &openPtrWrapper, &ptrWrapperChild, &SaxDefaults::close};
+      static constexpr SaxOps pointerIdOps{&pointerId, &SaxDefaults::open, &SaxDefaults::child, &SaxDefaults::close};
+    };
+
+    /**
+     * cereal wraps the whole thing in an object, {"value0": ...}. The
+     * first member is ours and anything after it is skipped.
+     */
+
+    template <typename T>
+    struct SaxCerealRoot : SaxDefaults {
+      static void open(SaxParser& in, void* target, bool object, SaxFrame& frame) {
+        if (!object) {
+          in.fail("expected cereal's outer object");
+        }
+        frame = {&ops, target, 0};
+      }
+
+      static SaxSlot child(SaxParser&, SaxFrame& frame, std::string_view) {
+        if (frame.count++ == 0) {
+          return saxSlot(*static_cast<T*>(frame.target));
+        }
+        return {};
+      }
+
+      static constexpr SaxOps ops{&SaxDefaults::scalar, &open, &child, &SaxDefaults::close};
+    };
+
+  }
+
+  /**
+   * Fills obj in from JSON handed over a chunk at a time. obj needs
+   * to stay put until you're done feeding.
+   */
+
+  template <typename T>
+  class json_stream_reader {
+    detail::json::SaxParser _parser;
+
+    static detail::json::SaxSlot rootSlot(T& obj, JsonLayout layout) {
+      if (layout == JsonLayout::Cereal) {
+        return {&detail::json::SaxCerealRoot<T>::ops, &obj};
+      }
+      return detail::json::saxSlot(obj);
+    }
+
+  public:
+    explicit json_stream_reader(T& obj, JsonLayout layout = JsonLayout::Cereal)
+      : _parser(rootSlot(obj, layout), layout) {}
+
+    json_stream_reader(const json_stream_reader&) = delete;
+    json_stream_reader& operator=(const json_stream_reader&) = delete;
+
+    void feed(std::span<const char> chunk) {
+      _parser.feed(chunk);
+    }
+
+    /**
+     * True once the whole document has gone past
+     */
+
+    bool done() const {
+      return _parser.done();
+    }
+
+    /**
+     * Throws if the document isn't complete
+     */
+
+    void finish() {
+      _parser.finish();
+    }
+  };
+
+  /**
+   * Reads a stream through json_stream_reader a chunk at a time
+   */
+
+  template <typename T, typename Stream>
+  requires IsInputStream<Stream>
+  void from_json_stream(T& obj, Stream& stream, JsonLayout layout = JsonLayout::Cereal,
+                        size_t bufferSize = JSON_STREAM_BUFFER_BYTES) {
+    json_stream_reader<T> reader(obj, layout);
+    std::vector<char> buffer(std::max<size_t>(bufferSize, 1));
+    while (stream) {
+      stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      reader.feed(std::span<const char>(buffer.data(), static_cast<size_t>(stream.gcount())));
+    }
+    reader.finish();
+  }
+
+}
@@ -0,0 +1,250 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * lazy<T> is a member wrapper that puts off decoding its value until
+ * somebody actually looks at it.
+ *
+ *   struct Message {
+ *     Header header;
+ *     fr::autocereal::lazy<Attachments> attachments;
+ *   };
+ *
+ * Loading a Message copies the bytes of attachments out of the input
+ * without decoding any of them. The first get(), * or -> decodes them
+ * into the T the wrapper holds. If nobody asks, nobody pays for it,
+ * apart from a memcpy.
+ *
+ * In cereal's binary archives a lazy<T> is written as a size tag
+ * followed by T serialized on its own, so a load can find the end of
+ * it without reading what's inside. That makes it a different layout
+ * than a plain T, so don't swap one for the other in data you've
+ * already written. In the native JSON reader in json.h it's written
+ * exactly the way a T would be, and the reader uses skipValue to find
+ * the end of its text. cereal's JSON and XML archives are DOMs that
+ * have already parsed everything by the time we see it, so those just
+ * save and load the T straight away, under "value0". The streaming
+ * readers in json_stream.h and xml.h never have all of a value's
+ * text at once, so they decode lazy members as they go too.
+ *
+ * If you save a lazy that's never been decoded into the same format
+ * it came from, the bytes it's holding get written straight back out,
+ * so passing a message through doesn't decode its lazy parts at all.
+ * Getting at the value through a non-const reference throws those
+ * bytes away, since you might be changing it, and it'll be encoded
+ * afresh the next time it's saved.
+ *
+ * The decode happens on whatever thread gets to it first, outside the
+ * load, so a LoadResourceScope or SharedPoolScope from the load isn't
+ * in effect any more. lazy isn't thread safe: two threads doing the
+ * first get() at once will both decode into the same object. Decode
+ * it before you share it if that's going to happen.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/traits.h>
+
+#include <concepts>
+#include <span>
+#include <spanstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace fr::autocereal {
+
+  namespace detail {
+    struct LazyAccess;
+  }
+
+  template <typename T>
+  class lazy {
+    friend struct detail::LazyAccess;
+
+  public:
+    using value_type = T;
+    // Decodes bytes written in some particular format into value
+    using Decoder = void (*)(std::string_view encoded, T& value);
+
+  private:
+    mutable T _value{};
+    // The undecoded bytes, and how to decode them. _decoder is null if
+    // we aren't holding any bytes, or they're out of date.
+    std::string _encoded;
+    Decoder _decoder = nullptr;
+    mutable bool _decoded = true;
+
+    void decode() const {
+      if (!_decoded) {
+        _decoder(_encoded, _value);
+        _decoded = true;
+      }
+    }
+
+  public:
+    lazy() = default;
+
+    lazy(T value) : _value(std::move(value)) {}
+
+    lazy& operator=(T value) {
+      _value = std::move(value);
+      _decoder = nullptr;
+      _decoded = true;
+      return *this;
+    }
+
+    /**
+     * False if we're still sitting on bytes nobody's decoded yet
+     */
+
+    bool decoded() const {
+      return _decoded;
+    }
+
+    const T& get() const {
+      decode();
+      return _value;
+    }
+
+    T& get() {
+      decode();
+      _decoder = nullptr;
+      return _value;
+    }
+
+    const T& operator*() const {
+      return get();
+    }
+
+    T& operator*() {
+      return get();
+    }
+
+    const T* operator->() const {
+      return &get();
+    }
+
+    T* operator->() {
+      return &get();
+    }
+  };
+
+  namespace detail {
+
+    template <typename Archive>
+    concept IsLazyBinaryOutput = std::same_as<Archive, cereal::BinaryOutputArchive>
+      || std::same_as<Archive, cereal::PortableBinaryOutputArchive>;
+
+    template <typename Archive>
+    concept IsLazyBinaryInput = std::same_as<Archive, cereal::BinaryInputArchive>
+      || std::same_as<Archive, cereal::PortableBinaryInputArchive>;
+
+    // The input archive that reads what Archive writes
+    template <typename Archive>
+    using LazyInputFor = std::conditional_t<std::same_as<Archive, cereal::BinaryOutputArchive>,
+                                            cereal::BinaryInputArchive,
+                                            cereal::PortableBinaryInputArchive>;
+
+    template <typename InputArchive, typename T>
+    void decodeLazyBinary(std::string_view encoded, T& value) {
+      std::ispanstream stream(std::span<const char>(encoded.data(), encoded.size()));
+      InputArchive ar(stream);
+      ar(value);
+    }
+
+    /**
+     * How formats get at a lazy's bytes. Only the formats that know
+     * how to find the end of a value without decoding it use this.
+     */
+
+    struct LazyAccess {
+      // The bytes, if value is holding undecoded bytes written in the
+      // format decoder reads
+      template <typename T>
+      static const std::string* encodedFor(const lazy<T>& value, typename lazy<T>::Decoder decoder) {
+        return value._decoder == decoder ? &value._encoded : nullptr;
+      }
+
+      // Hands back the buffer to copy the new bytes into, keeping
+      // whatever capacity it had from last time
+      template <typename T>
+      static std::string& beginEncoded(lazy<T>& value, typename lazy<T>::Decoder decoder) {
+        value._decoder = decoder;
+        value._decoded = false;
+        return value._encoded;
+      }
+
+      // Drops any bytes and hands back the value to load into directly
+      template <typename T>
+      static T& beginDecoded(lazy<T>& value) {
+        value._decoder = nullptr;
+        value._decoded = true;
+        return value._value;
+      }
+    };
+
+  }
+
+  /**
+   * cereal save for lazy members. In the binary archives that's a
+   * size tag and T in an archive of its own, or the bytes we loaded
+   * if they're still good.
+   */
+
+  template <typename Archive, typename T>
+  void save(Archive& ar, const lazy<T>& value) {
+    if constexpr (detail::IsLazyBinaryOutput<Archive>) {
+      constexpr typename lazy<T>::Decoder decoder = &detail::decodeLazyBinary<detail::LazyInputFor<Archive>, T>;
+      if (const std::string* encoded = detail::LazyAccess::encodedFor(value, decoder)) {
+        ar(cereal::make_size_tag(static_cast<cereal::size_type>(encoded->size())));
+        ar(cereal::binary_data(encoded->data(), encoded->size()));
+        return;
+      }
+      std::ostringstream stream;
+      {
+        Archive inner(stream);
+        inner(value.get());
+      }
+      std::string bytes = std::move(stream).str();
+      ar(cereal::make_size_tag(static_cast<cereal::size_type>(bytes.size())));
+      ar(cereal::binary_data(bytes.data(), bytes.size()));
+    } else {
+      ar(value.get());
+    }
+  }
+
+  /**
+   * and the load, which only copies the bytes in the binary archives
+   */
+
+  template <typename Archive, typename T>
+  void load(Archive& ar, lazy<T>& value) {
+    if constexpr (detail::IsLazyBinaryInput<Archive>) {
+      cereal::size_type size;
+      ar(cereal::make_size_tag(size));
+      std::string& encoded = detail::LazyAccess::beginEncoded(value, &detail::decodeLazyBinary<Archive, T>);
+      encoded.resize(static_cast<size_t>(size));
+      ar(cereal::binary_data(encoded.data(), encoded.size()));
+    } else {
+      ar(detail::LazyAccess::beginDecoded(value));
+    }
+  }
+
+}
@@ -0,0 +1,188 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * Newline delimited JSON: one compact object per line. Both ends
+ * stream, so you never need the whole sequence in memory, and neither
+ * one builds a cereal archive per record. They use the native JSON
+ * code in json.h instead.
+ *
+ * Writing:
+ *
+ *   fr::autocereal::ndjson_writer<Message> writer(stream);
+ *   for (const auto& message : messages) {
+ *     writer.write(message);
+ *   }
+ *
+ * Reading is an input range:
+ *
+ *   for (const Message& message : fr::autocereal::ndjson_reader<Message>(stream)) {
+ *     ...
+ *   }
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/json.h>
+
+#include <iterator>
+#include <string>
+
+namespace fr::autocereal {
+
+  /**
+   * Lines are collected in a buffer and written out once it gets to
+   * this size, or when you call flush.
+   */
+
+  inline constexpr size_t NDJSON_FLUSH_BYTES = 64 * 1024;
+
+  template <typename T>
+  class ndjson_writer {
+    std::ostream& _stream;
+    std::string _buffer;
+
+  public:
+    explicit ndjson_writer(std::ostream& stream) : _stream(stream) {
+      _buffer.reserve(NDJSON_FLUSH_BYTES + 1024);
+    }
+
+    ndjson_writer(const ndjson_writer&) = delete;
+    ndjson_writer& operator=(const ndjson_writer&) = delete;
+
+    ~ndjson_writer() {
+      flush();
+    }
+
+    void write(const T& obj) {
+      detail::json::writeRecord(_buffer, obj);
+      _buffer.push_back('\n');
+      if (_buffer.size() >= NDJSON_FLUSH_BYTES) {
+        flush();
+      }
+    }
+
+    ndjson_writer& operator<<(const T& obj) {
+      write(obj);
+      return *this;
+    }
+
+    void flush() {
+      _stream.write(_buffer.data(), _buffer.size());
+      _buffer.clear();
+    }
+  };
+
+  /**
+   * Reads one object per line. Blank lines are skipped. The range
+   * hands out the same T each time around, so copy or move out of it
+   * if you need to keep a record past the next increment.
+   */
+
+  template <typename T>
+  class ndjson_reader {
+    std::istream& _stream;
+    std::string _line;
+    T _current{};
+    bool _done = false;
+
+  public:
+    explicit ndjson_reader(std::istream& stream) : _stream(stream) {}
+
+    ndjson_reader(const ndjson_reader&) = delete;
+    ndjson_reader& operator=(const ndjson_reader&) = delete;
+
+    /**
+     * Pull interface, if you'd rather not use the range. Returns false
+     * at the end of the stream.
+     */
+
+    bool read(T& obj) {
+      while (std::getline(_stream, _line)) {
+        if (!_line.empty() && _line.back() == '\r') {
+          _line.pop_back();
+        }
+        detail::json::JsonReader in(_line);
+        if (in.atEnd()) {
+          continue;
+        }
+        // Start every record from scratch so a line that leaves a
+        // member out doesn't inherit the previous record's value
+        obj = T{};
+        detail::json::readRecord(in, obj);
+        if (!in.atEnd()) {
+          in.fail("trailing characters after object");
+        }
+        return true;
+      }
+      return false;
+    }
+
+    class iterator {
+      ndjson_reader* _reader = nullptr;
+
+    public:
+      using value_type = T;
+      using difference_type = std::ptrdiff_t;
+
+      iterator() = default;
+      explicit iterator(ndjson_reader* reader) : _reader(reader) {}
+
+      T& operator*() const {
+        return _reader->_current;
+      }
+
+      T* operator->() const {
+        return &_reader->_current;
+      }
+
+      iterator& operator++() {
+        _reader->advance();
+        return *this;
+      }
+
+      void operator++(int) {
+        ++*this;
+      }
+
+      bool atEnd() const {
+        return _reader == nullptr || _reader->_done;
+      }
+
+      friend bool operator==(const iterator& it, std::default_sentinel_t) {
+        return it.atEnd();
+      }
+    };
+
+    iterator begin() {
+      advance();
+      return iterator(this);
+    }
+
+    std::default_sentinel_t end() {
+      return std::default_sentinel;
+    }
+
+  private:
+    void advance() {
+      if (!_done && !read(_current)) {
+        _done = true;
+      }
+    }
+  };
+
+}
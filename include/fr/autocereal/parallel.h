@@ -0,0 +1,224 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * Bare bones threading helpers for the formats that can split their
+ * work up. Nothing fancy -- threads are started per call, which is
+ * fine for the sort of multi-megabyte jobs these get used for.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <istream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fr::autocereal {
+
+  inline size_t defaultThreadCount() {
+    size_t threads = std::thread::hardware_concurrency();
+    return threads == 0 ? 1 : threads;
+  }
+
+  /**
+   * Runs fn(i) for every i in [0, count) on up to threads threads,
+   * the calling thread included. The first exception thrown by fn
+   * stops handing out work and gets rethrown here once everyone has
+   * finished.
+   */
+
+  template <typename Fn>
+  void parallelFor(size_t count, size_t threads, Fn&& fn) {
+    threads = std::min(threads, count);
+    if (threads <= 1) {
+      for (size_t i = 0; i < count; ++i) {
+        fn(i);
+      }
+      return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+      try {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+          fn(i);
+        }
+      } catch (...) {
+        std::lock_guard lock(errorMutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        next = count;
+      }
+    };
+
+    {
+      std::vector<std::jthread> pool;
+      pool.reserve(threads - 1);
+      for (size_t i = 1; i < threads; ++i) {
+        pool.emplace_back(worker);
+      }
+      worker();
+    }
+
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  /**
+   * Work stealing version of parallelFor, for when items cost wildly
+   * different amounts. Each thread starts out owning an equal share of
+   * [0, count) and works through it from the front. A thread that runs
+   * out steals the back half of whichever share has the most left, so
+   * nobody sits idle while somebody else grinds through a run of
+   * expensive items. Exceptions work the same as parallelFor.
+   */
+
+  template <typename Fn>
+  void parallelForStealing(size_t count, size_t threads, Fn&& fn) {
+    threads = std::min(threads, count);
+    if (threads <= 1) {
+      for (size_t i = 0; i < count; ++i) {
+        fn(i);
+      }
+      return;
+    }
+
+    struct alignas(64) Share {
+      std::mutex mutex;
+      size_t begin = 0;
+      size_t end = 0;
+    };
+
+    std::vector<Share> shares(threads);
+    for (size_t t = 0; t < threads; ++t) {
+      shares[t].begin = t * count / threads;
+      shares[t].end = (t + 1) * count / threads;
+    }
+
+    std::atomic<bool> stop{false};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    constexpr size_t none = std::numeric_limits<size_t>::max();
+
+    auto take = [&](size_t t) {
+      std::lock_guard lock(shares[t].mutex);
+      return shares[t].begin < shares[t].end ? shares[t].begin++ : none;
+    };
+
+    // Moves half of the fullest share over to t. False if there's
+    // nothing left anywhere.
+    auto steal = [&](size_t t) {
+      while (!stop) {
+        size_t victim = none;
+        size_t most = 0;
+        for (size_t v = 0; v < threads; ++v) {
+          if (v == t) {
+            continue;
+          }
+          std::lock_guard lock(shares[v].mutex);
+          size_t left = shares[v].end - shares[v].begin;
+          if (left > most) {
+            most = left;
+            victim = v;
+          }
+        }
+        if (victim == none) {
+          return false;
+        }
+        size_t from, to;
+        {
+          std::lock_guard lock(shares[victim].mutex);
+          size_t left = shares[victim].end - shares[victim].begin;
+          if (left == 0) {
+            continue;
+          }
+          to = shares[victim].end;
+          shares[victim].end -= (left + 1) / 2;
+          from = shares[victim].end;
+        }
+        std::lock_guard lock(shares[t].mutex);
+        shares[t].begin = from;
+        shares[t].end = to;
+        return true;
+      }
+      return false;
+    };
+
+    auto worker = [&](size_t t) {
+      try {
+        while (!stop) {
+          size_t i = take(t);
+          if (i == none) {
+            if (!steal(t)) {
+              return;
+            }
+            continue;
+          }
+          fn(i);
+        }
+      } catch (...) {
+        std::lock_guard lock(errorMutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        stop = true;
+      }
+    };
+
+    {
+      std::vector<std::jthread> pool;
+      pool.reserve(threads - 1);
+      for (size_t t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+      }
+      worker(0);
+    }
+
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  namespace detail {
+
+    /**
+     * Parsers that split their input across threads need all of it up
+     * front
+     */
+
+    inline std::string readAll(std::istream& stream) {
+      std::string data;
+      char buffer[64 * 1024];
+      while (stream.read(buffer, sizeof(buffer)) || stream.gcount() > 0) {
+        data.append(buffer, stream.gcount());
+      }
+      return data;
+    }
+
+  }
+
+}
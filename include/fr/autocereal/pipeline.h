@@ -0,0 +1,265 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * Serialize, compress and write a big range of objects with the
+ * stages overlapping, so a snapshot job keeps every core busy
+ * without doing its own threading.
+ *
+ * The range gets cut into batches of batchSize objects. Worker
+ * threads pull the next batch off a shared counter, serialize it
+ * through to_output_archive into a binary batch (the batch.h layout)
+ * and, if you asked for compression, squash it into a frame of its
+ * own. The calling thread writes finished batches to the stream in
+ * order while the workers get on with the next ones. Workers can only
+ * get queueDepth batches ahead of the writer, which is what keeps
+ * memory bounded when the disk is the slow part.
+ *
+ * The stream ends up as batch after batch, each one its own archive
+ * (so shared pointers are only tracked within a batch). Compressed
+ * frames concatenate, so from_binary_pipeline can read it all back
+ * through one DecompressedInputStream.
+ *
+ * If the standard library has std::execution (__cpp_lib_senders),
+ * pipeline_sender wraps the whole thing up as a sender that runs on
+ * your scheduler and completes with the PipelineStats.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/compression.h>
+#include <fr/autocereal/parallel.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <version>
+
+#if defined(__cpp_lib_senders)
+#include <execution>
+#endif
+
+namespace fr::autocereal {
+
+  /**
+   * Default number of objects per batch
+   */
+
+  inline constexpr size_t PIPELINE_BATCH_ITEMS = 4096;
+
+  struct PipelineOptions {
+    size_t batchSize = PIPELINE_BATCH_ITEMS;
+    size_t threads = defaultThreadCount();
+    // How many batches the workers can get ahead of the writer. 0
+    // means twice the thread count.
+    size_t queueDepth = 0;
+    std::optional<Compression> compression;
+  };
+
+  struct PipelineStats {
+    size_t items = 0;
+    size_t batches = 0;
+    // Before and after compression
+    uint64_t serializedBytes = 0;
+    uint64_t writtenBytes = 0;
+  };
+
+  namespace detail::pipeline {
+
+    struct Batch {
+      std::string bytes;
+      uint64_t serializedBytes = 0;
+    };
+
+    template <typename Range>
+    Batch encodeBatch(const Range& items, size_t from, size_t to, const std::optional<Compression>& compression) {
+      auto begin = std::ranges::begin(items);
+      Batch batch;
+      std::ostringstream serialized;
+      {
+        cereal::BinaryOutputArchive ar(serialized);
+        ar(cereal::make_size_tag(static_cast<cereal::size_type>(to - from)));
+        for (size_t i = from; i < to; ++i) {
+          to_output_archive(begin[i], ar);
+        }
+      }
+      batch.bytes = std::move(serialized).str();
+      batch.serializedBytes = batch.bytes.size();
+
+      if (compression) {
+        std::ostringstream compressed;
+        auto encoder = detail::compression::makeEncoder(*compression);
+        encoder->compress(batch.bytes.data(), batch.bytes.size(), compressed);
+        encoder->finish(compressed);
+        batch.bytes = std::move(compressed).str();
+      }
+      return batch;
+    }
+
+  }
+
+  /**
+   * Runs the pipeline over items and writes the result to stream.
+   * Returns once everything's been written.
+   */
+
+  template <typename Range>
+  requires std::ranges::random_access_range<const Range> && std::ranges::sized_range<const Range>
+  PipelineStats to_binary_pipeline(const Range& items, std::ostream& stream, const PipelineOptions& options = {}) {
+    size_t batchSize = std::max<size_t>(options.batchSize, 1);
+    size_t total = std::ranges::size(items);
+    size_t batchCount = (total + batchSize - 1) / batchSize;
+    size_t threads = std::clamp<size_t>(options.threads, 1, std::max<size_t>(batchCount, 1));
+    size_t depth = std::max<size_t>(options.queueDepth == 0 ? threads * 2 : options.queueDepth, 1);
+
+    PipelineStats stats;
+    stats.items = total;
+    stats.batches = batchCount;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<std::optional<detail::pipeline::Batch>> slots(depth);
+    size_t next = 0;
+    size_t written = 0;
+    std::exception_ptr error;
+
+    auto fail = [&](std::exception_ptr thrown) {
+      std::lock_guard lock(mutex);
+      if (!error) {
+        error = thrown;
+      }
+      changed.notify_all();
+    };
+
+    auto worker = [&]() {
+      try {
+        while (true) {
+          size_t batch;
+          {
+            std::unique_lock lock(mutex);
+            changed.wait(lock, [&] { return error || next >= batchCount || next < written + depth; });
+            if (error || next >= batchCount) {
+              return;
+            }
+            batch = next++;
+          }
+          size_t from = batch * batchSize;
+          auto encoded = detail::pipeline::encodeBatch(items, from, std::min(total, from + batchSize), options.compression);
+          std::lock_guard lock(mutex);
+          slots[batch % depth] = std::move(encoded);
+          changed.notify_all();
+        }
+      } catch (...) {
+        fail(std::current_exception());
+      }
+    };
+
+    {
+      std::vector<std::jthread> pool;
+      pool.reserve(threads);
+      for (size_t i = 0; i < threads; ++i) {
+        pool.emplace_back(worker);
+      }
+
+      try {
+        for (size_t batch = 0; batch < batchCount; ++batch) {
+          detail::pipeline::Batch ready;
+          {
+            std::unique_lock lock(mutex);
+            changed.wait(lock, [&] { return error || slots[batch % depth].has_value(); });
+            if (error) {
+              break;
+            }
+            ready = std::move(*slots[batch % depth]);
+            slots[batch % depth].reset();
+            ++written;
+            changed.notify_all();
+          }
+          stream.write(ready.bytes.data(), static_cast<std::streamsize>(ready.bytes.size()));
+          if (!stream) {
+            throw cereal::Exception("Failed writing pipeline output");
+          }
+          stats.serializedBytes += ready.serializedBytes;
+          stats.writtenBytes += ready.bytes.size();
+        }
+      } catch (...) {
+        fail(std::current_exception());
+      }
+    }
+
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return stats;
+  }
+
+  /**
+   * Reads everything to_binary_pipeline wrote, appending it to items.
+   * Pass the same compression setting the pipeline was written with;
+   * the codec itself is worked out from the data.
+   */
+
+  template <typename T>
+  void from_binary_pipeline(std::vector<T>& items, std::istream& stream, const PipelineOptions& options = {}) {
+    std::optional<DecompressedInputStream> decompressed;
+    if (options.compression) {
+      decompressed.emplace(stream);
+    }
+    std::istream& in = decompressed ? static_cast<std::istream&>(*decompressed) : stream;
+
+    while (in.peek() != std::istream::traits_type::eof()) {
+      cereal::BinaryInputArchive ar(in);
+      cereal::size_type size;
+      ar(cereal::make_size_tag(size));
+      size_t start = items.size();
+      items.resize(start + static_cast<size_t>(size));
+      for (size_t i = start; i < items.size(); ++i) {
+        from_input_archive(items[i], ar);
+      }
+    }
+  }
+
+#if defined(__cpp_lib_senders)
+
+  /**
+   * to_binary_pipeline as a sender. It starts on scheduler, the
+   * workers run alongside it, and it completes with the stats. items
+   * and stream are held by reference until it completes.
+   */
+
+  template <std::execution::scheduler Scheduler, typename Range>
+  requires std::ranges::random_access_range<const Range> && std::ranges::sized_range<const Range>
+  auto pipeline_sender(Scheduler scheduler, const Range& items, std::ostream& stream, PipelineOptions options = {}) {
+    return std::execution::schedule(std::move(scheduler))
+      | std::execution::then([&items, &stream, options = std::move(options)] {
+          return to_binary_pipeline(items, stream, options);
+        });
+  }
+
+#endif
+
+}
@@ -0,0 +1,818 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * Binary files that carry their own schema, so a newer version of a
+ * struct can still read them.
+ *
+ * Plain binary is positional: add a member to a struct and every file
+ * you wrote before that is unreadable. JSON copes, since it matches
+ * members up by name, but it's a lot slower and a lot bigger. This
+ * sits in between. The file starts with an "ACSCHEM1" magic, the
+ * writer's schema_fingerprint and a compact schema: every record type
+ * involved, with its member names and a tag for each member's type.
+ * After that it's objects, back to back, in exactly the layout
+ * to_binary writes. The schema is written once per file, no matter
+ * how many objects follow it.
+ *
+ * Reading, if the fingerprint in the file matches the type you're
+ * reading into, the objects are read with a plain cereal load and the
+ * schema is never looked at again. If it doesn't, members are matched
+ * up by name. For each record in the file and each type you're
+ * reading it into, a plan is worked out the first time it's needed and
+ * cached in the reader: which of the file's members goes into which of
+ * yours and which get skipped. Members you've added since keep
+ * whatever they had, and numbers convert between sizes and types.
+ * Members also move in and out of std::optional.
+ *
+ * The one thing the schema can't describe is a type autocereal doesn't
+ * look inside, like a map or a class with its own serialize
+ * function. Those load fine as long as both sides have the same type,
+ * but a file member of one of those types can't be skipped. Its size
+ * isn't written anywhere, so you get an exception instead.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/fingerprint.h>
+#include <fr/autocereal/traits.h>
+#include <cereal/types/string.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <format>
+#include <istream>
+#include <map>
+#include <memory>
+#include <meta>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fr::autocereal {
+
+  namespace detail::schema {
+
+    inline constexpr std::string_view MAGIC = "ACSCHEM1";
+
+    enum class FieldKind : uint8_t {
+      Bool,
+      Int,
+      UInt,
+      Float,
+      String,
+      Vector,
+      Array,
+      Optional,
+      Pointer,
+      Record,
+      Opaque
+    };
+
+    /**
+     * One type in a schema. element is the index of the element's type
+     * for the containers, or of the record for Record.
+     */
+
+    struct TypeTag {
+      FieldKind kind = FieldKind::Opaque;
+      uint8_t size = 0;
+      uint32_t count = 0;
+      uint32_t element = 0;
+      // What the compiler calls an Opaque type
+      std::string name;
+
+      bool operator==(const TypeTag&) const = default;
+    };
+
+    struct FieldSchema {
+      std::string name;
+      uint32_t type = 0;
+    };
+
+    struct RecordSchema {
+      std::vector<FieldSchema> fields;
+    };
+
+    inline bool isScalar(FieldKind kind) {
+      return kind == FieldKind::Bool || kind == FieldKind::Int || kind == FieldKind::UInt || kind == FieldKind::Float;
+    }
+
+    struct Schema {
+      uint64_t fingerprint = 0;
+      uint32_t root = 0;
+      std::vector<TypeTag> types;
+      std::vector<RecordSchema> records;
+
+      void save(cereal::BinaryOutputArchive& ar) const {
+        ar.saveBinary(MAGIC.data(), static_cast<std::streamsize>(MAGIC.size()));
+        ar(fingerprint, root);
+        ar(cereal::make_size_tag(static_cast<cereal::size_type>(types.size())));
+        for (const TypeTag& tag : types) {
+          ar(static_cast<uint8_t>(tag.kind), tag.size, tag.count, tag.element);
+          if (tag.kind == FieldKind::Opaque) {
+            ar(tag.name);
+          }
+        }
+        ar(cereal::make_size_tag(static_cast<cereal::size_type>(records.size())));
+        for (const RecordSchema& record : records) {
+          ar(cereal::make_size_tag(static_cast<cereal::size_type>(record.fields.size())));
+          for (const FieldSchema& field : record.fields) {
+            ar(field.name, field.type);
+          }
+        }
+      }
+
+      void load(cereal::BinaryInputArchive& ar) {
+        std::array<char, MAGIC.size()> magic;
+        ar.loadBinary(magic.data(), static_cast<std::streamsize>(magic.size()));
+        if (std::string_view(magic.data(), magic.size()) != MAGIC) {
+          throw cereal::Exception("Not a schema binary file");
+        }
+        ar(fingerprint, root);
+
+        cereal::size_type typeCount;
+        ar(cereal::make_size_tag(typeCount));
+        types.resize(static_cast<size_t>(typeCount));
+        for (TypeTag& tag : types) {
+          uint8_t kind;
+          ar(kind, tag.size, tag.count, tag.element);
+          if (kind > static_cast<uint8_t>(FieldKind::Opaque)) {
+            throw cereal::Exception("Corrupt schema: unknown type kind");
+          }
+          tag.kind = static_cast<FieldKind>(kind);
+          if (tag.kind == FieldKind::Opaque) {
+            ar(tag.name);
+          }
+        }
+
+        cereal::size_type recordCount;
+        ar(cereal::make_size_tag(recordCount));
+        records.resize(static_cast<size_t>(recordCount));
+        for (RecordSchema& record : records) {
+          cereal::size_type fieldCount;
+          ar(cereal::make_size_tag(fieldCount));
+          record.fields.resize(static_cast<size_t>(fieldCount));
+          for (FieldSchema& field : record.fields) {
+            ar(field.name, field.type);
+            if (field.type >= types.size()) {
+              throw cereal::Exception("Corrupt schema: member type out of range");
+            }
+          }
+        }
+
+        // Everything gets indexed without checking after this. Element
+        // types are always added before their containers, so anything
+        // else is either corrupt or a loop.
+        if (root >= types.size()) {
+          throw cereal::Exception("Corrupt schema: root type out of range");
+        }
+        for (size_t index = 0; index < types.size(); ++index) {
+          const TypeTag& tag = types[index];
+          bool hasElement = tag.kind == FieldKind::Vector || tag.kind == FieldKind::Array
+            || tag.kind == FieldKind::Optional || tag.kind == FieldKind::Pointer;
+          if ((hasElement && tag.element >= index)
+              || (tag.kind == FieldKind::Record && tag.element >= records.size())) {
+            throw cereal::Exception("Corrupt schema: element out of range");
+          }
+        }
+        checkRecordLoops();
+      }
+
+    private:
+      /**
+       * The record a field of this type holds directly, if there is
+       * one. std::arrays of records count, since reading one doesn't
+       * take any input before it gets to the record.
+       */
+
+      const TypeTag* directRecord(uint32_t type) const {
+        while (types[type].kind == FieldKind::Array) {
+          type = types[type].element;
+        }
+        return types[type].kind == FieldKind::Record ? &types[type] : nullptr;
+      }
+
+      /**
+       * Records do get to refer back to themselves, but only through a
+       * vector, optional or pointer, which all read something from the
+       * input before going round again. A record that holds itself
+       * directly would have the migrator recurse until the stack runs
+       * out, so that's rejected here. The search keeps its own stack,
+       * since a corrupt file can have as many records as it likes.
+       */
+
+      void checkRecordLoops() const {
+        enum : uint8_t { Unvisited, Visiting, Done };
+        std::vector<uint8_t> state(records.size(), Unvisited);
+        std::vector<std::pair<uint32_t, size_t>> stack;
+        for (uint32_t start = 0; start < records.size(); ++start) {
+          if (state[start] != Unvisited) {
+            continue;
+          }
+          state[start] = Visiting;
+          stack.emplace_back(start, 0);
+          while (!stack.empty()) {
+            auto [record, next] = stack.back();
+            const auto& fields = records[record].fields;
+            if (next == fields.size()) {
+              state[record] = Done;
+              stack.pop_back();
+              continue;
+            }
+            ++stack.back().second;
+            const TypeTag* held = directRecord(fields[next].type);
+            if (held == nullptr) {
+              continue;
+            }
+            if (state[held->element] == Visiting) {
+              throw cereal::Exception("Corrupt schema: record contains itself");
+            }
+            if (state[held->element] == Unvisited) {
+              state[held->element] = Visiting;
+              stack.emplace_back(held->element, 0);
+            }
+          }
+        }
+      }
+    };
+
+    // Something with a different address for every type
+    template <typename T>
+    inline constexpr char typeKey = 0;
+
+    /**
+     * Builds the schema for a type out of its reflection
+     */
+
+    class SchemaBuilder {
+      Schema _schema;
+      std::vector<std::pair<const void*, uint32_t>> _records;
+
+      uint32_t add(TypeTag tag) {
+        auto found = std::find(_schema.types.begin(), _schema.types.end(), tag);
+        if (found != _schema.types.end()) {
+          return static_cast<uint32_t>(found - _schema.types.begin());
+        }
+        _schema.types.push_back(std::move(tag));
+        return static_cast<uint32_t>(_schema.types.size() - 1);
+      }
+
+      template <typename T>
+      uint32_t record() {
+        for (const auto& [key, index] : _records) {
+          if (key == &typeKey<T>) {
+            return index;
+          }
+        }
+        // Claim the index before the members, in case one of them
+        // leads back here
+        uint32_t index = static_cast<uint32_t>(_schema.records.size());
+        _schema.records.emplace_back();
+        _records.emplace_back(&typeKey<T>, index);
+
+        std::vector<FieldSchema> fields;
+        forEachMember<T>([&]<typename Owner, size_t member>(std::type_identity<Owner>, std::integral_constant<size_t, member>) {
+          const auto& name = ClassSingleton<Owner>::instance().memberAtIndex(member);
+          fields.push_back({name, type<member_type_t<Owner, member>>()});
+        });
+        _schema.records[index].fields = std::move(fields);
+        return index;
+      }
+
+    public:
+      template <typename T>
+      uint32_t type() {
+        TypeTag tag;
+        if constexpr (std::is_same_v<T, bool>) {
+          tag.kind = FieldKind::Bool;
+          tag.size = sizeof(bool);
+        } else if constexpr (std::is_enum_v<T>) {
+          return type<std::underlying_type_t<T>>();
+        } else if constexpr (std::is_floating_point_v<T>) {
+          tag.kind = FieldKind::Float;
+          tag.size = sizeof(T);
+        } else if constexpr (std::is_integral_v<T>) {
+          tag.kind = std::is_signed_v<T> ? FieldKind::Int : FieldKind::UInt;
+          tag.size = sizeof(T);
+        } else if constexpr (IsString<T>) {
+          tag.kind = FieldKind::String;
+        } else if constexpr (IsVector<T>) {
+          tag.kind = FieldKind::Vector;
+          tag.element = type<typename T::value_type>();
+        } else if constexpr (IsStdArray<T>) {
+          tag.kind = FieldKind::Array;
+          tag.count = static_cast<uint32_t>(std::tuple_size_v<T>);
+          tag.element = type<typename T::value_type>();
+        } else if constexpr (IsOptional<T>) {
+          tag.kind = FieldKind::Optional;
+          tag.element = type<typename T::value_type>();
+        } else if constexpr (IsUniquePtr<T> && !std::is_polymorphic_v<typename T::element_type>) {
+          tag.kind = FieldKind::Pointer;
+          tag.element = type<std::remove_const_t<typename T::element_type>>();
+        } else if constexpr (IsReflectedRecord<T>) {
+          tag.kind = FieldKind::Record;
+          tag.element = record<T>();
+        } else {
+          tag.kind = FieldKind::Opaque;
+          tag.name = std::meta::display_string_of(^^T);
+        }
+        return add(std::move(tag));
+      }
+
+      template <typename T>
+      Schema finish() {
+        _schema.root = type<T>();
+        _schema.fingerprint = schema_fingerprint<T>();
+        return std::move(_schema);
+      }
+    };
+
+    template <typename T>
+    const Schema& schemaFor() {
+      static const Schema schema = SchemaBuilder().finish<T>();
+      return schema;
+    }
+
+    template <typename T>
+    struct MemberLoaders;
+
+    // The type an arithmetic or enum member is written as
+    template <typename T>
+    struct scalarOf {
+      using type = T;
+    };
+
+    template <typename T>
+    requires std::is_enum_v<T>
+    struct scalarOf<T> {
+      using type = std::underlying_type_t<T>;
+    };
+
+    /**
+     * Reads objects written with one schema into types that may have
+     * moved on since. One of these lives in each reader, along with
+     * the plans it's worked out so far.
+     */
+
+    class Migrator {
+      // Which of the file's members goes where. target is an index into
+      // MemberLoaders<T>, or -1 to skip the member.
+      struct PlanStep {
+        uint32_t fileType;
+        int32_t target;
+      };
+
+      cereal::BinaryInputArchive& _ar;
+      const Schema& _file;
+      std::map<std::pair<uint32_t, const void*>, std::vector<PlanStep>> _plans;
+
+      [[noreturn]] void mismatch(const TypeTag& tag, std::string_view target) {
+        throw cereal::Exception(std::format("Can't load a {} from the file into a {}", describe(tag), target));
+      }
+
+      std::string describe(const TypeTag& tag) const {
+        switch (tag.kind) {
+          case FieldKind::Bool: return "bool";
+          case FieldKind::Int: return std::format("{} byte signed integer", tag.size);
+          case FieldKind::UInt: return std::format("{} byte unsigned integer", tag.size);
+          case FieldKind::Float: return std::format("{} byte float", tag.size);
+          case FieldKind::String: return "string";
+          case FieldKind::Vector: return "vector of " + describe(_file.types[tag.element]);
+          case FieldKind::Array: return std::format("array of {} ", tag.count) + describe(_file.types[tag.element]);
+          case FieldKind::Optional: return "optional " + describe(_file.types[tag.element]);
+          case FieldKind::Pointer: return "unique_ptr to " + describe(_file.types[tag.element]);
+          case FieldKind::Record: return "record";
+          case FieldKind::Opaque: return tag.name;
+        }
+        return "unknown type";
+      }
+
+      void skipBytes(size_t count) {
+        std::array<char, 4096> scratch;
+        while (count > 0) {
+          size_t chunk = std::min(count, scratch.size());
+          _ar.loadBinary(scratch.data(), static_cast<std::streamsize>(chunk));
+          count -= chunk;
+        }
+      }
+
+      template <typename M, typename From>
+      static M convertScalar(From from) {
+        if constexpr (std::is_enum_v<M>) {
+          return static_cast<M>(static_cast<std::underlying_type_t<M>>(from));
+        } else {
+          return static_cast<M>(from);
+        }
+      }
+
+      template <typename M, typename From>
+      M readAs() {
+        From from;
+        _ar(from);
+        return convertScalar<M>(from);
+      }
+
+      template <typename M>
+      M readScalar(const TypeTag& tag) {
+        switch (tag.kind) {
+          case FieldKind::Bool:
+            return readAs<M, bool>();
+          case FieldKind::Int:
+            switch (tag.size) {
+              case 1: return readAs<M, int8_t>();
+              case 2: return readAs<M, int16_t>();
+              case 4: return readAs<M, int32_t>();
+              case 8: return readAs<M, int64_t>();
+            }
+            break;
+          case FieldKind::UInt:
+            switch (tag.size) {
+              case 1: return readAs<M, uint8_t>();
+              case 2: return readAs<M, uint16_t>();
+              case 4: return readAs<M, uint32_t>();
+              case 8: return readAs<M, uint64_t>();
+            }
+            break;
+          case FieldKind::Float:
+            if (tag.size == sizeof(float)) {
+              return readAs<M, float>();
+            } else if (tag.size == sizeof(double)) {
+              return readAs<M, double>();
+            } else if (tag.size == sizeof(long double)) {
+              return readAs<M, long double>();
+            }
+            break;
+          default:
+            break;
+        }
+        throw cereal::Exception("Unsupported scalar in schema: " + describe(tag));
+      }
+
+      template <typename M>
+      static bool sameScalar(const TypeTag& tag) {
+        using Scalar = typename scalarOf<M>::type;
+        FieldKind kind = std::is_same_v<Scalar, bool> ? FieldKind::Bool
+          : std::is_floating_point_v<Scalar> ? FieldKind::Float
+          : std::is_signed_v<Scalar> ? FieldKind::Int : FieldKind::UInt;
+        return tag.kind == kind && tag.size == sizeof(Scalar);
+      }
+
+      template <typename T>
+      const std::vector<PlanStep>& plan(uint32_t record) {
+        auto key = std::make_pair(record, static_cast<const void*>(&typeKey<T>));
+        auto found = _plans.find(key);
+        if (found != _plans.end()) {
+          return found->second;
+        }
+        const auto& loaders = MemberLoaders<T>::instance();
+        std::vector<PlanStep> steps;
+        for (const FieldSchema& field : _file.records[record].fields) {
+          auto target = std::find_if(loaders.begin(), loaders.end(), [&](const auto& loader) { return loader.name == field.name; });
+          steps.push_back({field.type, target == loaders.end() ? -1 : static_cast<int32_t>(target - loaders.begin())});
+        }
+        return _plans.emplace(key, std::move(steps)).first->second;
+      }
+
+      template <typename T>
+      void readRecord(uint32_t record, T& obj) {
+        const auto& loaders = MemberLoaders<T>::instance();
+        // Same as a plain binary load would
+        resetAllTransients(obj);
+        for (const PlanStep& step : plan<T>(record)) {
+          if (step.target < 0) {
+            skip(step.fileType);
+          } else {
+            loaders[step.target].load(*this, step.fileType, obj);
+          }
+        }
+      }
+
+    public:
+      Migrator(cereal::BinaryInputArchive& ar, const Schema& file) : _ar(ar), _file(file) {}
+
+      /**
+       * Reads a value the file describes as fileType into value
+       */
+
+      template <typename M>
+      void read(uint32_t fileType, M& value) {
+        const TypeTag& tag = _file.types[fileType];
+        if constexpr (IsOptional<M>) {
+          if (tag.kind == FieldKind::Optional) {
+            bool nullopt;
+            _ar(nullopt);
+            if (nullopt) {
+              value.reset();
+              return;
+            }
+            if (!value) {
+              value.emplace();
+            }
+            read(tag.element, *value);
+          } else {
+            // It wasn't optional when the file was written
+            if (!value) {
+              value.emplace();
+            }
+            read(fileType, *value);
+          }
+        } else if constexpr (IsUniquePtr<M> && !std::is_polymorphic_v<typename M::element_type>) {
+          if (tag.kind != FieldKind::Pointer) {
+            mismatch(tag, std::meta::display_string_of(^^M));
+          }
+          uint8_t valid;
+          _ar(valid);
+          if (!valid) {
+            value.reset();
+            return;
+          }
+          if (!value) {
+            value = std::make_unique<typename M::element_type>();
+          }
+          read(tag.element, *value);
+        } else {
+          if (tag.kind == FieldKind::Optional) {
+            // It's not optional any more. Nothing there leaves value
+            // alone.
+            bool nullopt;
+            _ar(nullopt);
+            if (!nullopt) {
+              read(tag.element, value);
+            }
+          } else if constexpr (std::is_arithmetic_v<M> || std::is_enum_v<M>) {
+            if (sameScalar<M>(tag)) {
+              _ar(value);
+            } else if (isScalar(tag.kind)) {
+              value = readScalar<M>(tag);
+            } else {
+              mismatch(tag, std::meta::display_string_of(^^M));
+            }
+          } else if constexpr (IsString<M>) {
+            if (tag.kind != FieldKind::String) {
+              mismatch(tag, std::meta::display_string_of(^^M));
+            }
+            _ar(value);
+          } else if constexpr (IsVector<M>) {
+            if (tag.kind != FieldKind::Vector) {
+              mismatch(tag, std::meta::display_string_of(^^M));
+            }
+            using Element = typename M::value_type;
+            cereal::size_type size;
+            _ar(cereal::make_size_tag(size));
+            value.resize(static_cast<size_t>(size));
+            if constexpr (std::is_same_v<Element, bool>) {
+              for (size_t i = 0; i < value.size(); ++i) {
+                bool element = value[i];
+                read(tag.element, element);
+                value[i] = element;
+              }
+            } else if constexpr (std::is_arithmetic_v<Element>) {
+              if (sameScalar<Element>(_file.types[tag.element])) {
+                _ar(cereal::binary_data(value.data(), value.size() * sizeof(Element)));
+              } else {
+                for (Element& element : value) {
+                  read(tag.element, element);
+                }
+              }
+            } else {
+              for (Element& element : value) {
+                read(tag.element, element);
+              }
+            }
+          } else if constexpr (IsStdArray<M>) {
+            if (tag.kind != FieldKind::Array) {
+              mismatch(tag, std::meta::display_string_of(^^M));
+            }
+            // Extra elements are skipped, missing ones left alone
+            for (size_t i = 0; i < tag.count; ++i) {
+              if (i < value.size()) {
+                read(tag.element, value[i]);
+              } else {
+                skip(tag.element);
+              }
+            }
+          } else if constexpr (IsReflectedRecord<M>) {
+            if (tag.kind != FieldKind::Record) {
+              mismatch(tag, std::meta::display_string_of(^^M));
+            }
+            readRecord(tag.element, value);
+          } else {
+            if (tag.kind != FieldKind::Opaque || tag.name != std::meta::display_string_of(^^M)) {
+              mismatch(tag, std::meta::display_string_of(^^M));
+            }
+            _ar(value);
+          }
+        }
+      }
+
+      /**
+       * Reads past a value of fileType without keeping it
+       */
+
+      void skip(uint32_t fileType) {
+        const TypeTag& tag = _file.types[fileType];
+        switch (tag.kind) {
+          case FieldKind::Bool:
+          case FieldKind::Int:
+          case FieldKind::UInt:
+          case FieldKind::Float:
+            skipBytes(tag.size);
+            break;
+          case FieldKind::String: {
+            cereal::size_type size;
+            _ar(cereal::make_size_tag(size));
+            skipBytes(static_cast<size_t>(size));
+            break;
+          }
+          case FieldKind::Vector: {
+            cereal::size_type size;
+            _ar(cereal::make_size_tag(size));
+            const TypeTag& element = _file.types[tag.element];
+            if (isScalar(element.kind)) {
+              skipBytes(static_cast<size_t>(size) * element.size);
+            } else {
+              for (cereal::size_type i = 0; i < size; ++i) {
+                skip(tag.element);
+              }
+            }
+            break;
+          }
+          case FieldKind::Array:
+            for (uint32_t i = 0; i < tag.count; ++i) {
+              skip(tag.element);
+            }
+            break;
+          case FieldKind::Optional: {
+            bool nullopt;
+            _ar(nullopt);
+            if (!nullopt) {
+              skip(tag.element);
+            }
+            break;
+          }
+          case FieldKind::Pointer: {
+            uint8_t valid;
+            _ar(valid);
+            if (valid) {
+              skip(tag.element);
+            }
+            break;
+          }
+          case FieldKind::Record:
+            for (const FieldSchema& field : _file.records[tag.element].fields) {
+              skip(field.type);
+            }
+            break;
+          case FieldKind::Opaque:
+            throw cereal::Exception("Can't skip a " + tag.name + " in a schema binary file, its size isn't recorded");
+        }
+      }
+    };
+
+    template <typename T, typename Owner, size_t index>
+    void loadField(Migrator& migrator, uint32_t fileType, T& obj) {
+      constexpr auto info = member_info<Owner, index>();
+      auto& member = member_ref<Owner, info>(static_cast<Owner&>(obj));
+      rebindToLoadResource(member);
+      migrator.read(fileType, member);
+    }
+
+    /**
+     * T's members by name, each with a function that loads it. Built
+     * once per type.
+     */
+
+    template <typename T>
+    struct MemberLoaders {
+      struct Entry {
+        std::string_view name;
+        void (*load)(Migrator&, uint32_t, T&);
+      };
+
+      static const std::vector<Entry>& instance() {
+        static const std::vector<Entry> loaders = build();
+        return loaders;
+      }
+
+    private:
+      static std::vector<Entry> build() {
+        std::vector<Entry> loaders;
+        forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+          loaders.push_back({ClassSingleton<Owner>::instance().memberAtIndex(index), &loadField<T, Owner, index>});
+        });
+        return loaders;
+      }
+    };
+
+  }
+
+  /**
+   * Writes a schema header followed by as many objects as you like
+   */
+
+  template <typename T>
+  class schema_binary_writer {
+    cereal::BinaryOutputArchive _ar;
+
+  public:
+    explicit schema_binary_writer(std::ostream& stream) : _ar(stream) {
+      detail::schema::schemaFor<T>().save(_ar);
+    }
+
+    void write(const T& obj) {
+      _ar(obj);
+    }
+
+    schema_binary_writer& operator<<(const T& obj) {
+      write(obj);
+      return *this;
+    }
+  };
+
+  /**
+   * Reads what schema_binary_writer wrote, into T as it is now
+   */
+
+  template <typename T>
+  class schema_binary_reader {
+    std::istream& _stream;
+    cereal::BinaryInputArchive _ar;
+    detail::schema::Schema _schema;
+    bool _exact;
+    std::unique_ptr<detail::schema::Migrator> _migrator;
+
+  public:
+    explicit schema_binary_reader(std::istream& stream) : _stream(stream), _ar(stream) {
+      _schema.load(_ar);
+      _exact = _schema.fingerprint == schema_fingerprint<T>();
+      if (!_exact) {
+        _migrator = std::make_unique<detail::schema::Migrator>(_ar, _schema);
+      }
+    }
+
+    /**
+     * True if the file was written with the same schema T has now, in
+     * which case nothing gets mapped
+     */
+
+    bool exact() const {
+      return _exact;
+    }
+
+    /**
+     * Reads the next object. Returns false at the end of the file.
+     */
+
+    bool read(T& obj) {
+      if (_stream.peek() == std::istream::traits_type::eof()) {
+        return false;
+      }
+      if (_exact) {
+        _ar(obj);
+      } else {
+        _migrator->read(_schema.root, obj);
+      }
+      return true;
+    }
+  };
+
+  /**
+   * A single object with its schema
+   */
+
+  template <typename T, typename Stream>
+  requires IsOutputStream<Stream>
+  void to_schema_binary(const T& obj, Stream& stream) {
+    schema_binary_writer<T> writer(stream);
+    writer.write(obj);
+  }
+
+  template <typename T, typename Stream>
+  requires IsInputStream<Stream>
+  void from_schema_binary(T& obj, Stream& stream) {
+    schema_binary_reader<T> reader(stream);
+    if (!reader.read(obj)) {
+      throw cereal::Exception("Schema binary file has no object in it");
+    }
+  }
+
+}
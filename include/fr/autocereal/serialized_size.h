@@ -0,0 +1,344 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * How many bytes a binary archive is going to write for an object,
+ * worked out without writing it.
+ *
+ * If everything in a type is fixed size -- scalars, enums, std::arrays
+ * of them and records made of nothing else -- serialized_size<T>() is
+ * a compile time constant, and to_binary_array will write one into a
+ * std::array of exactly that size, on the stack if you like.
+ *
+ * For everything else there's serialized_size(obj), which walks the
+ * members the same way saveHelper would and adds up what cereal is
+ * going to write for each: size tags, the optional and smart pointer
+ * flags, shared pointers only the first time they're seen. Anything
+ * we don't know the layout of (maps, classes with their own serialize
+ * and so on) gets written to a stream that just counts the bytes and
+ * throws them away, so the answer's still exact. The shared pointers
+ * we walk ourselves get registered with that same throwaway archive,
+ * so one that turns up both in a member and inside a map is still
+ * only counted once, wherever cereal first writes it. to_binary into a
+ * std::string uses it to allocate the output once, at the right size.
+ *
+ * Sizes are for BinaryOutputArchive, which is what to_binary uses, or
+ * PortableBinaryOutputArchive, which adds a byte for its endianness
+ * flag.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/traits.h>
+
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <spanstream>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+
+namespace fr::autocereal {
+
+  namespace detail::size {
+
+    template <typename Archive>
+    concept IsSizedArchive = std::same_as<Archive, cereal::BinaryOutputArchive>
+      || std::same_as<Archive, cereal::PortableBinaryOutputArchive>;
+
+    // What the archive writes when it's constructed, before any object
+    template <typename Archive>
+    constexpr size_t archiveHeaderBytes() {
+      return std::same_as<Archive, cereal::PortableBinaryOutputArchive> ? 1 : 0;
+    }
+
+    template <typename T>
+    consteval bool isFixed() {
+      if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+        return true;
+      } else if constexpr (IsStdArray<T>) {
+        return isFixed<typename T::value_type>();
+      } else if constexpr (IsPlainRecord<T>) {
+        bool fixed = true;
+        forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+          fixed = fixed && isFixed<member_type_t<Owner, index>>();
+        });
+        return fixed;
+      } else {
+        return false;
+      }
+    }
+
+    template <typename T>
+    consteval size_t fixedBytes() {
+      if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+        return sizeof(T);
+      } else if constexpr (IsStdArray<T>) {
+        return std::tuple_size_v<T> * fixedBytes<typename T::value_type>();
+      } else {
+        size_t bytes = 0;
+        forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+          bytes += fixedBytes<member_type_t<Owner, index>>();
+        });
+        return bytes;
+      }
+    }
+
+    /**
+     * The least a T can ever take up. That's nothing at all for an
+     * empty record or std::array, and for anything we don't know the
+     * layout of, since its own save might not write anything either.
+     */
+
+    template <typename T>
+    consteval size_t minimumBytes() {
+      if constexpr (isFixed<T>()) {
+        return fixedBytes<T>();
+      } else if constexpr (IsString<T> || IsVector<T>) {
+        return sizeof(cereal::size_type);
+      } else if constexpr (IsStdArray<T>) {
+        return std::tuple_size_v<T> * minimumBytes<typename T::value_type>();
+      } else if constexpr (IsOptional<T>) {
+        return sizeof(bool);
+      } else if constexpr (IsUniquePtr<T> && !std::is_polymorphic_v<typename T::element_type>) {
+        return sizeof(uint8_t);
+      } else if constexpr (IsSharedPtr<T> && !std::is_polymorphic_v<typename T::element_type>) {
+        return sizeof(uint32_t);
+      } else if constexpr (IsPlainRecord<T>) {
+        size_t bytes = 0;
+        forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+          bytes += minimumBytes<member_type_t<Owner, index>>();
+        });
+        return bytes;
+      } else {
+        return 0;
+      }
+    }
+
+    /**
+     * Counts what gets written to it and keeps none of it
+     */
+
+    class CountingBuf : public std::streambuf {
+      size_t _count = 0;
+
+    protected:
+      int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+          ++_count;
+        }
+        return traits_type::not_eof(c);
+      }
+
+      std::streamsize xsputn(const char*, std::streamsize count) override {
+        _count += static_cast<size_t>(count);
+        return count;
+      }
+
+    public:
+      size_t count() const {
+        return _count;
+      }
+    };
+
+    /**
+     * Running total for one serialized_size call
+     */
+
+    template <typename Archive>
+    class Counter {
+      struct Fallback {
+        CountingBuf buffer;
+        std::ostream stream{&buffer};
+        Archive ar{stream};
+      };
+
+      std::unique_ptr<Fallback> _fallback;
+
+      Fallback& fallbackArchive() {
+        if (!_fallback) {
+          _fallback = std::make_unique<Fallback>();
+        }
+        return *_fallback;
+      }
+
+    public:
+      size_t bytes = 0;
+
+      /**
+       * True the first time pointer turns up. cereal only writes the
+       * pointee then, so that's when it gets counted. This asks the
+       * fallback archive's own registry, which is also what cereal
+       * checks for shared pointers inside fallback members, so it
+       * doesn't matter which side sees one first.
+       */
+
+      bool firstSighting(const std::shared_ptr<const void>& pointer) {
+        return (fallbackArchive().ar.registerSharedPointer(pointer) & cereal::detail::msb_32bit) != 0;
+      }
+
+      /**
+       * Let cereal write value somewhere that only counts. The archive
+       * sticks around for the whole walk.
+       */
+
+      template <typename T>
+      void fallback(const T& value) {
+        Fallback& sink = fallbackArchive();
+        size_t before = sink.buffer.count();
+        sink.ar(value);
+        bytes += sink.buffer.count() - before;
+      }
+    };
+
+    template <typename Archive, typename T>
+    void addValue(Counter<Archive>& counter, const T& value);
+
+    template <typename Archive, typename T>
+    void addRecord(Counter<Archive>& counter, const T& value) {
+      forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+        constexpr auto info = member_info<Owner, index>();
+        addValue(counter, member_ref_const<Owner, info>(static_cast<const Owner&>(value)));
+      });
+    }
+
+    /**
+     * What cereal's binary save writes for value. The layouts here are
+     * cereal's: a size_type ahead of strings and vectors, a bool for
+     * optionals, a uint8_t for unique_ptrs and a uint32_t id for
+     * shared_ptrs.
+     */
+
+    template <typename Archive, typename T>
+    void addValue(Counter<Archive>& counter, const T& value) {
+      if constexpr (isFixed<T>()) {
+        counter.bytes += fixedBytes<T>();
+      } else if constexpr (IsString<T>) {
+        counter.bytes += sizeof(cereal::size_type) + value.size();
+      } else if constexpr (IsVector<T>) {
+        using Element = typename T::value_type;
+        counter.bytes += sizeof(cereal::size_type);
+        if constexpr (isFixed<Element>()) {
+          counter.bytes += value.size() * fixedBytes<Element>();
+        } else {
+          for (const auto& element : value) {
+            addValue(counter, element);
+          }
+        }
+      } else if constexpr (IsStdArray<T>) {
+        for (const auto& element : value) {
+          addValue(counter, element);
+        }
+      } else if constexpr (IsOptional<T>) {
+        counter.bytes += sizeof(bool);
+        if (value) {
+          addValue(counter, *value);
+        }
+      } else if constexpr (IsUniquePtr<T> && !std::is_polymorphic_v<typename T::element_type>) {
+        counter.bytes += sizeof(uint8_t);
+        if (value) {
+          addValue(counter, *value);
+        }
+      } else if constexpr (IsSharedPtr<T> && !std::is_polymorphic_v<typename T::element_type>) {
+        counter.bytes += sizeof(uint32_t);
+        if (value && counter.firstSighting(value)) {
+          addValue(counter, *value);
+        }
+      } else if constexpr (IsPlainRecord<T>) {
+        addRecord(counter, value);
+      } else {
+        counter.fallback(value);
+      }
+    }
+
+  }
+
+  /**
+   * Types serialized_size can work out at compile time
+   */
+
+  template <typename T>
+  concept HasFixedSerializedSize = detail::size::isFixed<T>();
+
+  /**
+   * Exact binary size of any T, known at compile time
+   */
+
+  template <typename T, typename Archive = cereal::BinaryOutputArchive>
+  requires HasFixedSerializedSize<T> && detail::size::IsSizedArchive<Archive>
+  consteval size_t serialized_size() {
+    return detail::size::archiveHeaderBytes<Archive>() + detail::size::fixedBytes<T>();
+  }
+
+  /**
+   * Exact binary size of obj. Archive comes first here so you can ask
+   * for the portable one without spelling out T.
+   */
+
+  template <typename Archive = cereal::BinaryOutputArchive, typename T>
+  requires detail::size::IsSizedArchive<Archive>
+  size_t serialized_size(const T& obj) {
+    if constexpr (HasFixedSerializedSize<T>) {
+      return serialized_size<T, Archive>();
+    } else {
+      detail::size::Counter<Archive> counter;
+      detail::size::addValue(counter, obj);
+      return detail::size::archiveHeaderBytes<Archive>() + counter.bytes;
+    }
+  }
+
+  /**
+   * Writes a fixed size object into a std::array that's exactly big
+   * enough for it
+   */
+
+  template <typename T>
+  requires HasFixedSerializedSize<T>
+  std::array<char, serialized_size<T>()> to_binary_array(const T& obj) {
+    std::array<char, serialized_size<T>()> bytes;
+    std::ospanstream stream(std::span<char>(bytes));
+    {
+      cereal::BinaryOutputArchive ar(stream);
+      ar(obj);
+    }
+    return bytes;
+  }
+
+  /**
+   * to_binary into a string you hang on to. out is sized once with
+   * serialized_size and then written in place, so there's a single
+   * allocation at most, and none once out has the capacity.
+   */
+
+  template <typename T>
+  void to_binary(const T& obj, std::string& out) {
+    out.resize(serialized_size(obj));
+    std::ospanstream stream(std::span<char>(out.data(), out.size()));
+    {
+      cereal::BinaryOutputArchive ar(stream);
+      ar(obj);
+    }
+    if (!stream || static_cast<size_t>(stream.tellp()) != out.size()) {
+      throw cereal::Exception("Binary output did not match its serialized_size");
+    }
+  }
+
+}
@@ -0,0 +1,192 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * Shared compile-time helpers for the formats that walk reflected
+ * members themselves rather than going through a cereal archive.
+ * cereal works out what to do with a member through overload
+ * resolution. The native formats have to do it with if constexpr,
+ * so the type classification lives here in one place.
+ */
+
+#include <fr/autocereal/autocereal.h>
+
+#include <array>
+#include <memory>
+#include <meta>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fr::autocereal {
+
+  // Defined in lazy.h
+  template <typename T>
+  class lazy;
+
+  namespace detail {
+
+    template <typename T, template <typename...> typename Template>
+    inline constexpr bool isSpecializationOf = false;
+
+    template <template <typename...> typename Template, typename... Args>
+    inline constexpr bool isSpecializationOf<Template<Args...>, Template> = true;
+
+    template <typename T>
+    inline constexpr bool isStdArray = false;
+
+    template <typename T, size_t N>
+    inline constexpr bool isStdArray<std::array<T, N>> = true;
+
+    template <typename T>
+    struct isLazy : std::false_type {};
+
+    template <typename T>
+    struct isLazy<lazy<T>> : std::true_type {};
+
+    // True for anything declared in std or a namespace inside it
+    consteval bool declaredInStd(std::meta::info type) {
+      std::meta::info scope = std::meta::parent_of(std::meta::dealias(type));
+      while (scope != ^^::) {
+        if (scope == ^^std) {
+          return true;
+        }
+        scope = std::meta::parent_of(scope);
+      }
+      return false;
+    }
+
+  }
+
+  /**
+   * Library types the native formats know how to handle. Anything that's
+   * a class and isn't one of these gets treated as a reflected record.
+   */
+
+  template <typename T>
+  concept IsString = std::same_as<T, std::basic_string<char, std::char_traits<char>, typename T::allocator_type>>;
+
+  template <typename T>
+  concept IsVector = detail::isSpecializationOf<T, std::vector>;
+
+  template <typename T>
+  concept IsOptional = detail::isSpecializationOf<T, std::optional>;
+
+  template <typename T>
+  concept IsStdArray = detail::isStdArray<T>;
+
+  template <typename T>
+  concept IsSharedPtr = detail::isSpecializationOf<T, std::shared_ptr>;
+
+  template <typename T>
+  concept IsUniquePtr = detail::isSpecializationOf<T, std::unique_ptr>;
+
+  template <typename T>
+  concept IsScalar = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+  template <typename T>
+  concept IsLazy = detail::isLazy<T>::value;
+
+  template <typename T>
+  concept IsRecord = std::is_class_v<T> && !IsString<T> && !IsVector<T> && !IsOptional<T>
+    && !IsStdArray<T> && !IsSharedPtr<T> && !IsUniquePtr<T>;
+
+  /**
+   * Records that go through autocereal's own save and load, and so get
+   * written member by member, private members and all. Anything with
+   * its own serialize, save or load is left to cereal, and so is
+   * anything from the standard library (std::map and friends), which
+   * cereal's type headers handle. So is lazy, which writes its value
+   * as one blob.
+   */
+
+  template <typename T>
+  concept IsReflectedRecord = IsRecord<T> && !IsLazy<T> && !detail::declaredInStd(^^T)
+    && !cereal::traits::has_member_serialize<T, cereal::BinaryOutputArchive>::value
+    && !cereal::traits::has_member_save<T, cereal::BinaryOutputArchive>::value
+    && !cereal::traits::has_member_load<T, cereal::BinaryInputArchive>::value;
+
+  /**
+   * Reflected records we can also lay out ourselves, because they're
+   * aggregates: nothing in the way of constructors, just members.
+   */
+
+  template <typename T>
+  concept IsPlainRecord = IsReflectedRecord<T> && std::is_aggregate_v<T>;
+
+  /**
+   * Type of a member, by index. Same index rules as member_info.
+   */
+
+  template <typename Class, size_t idx>
+  using member_type_t = [:std::meta::remove_cv(std::meta::type_of(member_info<Class, idx>())):];
+
+  /**
+   * forEachMember visits every serialized member of a class in the
+   * order saveHelper writes them -- parents first, in declaration
+   * order, then the class's own members. fn is called with a
+   * std::type_identity of the class that actually declares the
+   * member and an integral_constant index into that class, which is
+   * everything you need for member_info and member_ref.
+   *
+   * Same index recursion as saveHelper, same reasons.
+   */
+
+  template <typename Class, typename Fn>
+  constexpr void forEachMember(Fn&& fn);
+
+  template <typename Class, typename Fn, size_t index = 0>
+  constexpr void forEachParent(Fn& fn) {
+    if constexpr (index < ClassSingleton<Class>::baseCount()) {
+      using Parent = typename ClassSingleton<Class>::template Parent<index>::Type;
+      forEachMember<Parent>(fn);
+      forEachParent<Class, Fn, index + 1>(fn);
+    }
+  }
+
+  template <typename Class, typename Fn, size_t index = 0>
+  constexpr void forEachOwnMember(Fn& fn) {
+    if constexpr (index < ClassSingleton<Class>::memberCount()) {
+      fn(std::type_identity<Class>{}, std::integral_constant<size_t, index>{});
+      forEachOwnMember<Class, Fn, index + 1>(fn);
+    }
+  }
+
+  template <typename Class, typename Fn>
+  constexpr void forEachMember(Fn&& fn) {
+    forEachParent<Class>(fn);
+    forEachOwnMember<Class>(fn);
+  }
+
+  /**
+   * Number of members forEachMember will visit, parents included.
+   */
+
+  template <typename Class, size_t index = 0>
+  consteval size_t flatMemberCount() {
+    if constexpr (index < ClassSingleton<Class>::baseCount()) {
+      using Parent = typename ClassSingleton<Class>::template Parent<index>::Type;
+      return flatMemberCount<Parent>() + flatMemberCount<Class, index + 1>();
+    } else {
+      return ClassSingleton<Class>::memberCount();
+    }
+  }
+
+}
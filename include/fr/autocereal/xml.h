@@ -0,0 +1,715 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/**
+ * Streaming XML input for reflected types.
+ *
+ * cereal::XMLInputArchive slurps the whole document into memory and
+ * builds a rapidxml DOM of it before the first member gets loaded,
+ * which costs several times the size of the document. from_xml_streaming
+ * reads the same documents with a pull parser instead. It pulls the
+ * stream in through a fixed size buffer and fills members in as their
+ * elements go past, so the only thing it holds on to is the text of the
+ * element it's currently reading.
+ *
+ * It understands the layout cereal's XMLOutputArchive (and so to_xml)
+ * writes: a root element with the object in its first child, one child
+ * element per member named after the member, vector elements as
+ * children with any name, and cereal's ptr_wrapper layout for
+ * std::shared_ptr and std::unique_ptr. Shared pointers that point at
+ * the same object come back pointing at the same object, same as they
+ * do with cereal. Members are matched by name, so they can come in any
+ * order, and elements we don't know get skipped.
+ *
+ * Supported members are the same as the native JSON in json.h: bool,
+ * numbers, enums, std::string, std::vector, std::array, std::optional
+ * (cereal's nullopt/data layout), the smart pointers and nested
+ * reflected structs.
+ */
+
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/lazy.h>
+#include <fr/autocereal/traits.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fr::autocereal {
+
+  /**
+   * Size of the buffer from_xml_streaming reads through
+   */
+
+  inline constexpr size_t XML_READ_BUFFER_BYTES = 64 * 1024;
+
+  namespace detail::xml {
+
+    /**
+     * Pull parser over an XML stream. You walk it element by element:
+     * nextElement opens the next child of the current element (or
+     * closes the current element when there are no more), readText
+     * reads the text of a leaf element and closes it, and skipElement
+     * skips over one you don't care about.
+     *
+     * Comments, processing instructions and a DOCTYPE are skipped.
+     * CDATA sections come through as text. Namespaces aren't anything
+     * special, an element called "a:b" is just called "a:b".
+     */
+
+    class XmlPullReader {
+      std::istream& _stream;
+      std::vector<char> _buffer;
+      size_t _pos = 0;
+      size_t _size = 0;
+      // Bytes we've already been through, for error messages
+      size_t _offset = 0;
+      std::string _name;
+      // Names of the elements we're inside of, so end tags can be
+      // checked. Only as deep as the document is.
+      std::vector<std::string> _open;
+      std::string _attributeName;
+      std::string _attributeValue;
+      // The element nextElement just opened was <name/>, so there's
+      // nothing in it and no end tag to look for
+      bool _emptyPending = false;
+      // The element nextElement just opened had xml:space="preserve"
+      bool _preserveSpace = false;
+      // cereal's shared pointer ids, see readValue
+      std::unordered_map<uint32_t, std::shared_ptr<void>> _sharedPointers;
+
+      static bool isWhitespace(int c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+      }
+
+      static bool isNameEnd(int c) {
+        return isWhitespace(c) || c == '/' || c == '>' || c == '=' || c < 0;
+      }
+
+      bool fill() {
+        if (_pos < _size) {
+          return true;
+        }
+        _offset += _size;
+        _stream.read(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+        _pos = 0;
+        _size = static_cast<size_t>(_stream.gcount());
+        return _size > 0;
+      }
+
+      int peekChar() {
+        return fill() ? static_cast<unsigned char>(_buffer[_pos]) : -1;
+      }
+
+      int getChar() {
+        return fill() ? static_cast<unsigned char>(_buffer[_pos++]) : -1;
+      }
+
+      char need() {
+        int c = getChar();
+        if (c < 0) {
+          fail("unexpected end of document");
+        }
+        return static_cast<char>(c);
+      }
+
+      void skipWhitespace() {
+        while (isWhitespace(peekChar())) {
+          ++_pos;
+        }
+      }
+
+      void expectChar(char expected) {
+        if (need() != expected) {
+          char message[] = "expected 'x'";
+          message[10] = expected;
+          fail(message);
+        }
+      }
+
+      void readName(std::string& out) {
+        out.clear();
+        while (!isNameEnd(peekChar())) {
+          out.push_back(static_cast<char>(_buffer[_pos++]));
+        }
+        if (out.empty()) {
+          fail("expected a name");
+        }
+      }
+
+      // Consumes everything up to and including terminator
+      void skipPast(std::string_view terminator) {
+        std::string window;
+        while (true) {
+          window.push_back(need());
+          if (window.size() > terminator.size()) {
+            window.erase(0, 1);
+          }
+          if (window == terminator) {
+            return;
+          }
+        }
+      }
+
+      // Skips text up to the next '<' without looking at it
+      void skipText() {
+        while (fill()) {
+          const char* begin = _buffer.data() + _pos;
+          const char* lt = static_cast<const char*>(std::memchr(begin, '<', _size - _pos));
+          if (lt != nullptr) {
+            _pos += lt - begin;
+            return;
+          }
+          _pos = _size;
+        }
+      }
+
+      // Called after '&'
+      template <typename String>
+      void readEntity(String& out) {
+        char entity[12];
+        size_t length = 0;
+        char c;
+        while ((c = need()) != ';') {
+          if (length == sizeof(entity)) {
+            fail("entity too long");
+          }
+          entity[length++] = c;
+        }
+        std::string_view name(entity, length);
+        if (name == "lt") {
+          out.push_back('<');
+        } else if (name == "gt") {
+          out.push_back('>');
+        } else if (name == "amp") {
+          out.push_back('&');
+        } else if (name == "quot") {
+          out.push_back('"');
+        } else if (name == "apos") {
+          out.push_back('\'');
+        } else if (length > 1 && name[0] == '#') {
+          bool hex = name[1] == 'x';
+          std::string_view digits = name.substr(hex ? 2 : 1);
+          uint32_t cp = 0;
+          auto result = std::from_chars(digits.data(), digits.data() + digits.size(), cp, hex ? 16 : 10);
+          if (result.ec != std::errc{} || result.ptr != digits.data() + digits.size() || cp > 0x10FFFF) {
+            fail("bad character reference");
+          }
+          appendUtf8(out, cp);
+        } else {
+          fail("unknown entity");
+        }
+      }
+
+      template <typename String>
+      static void appendUtf8(String& out, uint32_t cp) {
+        if (cp < 0x80) {
+          out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+          out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+          out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+          out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+          out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+          out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+          out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+          out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+          out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+          out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+      }
+
+      void readAttributeValue(std::string& out) {
+        char quote = need();
+        if (quote != '"' && quote != '\'') {
+          fail("expected a quoted attribute value");
+        }
+        out.clear();
+        char c;
+        while ((c = need()) != quote) {
+          if (c == '&') {
+            readEntity(out);
+          } else {
+            out.push_back(c);
+          }
+        }
+      }
+
+      // Called after "<!". Returns true for a CDATA section, leaving
+      // its contents for the caller
+      bool skipDeclaration() {
+        if (peekChar() == '-') {
+          ++_pos;
+          expectChar('-');
+          skipPast("-->");
+          return false;
+        }
+        if (peekChar() == '[') {
+          for (char c : std::string_view("[CDATA[")) {
+            expectChar(c);
+          }
+          return true;
+        }
+        // DOCTYPE, possibly with an internal subset in brackets
+        int depth = 0;
+        while (true) {
+          char c = need();
+          if (c == '[') {
+            ++depth;
+          } else if (c == ']') {
+            --depth;
+          } else if (c == '>' && depth <= 0) {
+            return false;
+          }
+        }
+      }
+
+      // Called after "<" with the name next up. Reads the rest of the
+      // start tag and returns true if it was <name/>
+      bool readStartTag() {
+        readName(_name);
+        _preserveSpace = false;
+        while (true) {
+          skipWhitespace();
+          char c = need();
+          if (c == '>') {
+            return false;
+          }
+          if (c == '/') {
+            expectChar('>');
+            return true;
+          }
+          --_pos;
+          readName(_attributeName);
+          skipWhitespace();
+          expectChar('=');
+          skipWhitespace();
+          readAttributeValue(_attributeValue);
+          if (_attributeName == "xml:space") {
+            _preserveSpace = _attributeValue == "preserve";
+          }
+        }
+      }
+
+      // Called after "</"
+      void readEndTag() {
+        readName(_attributeName);
+        skipWhitespace();
+        expectChar('>');
+        if (_open.empty() || _open.back() != _attributeName) {
+          fail("mismatched end tag");
+        }
+        _open.pop_back();
+      }
+
+    public:
+      explicit XmlPullReader(std::istream& stream, size_t bufferSize = XML_READ_BUFFER_BYTES)
+        : _stream(stream), _buffer(std::max<size_t>(bufferSize, 1)) {}
+
+      [[noreturn]] void fail(const char* what) const {
+        throw cereal::Exception(std::string("XML parse error at offset ") + std::to_string(_offset + _pos) + ": " + what);
+      }
+
+      /**
+       * Name of the element nextElement last opened
+       */
+
+      const std::string& name() const {
+        return _name;
+      }
+
+      std::unordered_map<uint32_t, std::shared_ptr<void>>& sharedPointers() {
+        return _sharedPointers;
+      }
+
+      /**
+       * Moves to the next child element of the current one and returns
+       * true, or consumes the current element's end tag and returns
+       * false if there aren't any more. Text in between is ignored.
+       */
+
+      bool nextElement() {
+        if (_emptyPending) {
+          _emptyPending = false;
+          return false;
+        }
+        while (true) {
+          skipText();
+          if (!fill()) {
+            fail("unexpected end of document");
+          }
+          ++_pos;
+          int c = peekChar();
+          if (c == '/') {
+            ++_pos;
+            readEndTag();
+            return false;
+          }
+          if (c == '?') {
+            skipPast("?>");
+          } else if (c == '!') {
+            ++_pos;
+            if (skipDeclaration()) {
+              skipPast("]]>");
+            }
+          } else {
+            _emptyPending = readStartTag();
+            if (!_emptyPending) {
+              _open.push_back(_name);
+            }
+            return true;
+          }
+        }
+      }
+
+      /**
+       * Reads the text of the element nextElement just opened, up to
+       * and including its end tag. Leading and trailing whitespace is
+       * dropped unless the element has xml:space="preserve". out can
+       * be any std::basic_string<char>, whatever its allocator.
+       */
+
+      template <typename String>
+      void readText(String& out) {
+        out.clear();
+        if (_emptyPending) {
+          _emptyPending = false;
+          return;
+        }
+        bool preserve = _preserveSpace;
+        while (true) {
+          if (!fill()) {
+            fail("unexpected end of document");
+          }
+          const char* begin = _buffer.data() + _pos;
+          const char* end = _buffer.data() + _size;
+          const char* stop = begin;
+          while (stop < end && *stop != '<' && *stop != '&') {
+            ++stop;
+          }
+          out.append(begin, stop);
+          _pos += stop - begin;
+          if (stop == end) {
+            continue;
+          }
+          ++_pos;
+          if (*stop == '&') {
+            readEntity(out);
+            continue;
+          }
+          char c = need();
+          if (c == '/') {
+            readEndTag();
+            break;
+          }
+          if (c == '?') {
+            skipPast("?>");
+          } else if (c == '!') {
+            if (skipDeclaration()) {
+              while (true) {
+                out.push_back(need());
+                if (out.ends_with("]]>")) {
+                  out.resize(out.size() - 3);
+                  break;
+                }
+              }
+            }
+          } else {
+            fail("expected text, found an element");
+          }
+        }
+        if (!preserve) {
+          size_t first = 0;
+          while (first < out.size() && isWhitespace(out[first])) {
+            ++first;
+          }
+          size_t last = out.size();
+          while (last > first && isWhitespace(out[last - 1])) {
+            --last;
+          }
+          out.erase(last);
+          out.erase(0, first);
+        }
+      }
+
+      /**
+       * Skips the rest of the element nextElement just opened,
+       * children and all
+       */
+
+      void skipElement() {
+        if (_emptyPending) {
+          _emptyPending = false;
+          return;
+        }
+        size_t depth = 1;
+        while (depth > 0) {
+          if (nextElement()) {
+            ++depth;
+            if (_emptyPending) {
+              _emptyPending = false;
+              --depth;
+            }
+          } else {
+            --depth;
+          }
+        }
+      }
+    };
+
+    template <typename N>
+    void parseNumber(XmlPullReader& in, const std::string& text, N& value) {
+      const char* begin = text.data();
+      const char* end = text.data() + text.size();
+      // from_chars doesn't take a leading '+', ostream doesn't write one
+      // but people do
+      if (begin < end && *begin == '+') {
+        ++begin;
+      }
+      auto result = std::from_chars(begin, end, value);
+      if (result.ec != std::errc{} || result.ptr != end) {
+        in.fail("bad number");
+      }
+    }
+
+    template <typename T>
+    void readRecord(XmlPullReader& in, T& obj);
+
+    /**
+     * Reads the element nextElement just opened into value, and closes
+     * it
+     */
+
+    template <typename V>
+    void readValue(XmlPullReader& in, V& value) {
+      if constexpr (std::same_as<V, bool>) {
+        std::string text;
+        in.readText(text);
+        if (text == "true" || text == "1") {
+          value = true;
+        } else if (text == "false" || text == "0") {
+          value = false;
+        } else {
+          in.fail("expected true or false");
+        }
+      } else if constexpr (std::is_enum_v<V>) {
+        std::string text;
+        in.readText(text);
+        std::underlying_type_t<V> underlying{};
+        parseNumber(in, text, underlying);
+        value = static_cast<V>(underlying);
+      } else if constexpr (std::is_arithmetic_v<V>) {
+        std::string text;
+        in.readText(text);
+        parseNumber(in, text, value);
+      } else if constexpr (IsString<V>) {
+        in.readText(value);
+      } else if constexpr (IsOptional<V>) {
+        // cereal writes <nullopt>bool</nullopt> and then <data> if
+        // there's a value
+        value.reset();
+        while (in.nextElement()) {
+          if (in.name() == "data") {
+            readValue(in, value.emplace());
+          } else {
+            in.skipElement();
+          }
+        }
+      } else if constexpr (IsLazy<V>) {
+        // cereal's XML archive writes the value as <value0>, and we
+        // can't keep the text, so this decodes it straight away
+        auto& inner = LazyAccess::beginDecoded(value);
+        while (in.nextElement()) {
+          if (in.name() == "value0") {
+            readValue(in, inner);
+          } else {
+            in.skipElement();
+          }
+        }
+      } else if constexpr (IsSharedPtr<V> || IsUniquePtr<V>) {
+        using Element = typename V::element_type;
+        value.reset();
+        while (in.nextElement()) {
+          if (in.name() != "ptr_wrapper") {
+            in.skipElement();
+            continue;
+          }
+          while (in.nextElement()) {
+            if (in.name() == "data") {
+              if (!value) {
+                in.fail("ptr_wrapper data without an id");
+              }
+              readValue(in, *value);
+            } else if constexpr (IsSharedPtr<V>) {
+              if (in.name() != "id") {
+                in.skipElement();
+                continue;
+              }
+              // cereal's ids: 0 is null, the high bit marks the first
+              // time it saw a pointer (and so the one with the data),
+              // anything else points back at one we've already read
+              uint32_t id = 0;
+              readValue(in, id);
+              constexpr uint32_t firstTime = 0x80000000;
+              auto& pointers = in.sharedPointers();
+              if (id & firstTime) {
+                value = std::make_shared<Element>();
+                pointers[id & ~firstTime] = value;
+              } else if (id != 0) {
+                auto found = pointers.find(id);
+                if (found == pointers.end()) {
+                  in.fail("shared pointer id we haven't seen");
+                }
+                value = std::static_pointer_cast<Element>(found->second);
+              }
+            } else {
+              if (in.name() != "valid") {
+                in.skipElement();
+                continue;
+              }
+              uint8_t valid = 0;
+              readValue(in, valid);
+              if (valid) {
+                value = std::make_unique<Element>();
+              }
+            }
+          }
+        }
+      } else if constexpr (IsVector<V>) {
+        value.clear();
+        while (in.nextElement()) {
+          if constexpr (std::same_as<typename V::value_type, bool>) {
+            bool element = false;
+            readValue(in, element);
+            value.push_back(element);
+          } else {
+            readValue(in, value.emplace_back());
+          }
+        }
+      } else if constexpr (IsStdArray<V>) {
+        size_t index = 0;
+        while (in.nextElement()) {
+          if (index == value.size()) {
+            in.fail("too many elements for std::array");
+          }
+          readValue(in, value[index++]);
+        }
+        if (index != value.size()) {
+          in.fail("too few elements for std::array");
+        }
+      } else if constexpr (IsRecord<V>) {
+        readRecord(in, value);
+      } else {
+        static_assert(false, "No streaming XML support for this member type");
+      }
+    }
+
+    /**
+     * Name to loader table for a record, built once per type. Same
+     * idea as the one in json.h.
+     */
+
+    template <typename T>
+    class RecordLoaders {
+    public:
+      struct Entry {
+        std::string_view name;
+        void (*load)(XmlPullReader&, T&);
+      };
+
+      static const RecordLoaders& instance() {
+        static const RecordLoaders loaders;
+        return loaders;
+      }
+
+      const std::vector<Entry>& entries() const {
+        return _entries;
+      }
+
+    private:
+      std::vector<Entry> _entries;
+
+      RecordLoaders() {
+        forEachMember<T>([&]<typename Owner, size_t index>(std::type_identity<Owner>, std::integral_constant<size_t, index>) {
+          _entries.push_back({ClassSingleton<Owner>::instance().memberAtIndex(index), [](XmlPullReader& in, T& obj) {
+            constexpr auto info = member_info<Owner, index>();
+            readValue(in, member_ref<Owner, info>(obj));
+          }});
+        });
+      }
+    };
+
+    template <typename T>
+    void readRecord(XmlPullReader& in, T& obj) {
+      const auto& entries = RecordLoaders<T>::instance().entries();
+      size_t expected = 0;
+      while (in.nextElement()) {
+        const std::string& name = in.name();
+        size_t found = entries.size();
+        if (expected < entries.size() && entries[expected].name == name) {
+          found = expected;
+        } else {
+          for (size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].name == name) {
+              found = i;
+              break;
+            }
+          }
+        }
+        if (found < entries.size()) {
+          entries[found].load(in, obj);
+          expected = found + 1;
+        } else {
+          in.skipElement();
+        }
+      }
+    }
+
+  }
+
+  /**
+   * Reads an object out of XML written by to_xml (or anything else
+   * with the same layout) without building a DOM. Reads up to the end
+   * of the root element and no further.
+   */
+
+  template <typename T, typename Stream>
+  requires IsInputStream<Stream>
+  void from_xml_streaming(T& obj, Stream& stream, size_t bufferSize = XML_READ_BUFFER_BYTES) {
+    detail::xml::XmlPullReader in(stream, bufferSize);
+    if (!in.nextElement()) {
+      in.fail("no root element");
+    }
+    if (!in.nextElement()) {
+      in.fail("empty root element");
+    }
+    detail::xml::readValue(in, obj);
+    while (in.nextElement()) {
+      in.skipElement();
+    }
+  }
+
+}
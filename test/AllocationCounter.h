@@ -0,0 +1,49 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Counts heap allocations made on this thread while counting is on.
+ * AllocationCounter.cpp replaces operator new for the whole test
+ * binary, but it only counts anything inside an AllocationCounter's
+ * lifetime.
+ */
+
+namespace allocation_counter {
+  inline thread_local bool counting = false;
+  inline thread_local size_t allocations = 0;
+  inline thread_local size_t bytes = 0;
+}
+
+struct AllocationCounter {
+  AllocationCounter() {
+    allocation_counter::allocations = 0;
+    allocation_counter::bytes = 0;
+    allocation_counter::counting = true;
+  }
+  ~AllocationCounter() {
+    allocation_counter::counting = false;
+  }
+  size_t count() const {
+    return allocation_counter::allocations;
+  }
+  // Total size of everything allocated
+  size_t bytes() const {
+    return allocation_counter::bytes;
+  }
+};
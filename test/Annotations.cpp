@@ -0,0 +1,190 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/chunk_stream.h>
+#include <fr/autocereal/fingerprint.h>
+#include <fr/autocereal/indexed.h>
+#include <fr/autocereal/schema_binary.h>
+#include <cereal/types/string.hpp>
+#include <mutex>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct AnnotatedPlain {
+  int id;
+  std::string name;
+};
+
+struct Annotated {
+  int id;
+  std::string name;
+  [[=fr::autocereal::skip]] std::mutex lock;
+  [[=fr::autocereal::transient]] std::vector<int> cache;
+  [[=fr::autocereal::skip]] int untouched = 0;
+};
+
+struct AnnotatedChild : public Annotated {
+  double weight;
+  [[=fr::autocereal::transient]] std::string lowerName;
+};
+
+// Nothing of its own left to serialize once the annotated members
+// are taken out, just its parent
+
+struct AnnotatedCached : public AnnotatedPlain {
+  [[=fr::autocereal::skip]] std::mutex lock;
+  [[=fr::autocereal::transient]] std::vector<int> cache;
+};
+
+static_assert(fr::autocereal::ClassSingleton<Annotated>::memberCount() == 2);
+static_assert(fr::autocereal::ClassSingleton<AnnotatedCached>::memberCount() == 0);
+static_assert(fr::autocereal::ClassSingleton<AnnotatedChild>::memberCount() == 1);
+static_assert(fr::autocereal::schema_fingerprint<Annotated>() == fr::autocereal::schema_fingerprint<AnnotatedPlain>());
+
+TEST(Annotations, LeftOutOfJson) {
+  Annotated obj;
+  obj.id = 7;
+  obj.name = "seven";
+  obj.cache = {1, 2, 3};
+  obj.untouched = 42;
+
+  std::stringstream stream;
+  fr::autocereal::to_json(obj, stream);
+  std::string json = stream.str();
+  ASSERT_NE(json.find("\"name\""), std::string::npos);
+  ASSERT_EQ(json.find("lock"), std::string::npos);
+  ASSERT_EQ(json.find("cache"), std::string::npos);
+  ASSERT_EQ(json.find("untouched"), std::string::npos);
+}
+
+TEST(Annotations, BinaryMatchesUnannotated) {
+  Annotated obj;
+  obj.id = 7;
+  obj.name = "seven";
+  obj.cache = {1, 2, 3};
+
+  AnnotatedPlain plain{7, "seven"};
+
+  std::stringstream annotatedStream;
+  std::stringstream plainStream;
+  fr::autocereal::to_binary(obj, annotatedStream);
+  fr::autocereal::to_binary(plain, plainStream);
+  ASSERT_EQ(annotatedStream.str(), plainStream.str());
+}
+
+TEST(Annotations, TransientResetOnLoad) {
+  AnnotatedChild obj;
+  obj.id = 3;
+  obj.name = "Three";
+  obj.weight = 1.5;
+
+  std::stringstream stream;
+  fr::autocereal::to_binary(obj, stream);
+
+  AnnotatedChild copy;
+  copy.cache = {9, 9, 9};
+  copy.lowerName = "stale";
+  copy.untouched = 11;
+  fr::autocereal::from_binary(copy, stream);
+
+  ASSERT_EQ(copy.id, 3);
+  ASSERT_EQ(copy.name, "Three");
+  ASSERT_EQ(copy.weight, 1.5);
+  ASSERT_TRUE(copy.cache.empty());
+  ASSERT_TRUE(copy.lowerName.empty());
+  ASSERT_EQ(copy.untouched, 11);
+}
+
+TEST(Annotations, NoMembersOfItsOwn) {
+  AnnotatedCached obj;
+  obj.id = 5;
+  obj.name = "five";
+  obj.cache = {1, 2};
+
+  std::stringstream stream;
+  fr::autocereal::to_binary(obj, stream);
+  std::stringstream plainStream;
+  fr::autocereal::to_binary(AnnotatedPlain{5, "five"}, plainStream);
+  ASSERT_EQ(stream.str(), plainStream.str());
+
+  AnnotatedCached copy;
+  copy.cache = {9};
+  fr::autocereal::from_binary(copy, stream);
+  ASSERT_EQ(copy.id, 5);
+  ASSERT_EQ(copy.name, "five");
+  ASSERT_TRUE(copy.cache.empty());
+
+  std::stringstream json;
+  fr::autocereal::to_json(obj, json);
+  AnnotatedCached fromJson;
+  fromJson.cache = {9};
+  fr::autocereal::from_json(fromJson, json);
+  ASSERT_EQ(fromJson.name, "five");
+  ASSERT_TRUE(fromJson.cache.empty());
+}
+
+// The binary loaders that walk the member list themselves reset
+// transients the same as a plain from_binary does
+
+static void makeStale(AnnotatedChild& copy) {
+  copy.cache = {9, 9, 9};
+  copy.lowerName = "stale";
+}
+
+TEST(Annotations, TransientResetByOtherBinaryLoads) {
+  AnnotatedChild obj;
+  obj.id = 3;
+  obj.name = "Three";
+  obj.weight = 1.5;
+
+  {
+    // A different type, so the schema reader has to migrate
+    std::stringstream stream;
+    fr::autocereal::to_schema_binary(AnnotatedPlain{3, "Three"}, stream);
+    AnnotatedChild copy;
+    makeStale(copy);
+    fr::autocereal::from_schema_binary(copy, stream);
+    ASSERT_EQ(copy.name, "Three");
+    ASSERT_TRUE(copy.cache.empty());
+    ASSERT_TRUE(copy.lowerName.empty());
+  }
+  {
+    std::stringstream stream;
+    fr::autocereal::to_indexed_binary(obj, stream);
+    AnnotatedChild copy;
+    makeStale(copy);
+    fr::autocereal::from_indexed_binary(copy, stream);
+    ASSERT_EQ(copy.weight, 1.5);
+    ASSERT_TRUE(copy.cache.empty());
+    ASSERT_TRUE(copy.lowerName.empty());
+  }
+  {
+    AnnotatedChild copy;
+    makeStale(copy);
+    fr::autocereal::chunk_loader<AnnotatedChild> loader(copy);
+    for (auto chunk : fr::autocereal::serialize_chunks(obj)) {
+      loader.feed(chunk);
+    }
+    loader.finish();
+    ASSERT_EQ(copy.weight, 1.5);
+    ASSERT_TRUE(copy.cache.empty());
+    ASSERT_TRUE(copy.lowerName.empty());
+  }
+}
@@ -0,0 +1,138 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/arrow.h>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct ArrowBase {
+  int32_t id;
+};
+
+struct ArrowRow : public ArrowBase {
+  double score;
+  std::string name;
+  std::optional<int64_t> maybe;
+  bool flag;
+  std::optional<std::string> note;
+};
+
+TEST(ArrowIpc, RoundTrip) {
+  std::vector<ArrowRow> rows;
+  for (int i = 0; i < 10; ++i) {
+    ArrowRow row;
+    row.id = i;
+    row.score = i * 1.5;
+    row.name = "row" + std::to_string(i);
+    if (i % 3 != 0) {
+      row.maybe = i * 100;
+    }
+    row.flag = (i % 2) == 0;
+    if (i % 4 != 0) {
+      row.note = "note" + std::to_string(i);
+    }
+    rows.push_back(row);
+  }
+
+  std::stringstream stream;
+  // Small batches so we get more than one record batch
+  fr::autocereal::to_arrow_ipc(rows, stream, 4);
+
+  std::string bytes = stream.str();
+  ASSERT_EQ(bytes.substr(0, 6), "ARROW1");
+  ASSERT_EQ(bytes.substr(bytes.size() - 6), "ARROW1");
+
+  std::vector<ArrowRow> copy;
+  fr::autocereal::from_arrow_ipc(copy, stream);
+
+  ASSERT_EQ(copy.size(), rows.size());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    ASSERT_EQ(copy[i].id, rows[i].id);
+    ASSERT_EQ(copy[i].score, rows[i].score);
+    ASSERT_EQ(copy[i].name, rows[i].name);
+    ASSERT_EQ(copy[i].maybe, rows[i].maybe);
+    ASSERT_EQ(copy[i].flag, rows[i].flag);
+    ASSERT_EQ(copy[i].note, rows[i].note);
+  }
+}
+
+// Columns are matched by name, so a struct with a subset of the
+// columns can still read the file.
+
+struct ArrowSubset {
+  std::string name;
+  int32_t id;
+};
+
+TEST(ArrowIpc, ColumnsByName) {
+  std::vector<ArrowRow> rows(3);
+  for (int i = 0; i < 3; ++i) {
+    rows[i].id = i + 1;
+    rows[i].name = "n" + std::to_string(i);
+  }
+
+  std::stringstream stream;
+  fr::autocereal::to_arrow_ipc(rows, stream);
+
+  std::vector<ArrowSubset> subset;
+  fr::autocereal::from_arrow_ipc(subset, stream);
+  ASSERT_EQ(subset.size(), 3);
+  ASSERT_EQ(subset[2].id, 3);
+  ASSERT_EQ(subset[2].name, "n2");
+}
+
+struct ArrowWrongType {
+  std::string id;
+};
+
+TEST(ArrowIpc, TypeMismatchThrows) {
+  std::vector<ArrowRow> rows(1);
+  std::stringstream stream;
+  fr::autocereal::to_arrow_ipc(rows, stream);
+
+  std::vector<ArrowWrongType> wrong;
+  ASSERT_THROW(fr::autocereal::from_arrow_ipc(wrong, stream), cereal::Exception);
+}
+
+// from_arrow_ipc never reads the footer, so the metadata it does read
+// is what gets corrupted: the schema message's table is pointed at a
+// vtable far before the start of the buffer, which used to wrap around
+// the bounds check
+
+TEST(ArrowIpc, CorruptMetadataThrows) {
+  std::vector<ArrowRow> rows(1);
+  std::stringstream stream;
+  fr::autocereal::to_arrow_ipc(rows, stream);
+  std::string good = stream.str();
+
+  // Magic, continuation marker and length come before the metadata
+  const size_t metadata = 16;
+  uint32_t root;
+  std::memcpy(&root, good.data() + metadata, sizeof(root));
+  for (int32_t soffset : {int32_t{1000000}, int32_t{-1000000}, std::numeric_limits<int32_t>::min()}) {
+    std::string bad = good;
+    std::memcpy(bad.data() + metadata + root, &soffset, sizeof(soffset));
+    std::istringstream in(bad);
+    std::vector<ArrowRow> copy;
+    ASSERT_THROW(fr::autocereal::from_arrow_ipc(copy, in), cereal::Exception);
+  }
+}
@@ -0,0 +1,76 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/async_file.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct AsyncFileSnapshot {
+  int generation;
+  std::string label;
+  std::vector<double> samples;
+};
+
+// Small buffers so the two of them get swapped back and forth a lot
+
+TEST(AsyncFile, SnapshotRoundTrip) {
+  auto path = std::filesystem::temp_directory_path() / "autocereal_async_file_test.bin";
+  AsyncFileSnapshot snapshot{3, "snapshot", {}};
+  for (int i = 0; i < 100000; ++i) {
+    snapshot.samples.push_back(i * 0.5);
+  }
+
+  fr::autocereal::to_binary_file(snapshot, path, {.bufferSize = 4096, .fsyncOnClose = true});
+
+  std::stringstream expected;
+  fr::autocereal::to_binary(snapshot, expected);
+  ASSERT_EQ(std::filesystem::file_size(path), expected.str().size());
+
+  std::ifstream file(path, std::ios::binary);
+  AsyncFileSnapshot copy;
+  fr::autocereal::from_binary(copy, file);
+  file.close();
+  std::filesystem::remove(path);
+
+  ASSERT_EQ(copy.generation, 3);
+  ASSERT_EQ(copy.label, "snapshot");
+  ASSERT_EQ(copy.samples, snapshot.samples);
+}
+
+TEST(AsyncFile, StreamWrites) {
+  auto path = std::filesystem::temp_directory_path() / "autocereal_async_file_stream.txt";
+  {
+    fr::autocereal::AsyncFileOutputStream stream(path);
+    stream << "written " << 2 << " ways";
+    stream.flush();
+    stream.put('!');
+    stream.close();
+  }
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  file.close();
+  std::filesystem::remove(path);
+  ASSERT_EQ(contents.str(), "written 2 ways!");
+}
+
+TEST(AsyncFile, BadPathThrows) {
+  ASSERT_THROW(fr::autocereal::AsyncFileOutputStream("/nonexistent/directory/file.bin"), cereal::Exception);
+}
@@ -0,0 +1,66 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+#include <gtest/gtest.h>
+#include <fr/autocereal/batch.h>
+#include "SampleRecords.h"
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// A batch is laid out just like the vector it came from
+
+TEST(Batch, MatchesVectorArchive) {
+  auto records = makeSampleRecords(1000);
+
+  std::stringstream batchBinary, vectorBinary;
+  fr::autocereal::to_binary_batch(std::span<const SampleRecord>(records).subspan(0, 1000), batchBinary);
+  fr::autocereal::to_binary(records, vectorBinary);
+  ASSERT_EQ(batchBinary.str(), vectorBinary.str());
+
+  std::stringstream vectorJson;
+  fr::autocereal::to_json(records, vectorJson);
+  ASSERT_EQ(fr::autocereal::to_json_batch(records), vectorJson.str());
+}
+
+TEST(Batch, RoundTrip) {
+  auto records = makeSampleRecords(2500);
+
+  std::stringstream binary;
+  fr::autocereal::to_binary_batch(records, binary);
+  std::vector<SampleRecord> copy;
+  fr::autocereal::from_binary_batch(copy, binary);
+  expectSameRecords(copy, records);
+
+  // Reading a smaller batch into the same vector
+  std::string json = fr::autocereal::to_json_batch(std::span<const SampleRecord>(records).first(3));
+  fr::autocereal::from_json_batch(copy, json);
+  ASSERT_EQ(copy.size(), 3);
+  ASSERT_EQ(copy[2].id, 2);
+  ASSERT_EQ(copy[2].name, "record \"2\"");
+}
+
+TEST(Batch, EmptyBatch) {
+  std::vector<SampleRecord> none;
+  std::stringstream binary;
+  fr::autocereal::to_binary_batch(none, binary);
+  std::vector<SampleRecord> copy = makeSampleRecords(2);
+  fr::autocereal::from_binary_batch(copy, binary);
+  ASSERT_TRUE(copy.empty());
+
+  fr::autocereal::from_json_batch(copy, fr::autocereal::to_json_batch(none));
+  ASSERT_TRUE(copy.empty());
+}
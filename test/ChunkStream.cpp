@@ -0,0 +1,132 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/chunk_stream.h>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct ChunkStreamInner {
+  int a;
+  std::string s;
+};
+
+struct ChunkStreamRecord {
+  int id;
+  std::string name;
+  std::vector<double> values;
+  std::vector<ChunkStreamInner> inners;
+  std::vector<bool> flags;
+  std::shared_ptr<ChunkStreamInner> first;
+  std::shared_ptr<ChunkStreamInner> second;
+};
+
+static ChunkStreamRecord makeRecord() {
+  ChunkStreamRecord record;
+  record.id = 7;
+  record.name = "chunky";
+  for (int i = 0; i < 500; ++i) {
+    record.values.push_back(i * 0.25);
+    record.inners.push_back({i, std::string(i % 13, 'x')});
+    record.flags.push_back(i % 3 == 0);
+  }
+  record.first = std::make_shared<ChunkStreamInner>(1, "shared");
+  record.second = record.first;
+  return record;
+}
+
+static std::string joined(const ChunkStreamRecord& record, fr::autocereal::ChunkFormat format, size_t chunkSize,
+                          size_t& chunks) {
+  std::string out;
+  chunks = 0;
+  for (auto chunk : fr::autocereal::serialize_chunks(record, format, chunkSize)) {
+    out.append(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+    ++chunks;
+  }
+  return out;
+}
+
+static void expectSame(const ChunkStreamRecord& copy, const ChunkStreamRecord& record) {
+  ASSERT_EQ(copy.id, record.id);
+  ASSERT_EQ(copy.name, record.name);
+  ASSERT_EQ(copy.values, record.values);
+  ASSERT_EQ(copy.inners.size(), record.inners.size());
+  ASSERT_EQ(copy.inners[499].s, record.inners[499].s);
+  ASSERT_EQ(copy.flags, record.flags);
+  ASSERT_NE(copy.first, nullptr);
+  ASSERT_EQ(copy.first->s, "shared");
+  ASSERT_EQ(copy.first, copy.second);
+}
+
+TEST(ChunkStream, BinaryMatchesToBinary) {
+  ChunkStreamRecord record = makeRecord();
+  std::stringstream whole;
+  fr::autocereal::to_binary(record, whole);
+
+  for (size_t chunkSize : {1, 100, 4096, 1 << 20}) {
+    size_t chunks = 0;
+    ASSERT_EQ(joined(record, fr::autocereal::ChunkFormat::Binary, chunkSize, chunks), whole.str());
+    ASSERT_EQ(chunks, (whole.str().size() + chunkSize - 1) / chunkSize);
+  }
+}
+
+TEST(ChunkStream, JsonMatchesToJson) {
+  ChunkStreamRecord record = makeRecord();
+  std::stringstream whole;
+  fr::autocereal::to_json(record, whole);
+
+  size_t chunks = 0;
+  ASSERT_EQ(joined(record, fr::autocereal::ChunkFormat::Json, 256, chunks), whole.str());
+  ASSERT_GT(chunks, 1);
+}
+
+// Feed sizes that don't line up with the chunks or the elements
+
+TEST(ChunkStream, LoaderRoundTrip) {
+  ChunkStreamRecord record = makeRecord();
+
+  for (auto format : {fr::autocereal::ChunkFormat::Binary, fr::autocereal::ChunkFormat::Json}) {
+    size_t chunks = 0;
+    std::string bytes = joined(record, format, 512, chunks);
+    for (size_t feedSize : {1, 7, 1000, 1 << 20}) {
+      ChunkStreamRecord copy;
+      fr::autocereal::chunk_loader<ChunkStreamRecord> loader(copy, format);
+      for (size_t at = 0; at < bytes.size(); at += feedSize) {
+        size_t size = std::min(feedSize, bytes.size() - at);
+        loader.feed(std::as_bytes(std::span<const char>(bytes.data() + at, size)));
+      }
+      ASSERT_TRUE(loader.done());
+      loader.finish();
+      expectSame(copy, record);
+    }
+  }
+}
+
+TEST(ChunkStream, TruncatedThrows) {
+  ChunkStreamRecord record = makeRecord();
+  size_t chunks = 0;
+  std::string bytes = joined(record, fr::autocereal::ChunkFormat::Binary, 512, chunks);
+
+  ChunkStreamRecord copy;
+  fr::autocereal::chunk_loader<ChunkStreamRecord> loader(copy);
+  loader.feed(std::as_bytes(std::span<const char>(bytes.data(), bytes.size() - 3)));
+  ASSERT_FALSE(loader.done());
+  ASSERT_THROW(loader.finish(), cereal::Exception);
+}
@@ -0,0 +1,88 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/chunked.h>
+#include "SampleRecords.h"
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(ChunkedBinary, RoundTrip) {
+  // 10007 doesn't divide evenly into chunks, so the last one is short
+  auto records = makeSampleRecords(10007);
+  std::stringstream stream;
+  fr::autocereal::to_chunked_binary(records, stream, 1000, 4);
+
+  for (size_t threads : {1, 4}) {
+    stream.seekg(0);
+    std::vector<SampleRecord> copy;
+    fr::autocereal::from_chunked_binary(copy, stream, threads);
+    expectSameRecords(copy, records);
+  }
+}
+
+// Thread count shouldn't change what gets written
+
+TEST(ChunkedBinary, SameBytesAnyThreadCount) {
+  auto records = makeSampleRecords(5000);
+  std::span<const SampleRecord> view(records);
+  std::stringstream one, many;
+  fr::autocereal::to_chunked_binary(view, one, 512, 1);
+  fr::autocereal::to_chunked_binary(view, many, 512, 8);
+  ASSERT_EQ(one.str(), many.str());
+}
+
+TEST(ChunkedBinary, Empty) {
+  std::vector<SampleRecord> records;
+  std::stringstream stream;
+  fr::autocereal::to_chunked_binary(records, stream);
+  std::vector<SampleRecord> copy = makeSampleRecords(3);
+  fr::autocereal::from_chunked_binary(copy, stream);
+  ASSERT_TRUE(copy.empty());
+}
+
+// Nothing gets written for these, so every chunk is empty
+
+struct ChunkedNothing {};
+
+TEST(ChunkedBinary, EmptyElements) {
+  std::vector<ChunkedNothing> records(2500);
+  std::stringstream stream;
+  fr::autocereal::to_chunked_binary(records, stream, 1000);
+
+  std::vector<ChunkedNothing> copy;
+  fr::autocereal::from_chunked_binary(copy, stream);
+  ASSERT_EQ(copy.size(), 2500);
+}
+
+TEST(ChunkedBinary, BadInputThrows) {
+  std::vector<SampleRecord> copy;
+  std::stringstream garbage("this is not a chunked binary container");
+  ASSERT_THROW(fr::autocereal::from_chunked_binary(copy, garbage), cereal::Exception);
+
+  auto records = makeSampleRecords(100);
+  std::stringstream stream;
+  fr::autocereal::to_chunked_binary(records, stream, 10);
+  std::string data = stream.str();
+  // Keep the footer (ten chunk entries and the trailer) but lose the
+  // back half of the chunks it points at
+  size_t footerSize = 24 * 10 + 24;
+  std::string chunks = data.substr(0, data.size() - footerSize);
+  std::stringstream damaged(chunks.substr(0, chunks.size() / 2) + data.substr(data.size() - footerSize));
+  ASSERT_THROW(fr::autocereal::from_chunked_binary(copy, damaged), cereal::Exception);
+}
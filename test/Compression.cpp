@@ -0,0 +1,108 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/compression.h>
+#include "SampleRecords.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+static void binaryRoundTrip(fr::autocereal::Compression compression) {
+  auto records = makeSampleRecords(2000);
+  std::stringstream stream;
+  fr::autocereal::to_binary(records, stream, compression);
+
+  std::stringstream uncompressed;
+  fr::autocereal::to_binary(records, uncompressed);
+  ASSERT_LT(stream.str().size(), uncompressed.str().size());
+
+  std::vector<SampleRecord> copy;
+  fr::autocereal::from_compressed<cereal::BinaryInputArchive>(copy, stream);
+  expectSameRecords(copy, records);
+}
+
+#if defined(AUTOCEREAL_HAS_ZSTD)
+
+TEST(Compression, ZstdBinary) {
+  binaryRoundTrip({fr::autocereal::Codec::Zstd, 3, 4096, 0});
+}
+
+TEST(Compression, ZstdWorkers) {
+  binaryRoundTrip({fr::autocereal::Codec::Zstd, 1, 1 << 20, 2});
+}
+
+TEST(Compression, ZstdJson) {
+  auto records = makeSampleRecords(2000);
+  std::stringstream stream;
+  fr::autocereal::to_json(records, stream, {fr::autocereal::Codec::Zstd, 5});
+
+  std::vector<SampleRecord> copy;
+  fr::autocereal::from_compressed<cereal::JSONInputArchive>(copy, stream);
+  expectSameRecords(copy, records);
+}
+
+TEST(Compression, TruncatedThrows) {
+  std::stringstream stream;
+  fr::autocereal::to_binary(makeSampleRecords(2000), stream, fr::autocereal::Compression{});
+  std::string data = stream.str();
+  std::stringstream truncated(data.substr(0, data.size() / 2));
+
+  std::vector<SampleRecord> copy;
+  ASSERT_THROW(fr::autocereal::from_compressed<cereal::BinaryInputArchive>(copy, truncated), cereal::Exception);
+}
+
+#endif
+
+#if defined(AUTOCEREAL_HAS_LZ4)
+
+TEST(Compression, Lz4Binary) {
+  binaryRoundTrip({fr::autocereal::Codec::Lz4, 0, 64 * 1024, 0});
+}
+
+#endif
+
+#if defined(AUTOCEREAL_HAS_ZSTD)
+
+// Appending to a file that already has a frame in it
+
+TEST(Compression, ConcatenatedFrames) {
+  std::stringstream stream;
+  {
+    fr::autocereal::CompressedOutputStream out(stream);
+    out << "first ";
+  }
+  {
+    fr::autocereal::CompressedOutputStream out(stream);
+    out << "second";
+  }
+
+  fr::autocereal::DecompressedInputStream in(stream);
+  std::string first, second;
+  in >> first >> second;
+  ASSERT_EQ(first, "first");
+  ASSERT_EQ(second, "second");
+}
+
+#endif
+
+TEST(Compression, GarbageThrows) {
+  std::stringstream stream("this is not compressed");
+  fr::autocereal::DecompressedInputStream in(stream);
+  std::string word;
+  in.exceptions(std::ios::badbit);
+  ASSERT_THROW(in >> word, cereal::Exception);
+}
@@ -0,0 +1,150 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/csv.h>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct CsvRow {
+  int id;
+  double score;
+  std::string name;
+  std::optional<long> maybe;
+  bool flag;
+  std::optional<std::string> note;
+};
+
+TEST(Csv, Header) {
+  std::vector<CsvRow> rows;
+  auto csv = fr::autocereal::to_csv(rows);
+  ASSERT_EQ(csv, "id,score,name,maybe,flag,note\n");
+}
+
+TEST(Csv, Quoting) {
+  std::vector<CsvRow> rows{{1, 0.5, "comma, \"quotes\"\nand a newline", std::nullopt, true, ""}};
+  auto csv = fr::autocereal::to_csv(rows);
+  ASSERT_EQ(csv, "id,score,name,maybe,flag,note\n1,0.5,\"comma, \"\"quotes\"\"\nand a newline\",,true,\"\"\n");
+
+  std::vector<CsvRow> copy;
+  fr::autocereal::from_csv(copy, csv);
+  ASSERT_EQ(copy.size(), 1);
+  ASSERT_EQ(copy[0].name, rows[0].name);
+  ASSERT_FALSE(copy[0].maybe.has_value());
+  // "" is an empty string, not a missing one
+  ASSERT_TRUE(copy[0].note.has_value());
+  ASSERT_EQ(*copy[0].note, "");
+}
+
+// Big enough that from_csv splits it across threads, with quoted
+// newlines scattered around to trip up the chunk boundaries.
+
+TEST(Csv, ParallelRoundTrip) {
+  std::vector<CsvRow> rows;
+  for (int i = 0; i < 200000; ++i) {
+    CsvRow row{i, i * 0.1, "name" + std::to_string(i), std::nullopt, i % 2 == 0, std::nullopt};
+    if (i % 7 == 0) {
+      row.name = "line one\nline \"two\", three";
+    }
+    if (i % 3 != 0) {
+      row.maybe = i * 1000L;
+    }
+    if (i % 5 != 0) {
+      row.note = std::to_string(i);
+    }
+    rows.push_back(row);
+  }
+
+  std::stringstream stream;
+  fr::autocereal::to_csv(rows, stream);
+
+  std::vector<CsvRow> copy;
+  fr::autocereal::from_csv(copy, stream, 8);
+  ASSERT_EQ(copy.size(), rows.size());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    ASSERT_EQ(copy[i].id, rows[i].id);
+    ASSERT_EQ(copy[i].score, rows[i].score);
+    ASSERT_EQ(copy[i].name, rows[i].name);
+    ASSERT_EQ(copy[i].maybe, rows[i].maybe);
+    ASSERT_EQ(copy[i].flag, rows[i].flag);
+    ASSERT_EQ(copy[i].note, rows[i].note);
+  }
+}
+
+// One thread and several have to agree, on good input and on a
+// stray quote, which would throw off the parallel split's quote
+// parity if it were let through
+
+TEST(Csv, ThreadCountsAgree) {
+  std::string csv = "id,name\n";
+  for (int i = 0; i < 400000; ++i) {
+    csv += std::to_string(i);
+    csv += (i % 11 == 0) ? ",\"a \"\"quoted\"\"\nname\"\n" : ",plain\n";
+  }
+
+  std::vector<CsvRow> single;
+  fr::autocereal::from_csv(single, csv, 1);
+  std::vector<CsvRow> parallel;
+  fr::autocereal::from_csv(parallel, csv, 8);
+  ASSERT_EQ(single.size(), 400000);
+  ASSERT_EQ(parallel.size(), single.size());
+  for (size_t i = 0; i < single.size(); ++i) {
+    ASSERT_EQ(parallel[i].id, single[i].id);
+    ASSERT_EQ(parallel[i].name, single[i].name);
+  }
+
+  std::string stray = csv;
+  stray.insert(stray.find("\n300000,plain\n") + 8, "x\"y");
+  for (size_t threads : {1, 8}) {
+    std::vector<CsvRow> rows;
+    ASSERT_THROW(fr::autocereal::from_csv(rows, stray, threads), cereal::Exception);
+  }
+}
+
+// With one column an empty optional is a blank line, and that's
+// still a row
+
+struct CsvNote {
+  std::optional<std::string> note;
+};
+
+TEST(Csv, SingleColumn) {
+  std::vector<CsvNote> rows{{""}, {std::nullopt}, {"x"}, {std::nullopt}};
+  auto csv = fr::autocereal::to_csv(rows);
+  ASSERT_EQ(csv, "note\n\"\"\n\nx\n\n");
+
+  std::vector<CsvNote> copy;
+  fr::autocereal::from_csv(copy, csv);
+  ASSERT_EQ(copy.size(), rows.size());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    ASSERT_EQ(copy[i].note, rows[i].note);
+  }
+}
+
+TEST(Csv, ColumnsByName) {
+  std::vector<CsvRow> rows;
+  fr::autocereal::from_csv(rows, "flag,unknown,id\r\ntrue,whatever,42\r\n");
+  ASSERT_EQ(rows.size(), 1);
+  ASSERT_EQ(rows[0].id, 42);
+  ASSERT_TRUE(rows[0].flag);
+}
+
+TEST(Csv, BadValueThrows) {
+  std::vector<CsvRow> rows;
+  ASSERT_THROW(fr::autocereal::from_csv(rows, "id\nnot a number\n"), cereal::Exception);
+}
@@ -0,0 +1,193 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/fingerprint.h>
+#include <cereal/types/string.hpp>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct PrintBase {
+  uint32_t id;
+};
+
+struct PrintOriginal : public PrintBase {
+  std::string name;
+  double weight;
+  std::vector<int32_t> samples;
+};
+
+// Same layout under another name
+struct PrintRenamed : public PrintBase {
+  std::string name;
+  double weight;
+  std::vector<int32_t> samples;
+};
+
+struct PrintReordered : public PrintBase {
+  double weight;
+  std::string name;
+  std::vector<int32_t> samples;
+};
+
+struct PrintRetyped : public PrintBase {
+  std::string name;
+  float weight;
+  std::vector<int32_t> samples;
+};
+
+struct PrintMemberRenamed : public PrintBase {
+  std::string label;
+  double weight;
+  std::vector<int32_t> samples;
+};
+
+// id moved out of the base and into the class
+struct PrintFlattened {
+  uint32_t id;
+  std::string name;
+  double weight;
+  std::vector<int32_t> samples;
+};
+
+struct PrintTree {
+  int value;
+  std::vector<std::shared_ptr<PrintTree>> children;
+};
+
+// Not aggregates, but autocereal still writes them member by member,
+// so their members have to count
+class PrintPrivate {
+  uint32_t _id = 0;
+  std::string _name;
+
+public:
+  PrintPrivate() = default;
+  PrintPrivate(uint32_t id, std::string name) : _id(id), _name(std::move(name)) {}
+
+  uint32_t id() const {
+    return _id;
+  }
+};
+
+class PrintPrivateRetyped {
+  uint64_t _id = 0;
+  std::string _name;
+
+public:
+  PrintPrivateRetyped() = default;
+};
+
+class PrintPrivateAdded {
+  uint32_t _id = 0;
+  std::string _name;
+  double _extra = 0.0;
+
+public:
+  PrintPrivateAdded() = default;
+};
+
+static_assert(fr::autocereal::schema_fingerprint<PrintPrivate>() != fr::autocereal::schema_fingerprint<PrintPrivateRetyped>());
+static_assert(fr::autocereal::schema_fingerprint<PrintPrivate>() != fr::autocereal::schema_fingerprint<PrintPrivateAdded>());
+static_assert(fr::autocereal::schema_fingerprint<PrintOriginal>() == fr::autocereal::schema_fingerprint<PrintRenamed>());
+static_assert(fr::autocereal::schema_fingerprint<PrintOriginal>() != fr::autocereal::schema_fingerprint<PrintReordered>());
+static_assert(fr::autocereal::schema_fingerprint<PrintOriginal>() != fr::autocereal::schema_fingerprint<PrintRetyped>());
+static_assert(fr::autocereal::schema_fingerprint<PrintOriginal>() != fr::autocereal::schema_fingerprint<PrintMemberRenamed>());
+static_assert(fr::autocereal::schema_fingerprint<PrintOriginal>() != fr::autocereal::schema_fingerprint<PrintFlattened>());
+static_assert(fr::autocereal::schema_fingerprint<PrintTree>() != 0);
+
+static PrintOriginal makeOriginal() {
+  PrintOriginal original;
+  original.id = 3;
+  original.name = "original";
+  original.weight = 1.25;
+  original.samples = {1, 2, 3};
+  return original;
+}
+
+TEST(Fingerprint, RoundTrip) {
+  std::stringstream stream;
+  fr::autocereal::to_checked_binary(makeOriginal(), stream);
+
+  PrintOriginal copy;
+  fr::autocereal::from_checked_binary(copy, stream);
+  ASSERT_EQ(copy.id, 3);
+  ASSERT_EQ(copy.name, "original");
+  ASSERT_EQ(copy.samples.size(), 3);
+}
+
+TEST(Fingerprint, RenamedTypeStillLoads) {
+  std::stringstream stream;
+  fr::autocereal::to_checked_binary(makeOriginal(), stream);
+
+  PrintRenamed copy;
+  fr::autocereal::from_checked_binary(copy, stream);
+  ASSERT_EQ(copy.weight, 1.25);
+}
+
+TEST(Fingerprint, MismatchThrowsBeforeLoading) {
+  std::stringstream stream;
+  fr::autocereal::to_checked_binary(makeOriginal(), stream);
+
+  PrintRetyped copy;
+  copy.name = "untouched";
+  try {
+    fr::autocereal::from_checked_binary(copy, stream);
+    FAIL() << "Expected a SchemaMismatch";
+  } catch (const fr::autocereal::SchemaMismatch& e) {
+    ASSERT_EQ(e.expected, fr::autocereal::schema_fingerprint<PrintRetyped>());
+    ASSERT_EQ(e.found, fr::autocereal::schema_fingerprint<PrintOriginal>());
+    ASSERT_NE(std::string(e.what()).find("PrintRetyped"), std::string::npos);
+  }
+  ASSERT_EQ(copy.name, "untouched");
+}
+
+TEST(Fingerprint, IsACerealException) {
+  std::stringstream stream;
+  fr::autocereal::to_checked_binary(makeOriginal(), stream);
+  PrintReordered copy;
+  ASSERT_THROW(fr::autocereal::from_checked_binary(copy, stream), cereal::Exception);
+}
+
+TEST(Fingerprint, InJson) {
+  std::stringstream stream;
+  {
+    cereal::JSONOutputArchive ar(stream);
+    fr::autocereal::save_fingerprint<PrintOriginal>(ar);
+    ar(cereal::make_nvp("value", makeOriginal()));
+  }
+  cereal::JSONInputArchive ar(stream);
+  ASSERT_THROW(fr::autocereal::check_fingerprint<PrintMemberRenamed>(ar), fr::autocereal::SchemaMismatch);
+}
+
+TEST(Fingerprint, ClassWithPrivateMembers) {
+  std::stringstream stream;
+  fr::autocereal::to_checked_binary(PrintPrivate(8, "private"), stream);
+  std::string bytes = stream.str();
+
+  std::stringstream same(bytes);
+  PrintPrivate copy;
+  fr::autocereal::from_checked_binary(copy, same);
+  ASSERT_EQ(copy.id(), 8);
+
+  std::stringstream changed(bytes);
+  PrintPrivateAdded added;
+  ASSERT_THROW(fr::autocereal::from_checked_binary(added, changed), fr::autocereal::SchemaMismatch);
+}
@@ -0,0 +1,93 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/indexed.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct IndexedBase {
+  std::string name;
+};
+
+struct IndexedIndexes : public IndexedBase {
+  std::vector<uint64_t> keys;
+  std::vector<double> weights;
+  std::vector<std::string> labels;
+  int version;
+};
+
+static IndexedIndexes makeIndexes() {
+  IndexedIndexes indexes;
+  indexes.name = "startup";
+  indexes.version = 4;
+  for (size_t i = 0; i < 100000; ++i) {
+    indexes.keys.push_back(i * 7);
+    indexes.weights.push_back(i / 3.0);
+  }
+  for (size_t i = 0; i < 5000; ++i) {
+    indexes.labels.push_back("label " + std::to_string(i));
+  }
+  return indexes;
+}
+
+static void checkIndexes(const IndexedIndexes& copy) {
+  auto indexes = makeIndexes();
+  ASSERT_EQ(copy.name, indexes.name);
+  ASSERT_EQ(copy.version, indexes.version);
+  ASSERT_EQ(copy.keys, indexes.keys);
+  ASSERT_EQ(copy.weights, indexes.weights);
+  ASSERT_EQ(copy.labels, indexes.labels);
+}
+
+TEST(IndexedBinary, StreamRoundTrip) {
+  std::stringstream stream;
+  fr::autocereal::to_indexed_binary(makeIndexes(), stream);
+
+  for (size_t threads : {1, 4}) {
+    stream.seekg(0);
+    IndexedIndexes copy;
+    fr::autocereal::from_indexed_binary(copy, stream, threads);
+    checkIndexes(copy);
+  }
+}
+
+TEST(IndexedBinary, FileRoundTrip) {
+  auto path = std::filesystem::temp_directory_path() / "autocereal_indexed_binary_test.bin";
+  {
+    std::ofstream file(path, std::ios::binary);
+    fr::autocereal::to_indexed_binary(makeIndexes(), file);
+  }
+  IndexedIndexes copy;
+  fr::autocereal::from_indexed_binary(copy, path, 4);
+  std::filesystem::remove(path);
+  checkIndexes(copy);
+}
+
+TEST(IndexedBinary, BadInputThrows) {
+  IndexedIndexes copy;
+  std::stringstream garbage("definitely not an indexed binary object");
+  ASSERT_THROW(fr::autocereal::from_indexed_binary(copy, garbage), cereal::Exception);
+
+  // Right magic, wrong member count
+  IndexedBase base{"base"};
+  std::stringstream other;
+  fr::autocereal::to_indexed_binary(base, other);
+  ASSERT_THROW(fr::autocereal::from_indexed_binary(copy, other), cereal::Exception);
+}
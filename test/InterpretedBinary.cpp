@@ -0,0 +1,138 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * The interpreter gets called directly here rather than by defining
+ * AUTOCEREAL_INTERPRETED_BINARY, which would change cereal::save out
+ * from under the other test files in this binary. to_binary is the
+ * template path, so the two get checked against each other.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/interpreter.h>
+#include <cereal/types/map.hpp>
+#include <cereal/types/optional.hpp>
+#include <cereal/types/string.hpp>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+enum class InterpretedKind : uint16_t { Small, Large };
+
+struct InterpretedPoint {
+  int32_t x;
+  int32_t y;
+  int32_t z;
+};
+
+struct InterpretedBase {
+  uint64_t id;
+  std::string owner;
+};
+
+struct InterpretedMessage : public InterpretedBase {
+  InterpretedKind kind;
+  bool urgent;
+  double weight;
+  std::array<float, 3> scale;
+  InterpretedPoint origin;
+  std::vector<double> readings;
+  std::vector<InterpretedPoint> path;
+  std::vector<std::string> tags;
+  std::optional<std::string> note;
+  std::map<std::string, int> counts;
+};
+
+static InterpretedMessage makeMessage() {
+  InterpretedMessage message;
+  message.id = 77;
+  message.owner = "someone with a name longer than the small string buffer";
+  message.kind = InterpretedKind::Large;
+  message.urgent = true;
+  message.weight = 2.5;
+  message.scale = {1.0f, 2.0f, 3.0f};
+  message.origin = {1, 2, 3};
+  message.readings = {0.5, 1.5, 2.5, 3.5};
+  message.path = {{4, 5, 6}, {7, 8, 9}};
+  message.tags = {"a", "b", "c"};
+  message.note = "a note";
+  message.counts = {{"x", 1}, {"y", 2}};
+  return message;
+}
+
+static std::string interpretedBytes(const InterpretedMessage& message) {
+  std::ostringstream stream;
+  {
+    cereal::BinaryOutputArchive ar(stream);
+    fr::autocereal::detail::interp::saveObject(ar, message);
+  }
+  return stream.str();
+}
+
+TEST(InterpretedBinary, SameBytesAsTemplates) {
+  InterpretedMessage message = makeMessage();
+  std::ostringstream stream;
+  fr::autocereal::to_binary(message, stream);
+  ASSERT_EQ(interpretedBytes(message), stream.str());
+}
+
+TEST(InterpretedBinary, RoundTrip) {
+  InterpretedMessage message = makeMessage();
+  std::istringstream stream(interpretedBytes(message));
+  InterpretedMessage copy;
+  {
+    cereal::BinaryInputArchive ar(stream);
+    fr::autocereal::detail::interp::loadObject(ar, copy);
+  }
+  ASSERT_EQ(copy.id, 77);
+  ASSERT_EQ(copy.owner, message.owner);
+  ASSERT_EQ(copy.kind, InterpretedKind::Large);
+  ASSERT_TRUE(copy.urgent);
+  ASSERT_EQ(copy.weight, 2.5);
+  ASSERT_EQ(copy.scale[2], 3.0f);
+  ASSERT_EQ(copy.origin.z, 3);
+  ASSERT_EQ(copy.readings, message.readings);
+  ASSERT_EQ(copy.path.size(), 2);
+  ASSERT_EQ(copy.path[1].y, 8);
+  ASSERT_EQ(copy.tags, message.tags);
+  ASSERT_EQ(copy.note, message.note);
+  ASSERT_EQ(copy.counts, message.counts);
+}
+
+TEST(InterpretedBinary, ReadsTemplateOutput) {
+  InterpretedMessage message = makeMessage();
+  std::stringstream stream;
+  fr::autocereal::to_binary(message, stream);
+  InterpretedMessage copy;
+  {
+    cereal::BinaryInputArchive ar(stream);
+    fr::autocereal::detail::interp::loadObject(ar, copy);
+  }
+  ASSERT_EQ(copy.path[0].x, 4);
+  ASSERT_EQ(copy.counts.at("y"), 2);
+}
+
+TEST(InterpretedBinary, AdjacentScalarsMerge) {
+  // x, y and z have no padding between them, so they're one copy
+  const auto& built = fr::autocereal::detail::interp::Descriptor<InterpretedPoint>::built;
+  ASSERT_EQ(built.used, 1);
+  ASSERT_EQ(built.ops[0].code, fr::autocereal::detail::interp::OpCode::Raw);
+  ASSERT_EQ(built.ops[0].size, sizeof(InterpretedPoint));
+}
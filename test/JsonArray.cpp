@@ -0,0 +1,101 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/json.h>
+#include "SampleRecords.h"
+#include <span>
+#include <string>
+#include <vector>
+
+// Has to match the single threaded writer exactly, including around
+// the slice boundaries
+
+TEST(JsonArray, MatchesSingleThreaded) {
+  for (size_t count : {size_t{0}, size_t{1}, fr::autocereal::JSON_ARRAY_SLICE_ELEMENTS,
+                       fr::autocereal::JSON_ARRAY_SLICE_ELEMENTS * 5 + 3}) {
+    auto records = makeSampleRecords(count);
+    std::string expected;
+    fr::autocereal::detail::json::writeValue(expected, records);
+
+    for (size_t threads : {1, 3, 8}) {
+      ASSERT_EQ(fr::autocereal::to_json_array(records, threads), expected);
+    }
+  }
+}
+
+TEST(JsonArray, ReadsBack) {
+  auto records = makeSampleRecords(20000);
+  std::string json = fr::autocereal::to_json_array(std::span<const SampleRecord>(records), 4);
+
+  std::vector<SampleRecord> copy;
+  fr::autocereal::detail::json::JsonReader in(json);
+  fr::autocereal::detail::json::readValue(in, copy);
+  ASSERT_TRUE(in.atEnd());
+  expectSameRecords(copy, records);
+}
+
+TEST(JsonArray, ParallelParse) {
+  auto records = makeSampleRecords(fr::autocereal::JSON_PARSE_BLOCK_ELEMENTS * 40 + 7);
+  std::string json = fr::autocereal::to_json_array(records);
+
+  for (size_t threads : {1, 4, 16}) {
+    std::vector<SampleRecord> copy(3);
+    fr::autocereal::from_json_array(copy, json, threads);
+    expectSameRecords(copy, records);
+  }
+}
+
+// What to_json actually writes, optionals in cereal's nullopt/data
+// layout and all
+
+TEST(JsonArray, ParallelParseCerealWrapper) {
+  auto records = makeSampleRecords(600);
+  std::string json = fr::autocereal::to_json(records);
+
+  for (size_t threads : {1, 4}) {
+    std::vector<SampleRecord> copy;
+    fr::autocereal::from_json_array(copy, json, threads);
+    expectSameRecords(copy, records);
+  }
+}
+
+// Elements already in the vector only carry over when asked to
+
+TEST(JsonArray, ReuseOfExistingElements) {
+  std::string json = R"([{"id":1},{"id":2,"name":"two"}])";
+  for (size_t threads : {1, 4}) {
+    std::vector<SampleRecord> reset(2);
+    reset[0].name = "old";
+    fr::autocereal::from_json_array(reset, json, threads);
+    ASSERT_EQ(reset[0].id, 1);
+    ASSERT_TRUE(reset[0].name.empty());
+
+    std::vector<SampleRecord> inPlace(2);
+    inPlace[0].name = "old";
+    fr::autocereal::from_json_array(inPlace, json, threads, fr::autocereal::JsonReuse::InPlace);
+    ASSERT_EQ(inPlace[0].id, 1);
+    ASSERT_EQ(inPlace[0].name, "old");
+    ASSERT_EQ(inPlace[1].name, "two");
+  }
+}
+
+TEST(JsonArray, ParallelParseErrors) {
+  std::vector<SampleRecord> copy;
+  ASSERT_THROW(fr::autocereal::from_json_array(copy, std::string_view("[{\"id\":1},"), 4), cereal::Exception);
+  ASSERT_THROW(fr::autocereal::from_json_array(copy, std::string_view("[{\"id\":\"x\"}]"), 4), cereal::Exception);
+  ASSERT_THROW(fr::autocereal::from_json_array(copy, std::string_view("[{\"id\":1}] extra"), 4), cereal::Exception);
+}
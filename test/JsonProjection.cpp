@@ -0,0 +1,98 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/json_projection.h>
+#include <cereal/types/string.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct ProjectionHeader {
+  std::string route;
+};
+
+struct ProjectionMessage : public ProjectionHeader {
+  int priority;
+  std::vector<std::string> payload;
+  double weight;
+};
+
+static ProjectionMessage makeMessage() {
+  ProjectionMessage message;
+  message.route = "orders.eu";
+  message.priority = 4;
+  message.payload.assign(1000, std::string(64, 'x'));
+  message.weight = 2.5;
+  return message;
+}
+
+static std::string nativeJson(const ProjectionMessage& message) {
+  std::string json;
+  fr::autocereal::detail::json::writeValue(json, message);
+  return json;
+}
+
+TEST(JsonProjection, CompileTimeMembers) {
+  std::string json = nativeJson(makeMessage());
+
+  ProjectionMessage copy;
+  copy.weight = -1.0;
+  fr::autocereal::from_json<ProjectionMessage, &ProjectionMessage::route, &ProjectionMessage::priority>(copy, json);
+  ASSERT_EQ(copy.route, "orders.eu");
+  ASSERT_EQ(copy.priority, 4);
+  ASSERT_TRUE(copy.payload.empty());
+  ASSERT_EQ(copy.weight, -1.0);
+}
+
+TEST(JsonProjection, RuntimeMask) {
+  std::string json = nativeJson(makeMessage());
+
+  fr::autocereal::json_projection<ProjectionMessage> projection{"weight", "route"};
+  ASSERT_EQ(projection.count(), 2);
+
+  ProjectionMessage copy;
+  copy.priority = 99;
+  fr::autocereal::from_json(copy, json, projection);
+  ASSERT_EQ(copy.route, "orders.eu");
+  ASSERT_EQ(copy.weight, 2.5);
+  ASSERT_EQ(copy.priority, 99);
+  ASSERT_TRUE(copy.payload.empty());
+}
+
+TEST(JsonProjection, UnknownNameThrows) {
+  ASSERT_THROW(fr::autocereal::json_projection<ProjectionMessage>({"nope"}), cereal::Exception);
+}
+
+// Reading stops once the wanted members are in, so junk after them
+// doesn't matter
+
+TEST(JsonProjection, StopsEarly) {
+  std::string json = R"({"route":"a.b","priority":1,"payload":[)";
+  ProjectionMessage copy;
+  fr::autocereal::from_json<ProjectionMessage, &ProjectionMessage::priority>(copy, json);
+  ASSERT_EQ(copy.priority, 1);
+}
+
+TEST(JsonProjection, CerealWrapper) {
+  std::stringstream stream;
+  fr::autocereal::to_json(makeMessage(), stream);
+
+  ProjectionMessage copy;
+  fr::autocereal::from_json<ProjectionMessage, &ProjectionMessage::weight>(copy, stream.str());
+  ASSERT_EQ(copy.weight, 2.5);
+  ASSERT_TRUE(copy.route.empty());
+}
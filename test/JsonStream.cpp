@@ -0,0 +1,137 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/json_stream.h>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct JsonStreamInner {
+  int a;
+  std::string s;
+};
+
+struct JsonStreamBase {
+  int id;
+};
+
+struct JsonStreamRecord : public JsonStreamBase {
+  std::string text;
+  double ratio;
+  std::vector<JsonStreamInner> inners;
+  std::vector<bool> flags;
+  std::shared_ptr<JsonStreamInner> first;
+  std::shared_ptr<JsonStreamInner> second;
+  std::unique_ptr<JsonStreamInner> owned;
+};
+
+static JsonStreamRecord makeRecord() {
+  JsonStreamRecord record;
+  record.id = 3;
+  record.text = "tab\there \"quoted\" \xc3\xa9";
+  record.ratio = 2.5;
+  for (int i = 0; i < 20; ++i) {
+    record.inners.push_back({i, "inner " + std::to_string(i)});
+  }
+  record.flags = {true, false, true};
+  record.first = std::make_shared<JsonStreamInner>(1, "shared");
+  record.second = record.first;
+  record.owned = std::make_unique<JsonStreamInner>(2, "owned");
+  return record;
+}
+
+static void feedInPieces(JsonStreamRecord& copy, std::string_view json, size_t piece) {
+  fr::autocereal::json_stream_reader<JsonStreamRecord> reader(copy);
+  for (size_t offset = 0; offset < json.size(); offset += piece) {
+    reader.feed(json.substr(offset, piece));
+  }
+  ASSERT_TRUE(reader.done());
+  reader.finish();
+}
+
+// Every way of splitting the document across chunks should give the
+// same answer
+
+TEST(JsonStream, ReadsToJsonOutputInPieces) {
+  JsonStreamRecord record = makeRecord();
+  std::string json = fr::autocereal::to_json(record);
+
+  for (size_t piece : {1, 2, 3, 5, 64, 100000}) {
+    JsonStreamRecord copy;
+    feedInPieces(copy, json, piece);
+    ASSERT_EQ(copy.id, record.id);
+    ASSERT_EQ(copy.text, record.text);
+    ASSERT_EQ(copy.ratio, record.ratio);
+    ASSERT_EQ(copy.inners.size(), record.inners.size());
+    ASSERT_EQ(copy.inners[19].s, "inner 19");
+    ASSERT_EQ(copy.flags, record.flags);
+    ASSERT_NE(copy.first, nullptr);
+    ASSERT_EQ(copy.first->s, "shared");
+    ASSERT_EQ(copy.first, copy.second);
+    ASSERT_NE(copy.owned, nullptr);
+    ASSERT_EQ(copy.owned->a, 2);
+  }
+}
+
+TEST(JsonStream, NativeLayout) {
+  std::stringstream stream("{\"extra\":{\"nested\":[1,{\"x\":null}]},\"inners\":[{\"s\":\"b\",\"a\":9}],"
+                           "\"owned\":{\"a\":4,\"s\":\"\"},\"first\":null,\"id\":8}");
+  JsonStreamRecord copy;
+  fr::autocereal::from_json_stream(copy, stream, fr::autocereal::JsonLayout::Native, 7);
+  ASSERT_EQ(copy.id, 8);
+  ASSERT_EQ(copy.inners.size(), 1);
+  ASSERT_EQ(copy.inners[0].a, 9);
+  ASSERT_EQ(copy.inners[0].s, "b");
+  ASSERT_NE(copy.owned, nullptr);
+  ASSERT_EQ(copy.owned->a, 4);
+  ASSERT_EQ(copy.first, nullptr);
+}
+
+struct JsonStreamPmr {
+  std::pmr::string name;
+  std::pmr::vector<std::pmr::string> lines;
+};
+
+TEST(JsonStream, PmrStrings) {
+  std::stringstream stream(R"({"lines":["one","t\"wo"],"name":"a name long enough to allocate"})");
+  JsonStreamPmr copy;
+  fr::autocereal::from_json_stream(copy, stream, fr::autocereal::JsonLayout::Native, 5);
+  ASSERT_EQ(copy.name, "a name long enough to allocate");
+  ASSERT_EQ(copy.lines.size(), 2);
+  ASSERT_EQ(copy.lines[1], "t\"wo");
+}
+
+TEST(JsonStream, IncompleteOrMalformedThrows) {
+  JsonStreamRecord copy;
+  {
+    fr::autocereal::json_stream_reader<JsonStreamRecord> reader(copy);
+    reader.feed(std::string_view("{\"value0\": {\"id\": 1"));
+    ASSERT_THROW(reader.finish(), cereal::Exception);
+  }
+  {
+    fr::autocereal::json_stream_reader<JsonStreamRecord> reader(copy);
+    ASSERT_THROW(reader.feed(std::string_view("{\"value0\": {\"id\": \"one\"}}")), cereal::Exception);
+  }
+  {
+    fr::autocereal::json_stream_reader<JsonStreamRecord> reader(copy);
+    ASSERT_THROW(reader.feed(std::string_view("{\"value0\": {\"id\": 1]}")), cereal::Exception);
+  }
+}
@@ -0,0 +1,132 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/json.h>
+#include <fr/autocereal/lazy.h>
+#include <cereal/types/string.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct LazyBody {
+  std::string text;
+  std::vector<int> values;
+};
+
+struct LazyMessage {
+  int id;
+  fr::autocereal::lazy<LazyBody> body;
+  std::string trailer;
+};
+
+static LazyMessage makeMessage() {
+  LazyMessage message;
+  message.id = 12;
+  message.body = LazyBody{"body text", {1, 2, 3}};
+  message.trailer = "end";
+  return message;
+}
+
+TEST(Lazy, BinaryDecodesOnAccess) {
+  std::stringstream stream;
+  fr::autocereal::to_binary(makeMessage(), stream);
+
+  LazyMessage copy;
+  fr::autocereal::from_binary(copy, stream);
+  ASSERT_EQ(copy.id, 12);
+  ASSERT_EQ(copy.trailer, "end");
+  ASSERT_FALSE(copy.body.decoded());
+
+  ASSERT_EQ(copy.body->text, "body text");
+  ASSERT_TRUE(copy.body.decoded());
+  ASSERT_EQ(copy.body->values, (std::vector<int>{1, 2, 3}));
+}
+
+// An undecoded lazy gets written back out as the bytes it came in as
+
+TEST(Lazy, BinaryPassThrough) {
+  std::stringstream first;
+  fr::autocereal::to_binary(makeMessage(), first);
+  std::string original = first.str();
+
+  LazyMessage copy;
+  fr::autocereal::from_binary(copy, first);
+
+  std::stringstream second;
+  fr::autocereal::to_binary(copy, second);
+  ASSERT_FALSE(copy.body.decoded());
+  ASSERT_EQ(second.str(), original);
+}
+
+TEST(Lazy, ChangedValueIsReencoded) {
+  std::stringstream first;
+  fr::autocereal::to_binary(makeMessage(), first);
+
+  LazyMessage copy;
+  fr::autocereal::from_binary(copy, first);
+  copy.body->text = "changed";
+
+  std::stringstream second;
+  fr::autocereal::to_binary(copy, second);
+  LazyMessage again;
+  fr::autocereal::from_binary(again, second);
+  ASSERT_EQ(again.body->text, "changed");
+}
+
+TEST(Lazy, NativeJson) {
+  std::string json;
+  fr::autocereal::detail::json::writeValue(json, makeMessage());
+  ASSERT_EQ(json, R"({"id":12,"body":{"text":"body text","values":[1,2,3]},"trailer":"end"})");
+
+  LazyMessage copy;
+  fr::autocereal::detail::json::JsonReader in(json);
+  fr::autocereal::detail::json::readValue(in, copy);
+  ASSERT_EQ(copy.trailer, "end");
+  ASSERT_FALSE(copy.body.decoded());
+
+  std::string again;
+  fr::autocereal::detail::json::writeValue(again, copy);
+  ASSERT_EQ(again, json);
+  ASSERT_EQ(copy.body->values.size(), 3);
+}
+
+TEST(Lazy, CerealJson) {
+  std::stringstream stream;
+  fr::autocereal::to_json(makeMessage(), stream);
+
+  LazyMessage copy;
+  fr::autocereal::from_json(copy, stream);
+  ASSERT_TRUE(copy.body.decoded());
+  ASSERT_EQ(copy.body->text, "body text");
+}
+
+// The native reader takes to_json's {"value0": ...} around a lazy
+// member and still leaves it undecoded
+
+TEST(Lazy, CerealJsonThroughNativeReader) {
+  std::vector<LazyMessage> messages(3, makeMessage());
+  std::string json = fr::autocereal::to_json(messages);
+
+  std::vector<LazyMessage> copy;
+  fr::autocereal::from_json_array(copy, json, 2);
+  ASSERT_EQ(copy.size(), 3);
+  ASSERT_EQ(copy[2].trailer, "end");
+  ASSERT_FALSE(copy[2].body.decoded());
+  ASSERT_EQ(copy[2].body->text, "body text");
+  ASSERT_EQ(copy[2].body->values, (std::vector<int>{1, 2, 3}));
+}
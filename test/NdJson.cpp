@@ -0,0 +1,122 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/ndjson.h>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct NdJsonInner {
+  int a;
+  std::string s;
+};
+
+struct NdJsonBase {
+  int id;
+};
+
+struct NdJsonRecord : public NdJsonBase {
+  std::string text;
+  std::vector<NdJsonInner> inners;
+  std::optional<double> maybe;
+  std::shared_ptr<NdJsonInner> pointer;
+};
+
+static_assert(std::ranges::input_range<fr::autocereal::ndjson_reader<NdJsonRecord>>);
+
+TEST(NdJson, OneObjectPerLine) {
+  NdJsonRecord record;
+  record.id = 7;
+  record.text = "quote \" and\nnewline";
+  record.inners = {{1, "one"}};
+
+  std::stringstream stream;
+  {
+    fr::autocereal::ndjson_writer<NdJsonRecord> writer(stream);
+    writer << record << record;
+  }
+
+  std::string expected = "{\"id\":7,\"text\":\"quote \\\" and\\nnewline\",\"inners\":[{\"a\":1,\"s\":\"one\"}],"
+    "\"maybe\":null,\"pointer\":null}\n";
+  ASSERT_EQ(stream.str(), expected + expected);
+}
+
+TEST(NdJson, RoundTrip) {
+  std::vector<NdJsonRecord> records(100);
+  for (int i = 0; i < 100; ++i) {
+    records[i].id = i;
+    records[i].text = "record " + std::to_string(i);
+    records[i].inners.resize(i % 3, NdJsonInner{i, "inner"});
+    if (i % 2 == 0) {
+      records[i].maybe = i / 4.0;
+    }
+    if (i % 5 == 0) {
+      records[i].pointer = std::make_shared<NdJsonInner>(i, "pointed at");
+    }
+  }
+
+  std::stringstream stream;
+  {
+    fr::autocereal::ndjson_writer<NdJsonRecord> writer(stream);
+    for (const auto& record : records) {
+      writer.write(record);
+    }
+  }
+
+  size_t count = 0;
+  for (const NdJsonRecord& copy : fr::autocereal::ndjson_reader<NdJsonRecord>(stream)) {
+    const auto& original = records[count++];
+    ASSERT_EQ(copy.id, original.id);
+    ASSERT_EQ(copy.text, original.text);
+    ASSERT_EQ(copy.inners.size(), original.inners.size());
+    ASSERT_EQ(copy.maybe, original.maybe);
+    ASSERT_EQ(copy.pointer == nullptr, original.pointer == nullptr);
+    if (copy.pointer) {
+      ASSERT_EQ(copy.pointer->s, original.pointer->s);
+    }
+  }
+  ASSERT_EQ(count, records.size());
+}
+
+// Lines from somewhere else -- keys out of order, keys we don't know
+// about, whitespace, blank lines.
+
+TEST(NdJson, ForeignLines) {
+  std::stringstream stream("{ \"text\" : \"\\u00e9\", \"extra\": {\"x\": [1, \"]\"]}, \"id\": 3 }\r\n\n{\"id\":4}\n");
+  fr::autocereal::ndjson_reader<NdJsonRecord> reader(stream);
+  NdJsonRecord record;
+
+  ASSERT_TRUE(reader.read(record));
+  ASSERT_EQ(record.id, 3);
+  ASSERT_EQ(record.text, "\xc3\xa9");
+
+  ASSERT_TRUE(reader.read(record));
+  ASSERT_EQ(record.id, 4);
+  ASSERT_EQ(record.text, "");
+
+  ASSERT_FALSE(reader.read(record));
+}
+
+TEST(NdJson, MalformedLineThrows) {
+  std::stringstream stream("{\"id\": nope}\n");
+  fr::autocereal::ndjson_reader<NdJsonRecord> reader(stream);
+  NdJsonRecord record;
+  ASSERT_THROW(reader.read(record), cereal::Exception);
+}
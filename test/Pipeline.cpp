@@ -0,0 +1,76 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+#include <gtest/gtest.h>
+#include <fr/autocereal/pipeline.h>
+#include "SampleRecords.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+// A queue depth of 1 keeps the workers right on the writer's heels
+
+TEST(Pipeline, RoundTrip) {
+  auto records = makeSampleRecords(10000);
+
+  for (size_t depth : {0, 1}) {
+    fr::autocereal::PipelineOptions options;
+    options.batchSize = 333;
+    options.threads = 4;
+    options.queueDepth = depth;
+
+    std::stringstream stream;
+    auto stats = fr::autocereal::to_binary_pipeline(records, stream, options);
+    ASSERT_EQ(stats.items, records.size());
+    ASSERT_EQ(stats.batches, 31);
+    ASSERT_EQ(stats.writtenBytes, stream.str().size());
+    ASSERT_EQ(stats.serializedBytes, stats.writtenBytes);
+
+    std::vector<SampleRecord> copy;
+    fr::autocereal::from_binary_pipeline(copy, stream, options);
+    expectSameRecords(copy, records);
+  }
+}
+
+TEST(Pipeline, Empty) {
+  std::vector<SampleRecord> none;
+  std::stringstream stream;
+  auto stats = fr::autocereal::to_binary_pipeline(none, stream);
+  ASSERT_EQ(stats.batches, 0);
+  ASSERT_TRUE(stream.str().empty());
+
+  std::vector<SampleRecord> copy;
+  fr::autocereal::from_binary_pipeline(copy, stream);
+  ASSERT_TRUE(copy.empty());
+}
+
+#if defined(AUTOCEREAL_HAS_ZSTD)
+
+TEST(Pipeline, Compressed) {
+  auto records = makeSampleRecords(10000);
+  fr::autocereal::PipelineOptions options;
+  options.batchSize = 1000;
+  options.compression = fr::autocereal::Compression{fr::autocereal::Codec::Zstd};
+
+  std::stringstream stream;
+  auto stats = fr::autocereal::to_binary_pipeline(records, stream, options);
+  ASSERT_LT(stats.writtenBytes, stats.serializedBytes);
+
+  std::vector<SampleRecord> copy;
+  fr::autocereal::from_binary_pipeline(copy, stream, options);
+  expectSameRecords(copy, records);
+}
+
+#endif
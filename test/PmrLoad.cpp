@@ -0,0 +1,129 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/json.h>
+#include <cereal/types/string.hpp>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct PmrLoadTag {
+  std::pmr::string key;
+  std::pmr::string value;
+};
+
+struct PmrLoadMessage {
+  int id;
+  std::pmr::string body;
+  std::pmr::vector<std::pmr::string> lines;
+  std::pmr::vector<PmrLoadTag> tags;
+};
+
+static std::string messageJson() {
+  PmrLoadMessage message;
+  message.id = 9;
+  message.body = "a body long enough to need an allocation of its own";
+  message.lines = {"first line of the message, also fairly long", "second"};
+  message.tags.push_back({"content-type", "application/x-something-rather-long"});
+  return fr::autocereal::to_json(message);
+}
+
+TEST(PmrLoad, EverythingFromTheArena) {
+  std::string json = messageJson();
+  std::pmr::monotonic_buffer_resource arena;
+
+  PmrLoadMessage copy;
+  fr::autocereal::from_json(copy, json, &arena);
+
+  ASSERT_EQ(copy.id, 9);
+  ASSERT_EQ(copy.body, "a body long enough to need an allocation of its own");
+  ASSERT_EQ(copy.body.get_allocator().resource(), &arena);
+  ASSERT_EQ(copy.lines.get_allocator().resource(), &arena);
+  ASSERT_EQ(copy.lines.size(), 2);
+  ASSERT_EQ(copy.lines[0].get_allocator().resource(), &arena);
+  ASSERT_EQ(copy.tags.size(), 1);
+  ASSERT_EQ(copy.tags[0].value, "application/x-something-rather-long");
+  ASSERT_EQ(copy.tags[0].value.get_allocator().resource(), &arena);
+}
+
+TEST(PmrLoad, ScopeEndsWithTheLoad) {
+  std::string json = messageJson();
+  std::pmr::monotonic_buffer_resource arena;
+
+  PmrLoadMessage first;
+  fr::autocereal::from_json(first, json, &arena);
+
+  // No resource this time, so nothing gets moved onto the arena
+  PmrLoadMessage second;
+  fr::autocereal::from_json(second, json);
+  ASSERT_EQ(second.body.get_allocator().resource(), std::pmr::get_default_resource());
+  ASSERT_EQ(second.body, first.body);
+}
+
+// The native reader in json.h, which ndjson, from_json_array,
+// projections and lazy members all go through
+
+TEST(PmrLoad, NativeJson) {
+  PmrLoadMessage message;
+  message.id = 6;
+  message.body = "escaped \"quotes\" make the reader decode it the slow way";
+  message.lines = {"plain", "tab\there"};
+  message.tags.push_back({"k", "v"});
+  std::string json;
+  fr::autocereal::detail::json::writeValue(json, message);
+
+  PmrLoadMessage copy;
+  fr::autocereal::detail::json::JsonReader in(json);
+  fr::autocereal::detail::json::readValue(in, copy);
+  ASSERT_EQ(copy.id, 6);
+  ASSERT_EQ(copy.body, message.body);
+  ASSERT_EQ(copy.lines, message.lines);
+  ASSERT_EQ(copy.tags[0].value, "v");
+}
+
+TEST(PmrLoad, Binary) {
+  PmrLoadMessage message;
+  message.id = 4;
+  message.tags.push_back({"k", "a value that doesn't fit in the small string buffer"});
+  std::stringstream stream;
+  fr::autocereal::to_binary(message, stream);
+
+  std::pmr::monotonic_buffer_resource arena;
+  PmrLoadMessage copy;
+  fr::autocereal::from_binary(copy, stream, &arena);
+  ASSERT_EQ(copy.id, 4);
+  ASSERT_EQ(copy.tags[0].value, message.tags[0].value);
+  ASSERT_EQ(copy.tags[0].value.get_allocator().resource(), &arena);
+}
+
+TEST(PmrLoad, Xml) {
+  PmrLoadMessage message;
+  message.id = 5;
+  message.body = "a body long enough to need an allocation of its own";
+  std::stringstream stream;
+  fr::autocereal::to_xml(message, stream);
+
+  std::pmr::monotonic_buffer_resource arena;
+  PmrLoadMessage copy;
+  cereal::XMLInputArchive ar(stream);
+  fr::autocereal::from_input_archive(copy, ar, &arena);
+  ASSERT_EQ(copy.id, 5);
+  ASSERT_EQ(copy.body, message.body);
+  ASSERT_EQ(copy.body.get_allocator().resource(), &arena);
+}
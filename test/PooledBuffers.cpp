@@ -0,0 +1,101 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include "AllocationCounter.h"
+#include <fr/autocereal/autocereal.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct PooledBuffersRecord {
+  int id;
+  std::string name;
+  std::vector<double> values;
+};
+
+// The pooled string versions have to produce exactly what the stream
+// versions do, however many times the buffer's been reused
+
+TEST(PooledBuffers, MatchesStreamOutput) {
+  for (int i = 0; i < 20; ++i) {
+    PooledBuffersRecord record{i, std::string(i * 10, 'n'), std::vector<double>(i, 0.5)};
+
+    std::stringstream json;
+    fr::autocereal::to_json(record, json);
+    ASSERT_EQ(fr::autocereal::to_json(record), json.str());
+
+    std::stringstream xml;
+    fr::autocereal::to_xml(record, xml);
+    ASSERT_EQ(fr::autocereal::to_xml(record), xml.str());
+  }
+}
+
+TEST(PooledBuffers, ReusesCallerString) {
+  PooledBuffersRecord big{1, std::string(1000, 'b'), std::vector<double>(100, 1.5)};
+  PooledBuffersRecord small{2, "small", {}};
+
+  std::string out;
+  fr::autocereal::to_json(big, out);
+  size_t capacity = out.capacity();
+  const char* data = out.data();
+
+  fr::autocereal::to_json(small, out);
+  ASSERT_EQ(out, fr::autocereal::to_json(small));
+  ASSERT_EQ(out.capacity(), capacity);
+  ASSERT_EQ(out.data(), data);
+
+  PooledBuffersRecord copy;
+  fr::autocereal::from_json(copy, out);
+  ASSERT_EQ(copy.id, 2);
+  ASSERT_EQ(copy.name, "small");
+
+  fr::autocereal::to_xml(big, out);
+  fr::autocereal::from_xml(copy, out);
+  ASSERT_EQ(copy.name, big.name);
+  ASSERT_EQ(copy.values, big.values);
+}
+
+// Once the caller's string is big enough, to_json into it doesn't
+// allocate anything the size of the output. cereal's JSON archive
+// still allocates its own bookkeeping every call, so the count isn't
+// zero, just small and independent of the object's size.
+
+TEST(PooledBuffers, CallerStringSteadyState) {
+  PooledBuffersRecord big{1, std::string(64 * 1024, 'b'), std::vector<double>(1000, 1.5)};
+  std::string out;
+  fr::autocereal::to_json(big, out);
+  size_t capacity = out.capacity();
+
+  size_t bytes = 0;
+  size_t allocations = 0;
+  {
+    AllocationCounter counter;
+    fr::autocereal::to_json(big, out);
+    bytes = counter.bytes();
+    allocations = counter.count();
+  }
+  ASSERT_EQ(out.capacity(), capacity);
+  ASSERT_LT(bytes, out.size() / 16);
+
+  // A much smaller object costs the same number of allocations
+  PooledBuffersRecord small{2, "small", {}};
+  {
+    AllocationCounter counter;
+    fr::autocereal::to_json(small, out);
+    ASSERT_EQ(counter.count(), allocations);
+  }
+}
@@ -0,0 +1,134 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include "AllocationCounter.h"
+#include <fr/autocereal/autocereal.h>
+#include <fr/autocereal/json.h>
+#include <cereal/types/optional.hpp>
+#include <cereal/types/string.hpp>
+#include <memory>
+#include <optional>
+#include <span>
+#include <spanstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct ReuseLoadPart {
+  int number;
+  std::string label;
+  std::vector<double> readings;
+};
+
+struct ReuseLoadMessage {
+  int id;
+  std::string body;
+  std::vector<ReuseLoadPart> parts;
+  std::optional<ReuseLoadPart> extra;
+  std::unique_ptr<ReuseLoadPart> owned;
+};
+
+static ReuseLoadMessage makeMessage(int seed) {
+  ReuseLoadMessage message;
+  message.id = seed;
+  message.body = "message body " + std::to_string(seed) + std::string(100, 'b');
+  for (int i = 0; i < 10; ++i) {
+    message.parts.push_back({i, "part label long enough to live on the heap " + std::to_string(i), std::vector<double>(20, seed)});
+  }
+  message.extra = ReuseLoadPart{-1, "the optional part, which is also on the heap", {1.0, 2.0}};
+  message.owned = std::make_unique<ReuseLoadPart>(-2, "the owned part, which is also on the heap", std::vector<double>{3.0});
+  return message;
+}
+
+// The pattern consumers use: one message object, decoded into over
+// and over. After the first decode it has all the capacity it needs.
+
+TEST(ReuseLoad, BinaryDecodeAllocatesNothing) {
+  std::vector<std::string> encoded;
+  for (int seed = 0; seed < 4; ++seed) {
+    std::stringstream stream;
+    fr::autocereal::to_binary(makeMessage(seed), stream);
+    encoded.push_back(stream.str());
+  }
+
+  ReuseLoadMessage message;
+  auto decode = [&](const std::string& bytes) {
+    std::ispanstream stream(std::span<const char>(bytes.data(), bytes.size()));
+    fr::autocereal::from_binary(message, stream);
+  };
+  decode(encoded[0]);
+
+  const char* body = message.body.data();
+  const ReuseLoadPart* owned = message.owned.get();
+
+  AllocationCounter counter;
+  for (int round = 0; round < 10; ++round) {
+    for (const auto& bytes : encoded) {
+      decode(bytes);
+    }
+  }
+  ASSERT_EQ(counter.count(), 0);
+  ASSERT_EQ(message.body.data(), body);
+  ASSERT_EQ(message.owned.get(), owned);
+  ASSERT_EQ(message.id, 3);
+  ASSERT_EQ(message.parts[9].readings[0], 3.0);
+  ASSERT_EQ(message.extra->label, "the optional part, which is also on the heap");
+}
+
+TEST(ReuseLoad, NativeJsonDecodeAllocatesNothing) {
+  std::vector<std::vector<ReuseLoadPart>> batches(3);
+  std::vector<std::string> encoded;
+  for (int seed = 0; seed < 3; ++seed) {
+    batches[seed] = makeMessage(seed).parts;
+    encoded.push_back(fr::autocereal::to_json_array(batches[seed], 1));
+  }
+
+  std::vector<ReuseLoadPart> parts;
+  fr::autocereal::from_json_array(parts, encoded[0], 1, fr::autocereal::JsonReuse::InPlace);
+
+  AllocationCounter counter;
+  for (int round = 0; round < 10; ++round) {
+    for (const auto& json : encoded) {
+      fr::autocereal::from_json_array(parts, json, 1, fr::autocereal::JsonReuse::InPlace);
+    }
+  }
+  ASSERT_EQ(counter.count(), 0);
+  ASSERT_EQ(parts.size(), 10);
+  ASSERT_EQ(parts[9].readings[0], 2.0);
+}
+
+// cereal's JSON archive builds a DOM, so it allocates regardless, but
+// the object's own storage still gets reused
+
+TEST(ReuseLoad, CerealJsonKeepsCapacity) {
+  std::string first = fr::autocereal::to_json(makeMessage(1));
+  std::string second = fr::autocereal::to_json(makeMessage(2));
+
+  ReuseLoadMessage message;
+  fr::autocereal::from_json(message, first);
+  const char* body = message.body.data();
+  const char* label = message.parts[5].label.data();
+  const ReuseLoadPart* owned = message.owned.get();
+  const char* extra = message.extra->label.data();
+
+  fr::autocereal::from_json(message, second);
+  ASSERT_EQ(message.id, 2);
+  ASSERT_EQ(message.body.data(), body);
+  ASSERT_EQ(message.parts[5].label.data(), label);
+  ASSERT_EQ(message.owned.get(), owned);
+  ASSERT_EQ(message.extra->label.data(), extra);
+}
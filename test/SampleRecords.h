@@ -0,0 +1,65 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cereal/types/optional.hpp>
+#include <cereal/types/string.hpp>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * The record the collection writer tests (batch, pipeline, chunked,
+ * compressed and parallel JSON) all push through in bulk. It has a
+ * base class, a name that needs escaping in JSON, an optional that's
+ * empty every third record and a vector whose length varies, so the
+ * batch and chunk boundaries land between differently sized elements.
+ */
+
+struct SampleBase {
+  int id;
+};
+
+struct SampleRecord : public SampleBase {
+  std::string name;
+  std::optional<double> score;
+  std::vector<double> values;
+};
+
+inline std::vector<SampleRecord> makeSampleRecords(size_t count) {
+  std::vector<SampleRecord> records(count);
+  for (size_t i = 0; i < count; ++i) {
+    records[i].id = static_cast<int>(i);
+    records[i].name = "record \"" + std::to_string(i) + "\"";
+    if (i % 3 != 0) {
+      records[i].score = i / 7.0;
+    }
+    records[i].values.assign(i % 5, i * 0.25);
+  }
+  return records;
+}
+
+inline void expectSameRecords(const std::vector<SampleRecord>& copy, const std::vector<SampleRecord>& records) {
+  ASSERT_EQ(copy.size(), records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    ASSERT_EQ(copy[i].id, records[i].id);
+    ASSERT_EQ(copy[i].name, records[i].name);
+    ASSERT_EQ(copy[i].score, records[i].score);
+    ASSERT_EQ(copy[i].values, records[i].values);
+  }
+}
@@ -0,0 +1,257 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/schema_binary.h>
+#include <cereal/types/map.hpp>
+#include <cereal/types/optional.hpp>
+#include <cereal/types/string.hpp>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct SchemaInnerV1 {
+  int16_t x;
+  std::string gone;
+  int16_t y;
+};
+
+struct SchemaMessageV1 {
+  uint32_t id;
+  std::string name;
+  int32_t count;
+  std::string dropped;
+  std::vector<float> samples;
+  SchemaInnerV1 inner;
+  std::vector<SchemaInnerV1> items;
+};
+
+// Members reordered, retyped, added and removed, inner struct too
+struct SchemaInnerV2 {
+  int64_t y;
+  int64_t x;
+  std::string label = "new";
+};
+
+struct SchemaMessageV2 {
+  std::string name;
+  std::optional<int64_t> count;
+  uint32_t id;
+  std::string added = "default";
+  std::vector<double> samples;
+  SchemaInnerV2 inner;
+  std::vector<SchemaInnerV2> items;
+};
+
+struct SchemaOpaqueV1 {
+  int id;
+  std::map<std::string, int> counts;
+};
+
+struct SchemaOpaqueV2 {
+  int id;
+};
+
+static SchemaMessageV1 makeV1(uint32_t id) {
+  SchemaMessageV1 message;
+  message.id = id;
+  message.name = "message " + std::to_string(id);
+  message.count = -static_cast<int32_t>(id);
+  message.dropped = "nobody reads this any more";
+  message.samples = {0.5f, 1.5f};
+  message.inner = {1, "gone", 2};
+  message.items = {{3, "a", 4}, {5, "b", 6}};
+  return message;
+}
+
+TEST(SchemaBinary, SameSchemaReadsExactly) {
+  std::stringstream stream;
+  {
+    fr::autocereal::schema_binary_writer<SchemaMessageV1> writer(stream);
+    writer << makeV1(1) << makeV1(2);
+  }
+
+  fr::autocereal::schema_binary_reader<SchemaMessageV1> reader(stream);
+  ASSERT_TRUE(reader.exact());
+  SchemaMessageV1 copy;
+  ASSERT_TRUE(reader.read(copy));
+  ASSERT_EQ(copy.id, 1);
+  ASSERT_TRUE(reader.read(copy));
+  ASSERT_EQ(copy.name, "message 2");
+  ASSERT_EQ(copy.items[1].y, 6);
+  ASSERT_FALSE(reader.read(copy));
+}
+
+TEST(SchemaBinary, SchemaWrittenOnce) {
+  std::ostringstream one;
+  {
+    fr::autocereal::schema_binary_writer<SchemaMessageV1> writer(one);
+    writer.write(makeV1(1));
+  }
+  std::ostringstream two;
+  {
+    fr::autocereal::schema_binary_writer<SchemaMessageV1> writer(two);
+    writer.write(makeV1(1));
+    writer.write(makeV1(1));
+  }
+  std::ostringstream plain;
+  fr::autocereal::to_binary(makeV1(1), plain);
+  ASSERT_EQ(two.str().size() - one.str().size(), plain.str().size());
+}
+
+TEST(SchemaBinary, MapsByName) {
+  std::stringstream stream;
+  {
+    fr::autocereal::schema_binary_writer<SchemaMessageV1> writer(stream);
+    for (uint32_t id = 1; id <= 3; ++id) {
+      writer.write(makeV1(id));
+    }
+  }
+
+  fr::autocereal::schema_binary_reader<SchemaMessageV2> reader(stream);
+  ASSERT_FALSE(reader.exact());
+  std::vector<SchemaMessageV2> copies;
+  SchemaMessageV2 copy;
+  while (reader.read(copy)) {
+    copies.push_back(copy);
+  }
+  ASSERT_EQ(copies.size(), 3);
+
+  const SchemaMessageV2& last = copies[2];
+  ASSERT_EQ(last.id, 3);
+  ASSERT_EQ(last.name, "message 3");
+  ASSERT_EQ(last.count, -3);
+  ASSERT_EQ(last.added, "default");
+  ASSERT_EQ(last.samples, (std::vector<double>{0.5, 1.5}));
+  ASSERT_EQ(last.inner.x, 1);
+  ASSERT_EQ(last.inner.y, 2);
+  ASSERT_EQ(last.inner.label, "new");
+  ASSERT_EQ(last.items.size(), 2);
+  ASSERT_EQ(last.items[1].x, 5);
+  ASSERT_EQ(last.items[1].y, 6);
+}
+
+TEST(SchemaBinary, SingleObject) {
+  std::stringstream stream;
+  fr::autocereal::to_schema_binary(makeV1(9), stream);
+  SchemaMessageV2 copy;
+  fr::autocereal::from_schema_binary(copy, stream);
+  ASSERT_EQ(copy.id, 9);
+  ASSERT_EQ(copy.inner.y, 2);
+}
+
+TEST(SchemaBinary, OpaqueMembersLoadButDontSkip) {
+  std::stringstream stream;
+  fr::autocereal::to_schema_binary(SchemaOpaqueV1{4, {{"a", 1}}}, stream);
+  std::string bytes = stream.str();
+
+  std::istringstream same(bytes);
+  SchemaOpaqueV1 copy;
+  fr::autocereal::from_schema_binary(copy, same);
+  ASSERT_EQ(copy.counts.at("a"), 1);
+
+  std::istringstream newer(bytes);
+  SchemaOpaqueV2 dropped;
+  ASSERT_THROW(fr::autocereal::from_schema_binary(dropped, newer), cereal::Exception);
+}
+
+// Classes with constructors and private members get mapped by name
+// like any other record
+
+class SchemaClassV1 {
+public:
+  SchemaClassV1() = default;
+  SchemaClassV1(int32_t id, std::string name) : _id(id), _name(std::move(name)) {}
+
+private:
+  int32_t _id = 0;
+  std::string _name;
+};
+
+class SchemaClassV2 {
+public:
+  SchemaClassV2() = default;
+
+  const std::string& name() const {
+    return _name;
+  }
+
+  int64_t id() const {
+    return _id;
+  }
+
+  int flags() const {
+    return _flags;
+  }
+
+private:
+  std::string _name;
+  int64_t _id = 0;
+  int _flags = 7;
+};
+
+TEST(SchemaBinary, ClassesMapByName) {
+  std::stringstream stream;
+  fr::autocereal::to_schema_binary(SchemaClassV1(12, "twelve"), stream);
+  SchemaClassV2 copy;
+  fr::autocereal::from_schema_binary(copy, stream);
+  ASSERT_EQ(copy.id(), 12);
+  ASSERT_EQ(copy.name(), "twelve");
+  ASSERT_EQ(copy.flags(), 7);
+}
+
+TEST(SchemaBinary, IncompatibleTypesThrow) {
+  struct Wrong {
+    std::string id;
+  };
+  std::stringstream stream;
+  fr::autocereal::to_schema_binary(makeV1(1), stream);
+  Wrong wrong;
+  ASSERT_THROW(fr::autocereal::from_schema_binary(wrong, stream), cereal::Exception);
+}
+
+TEST(SchemaBinary, NotASchemaFile) {
+  std::stringstream stream;
+  fr::autocereal::to_binary(makeV1(1), stream);
+  SchemaMessageV1 copy;
+  ASSERT_THROW(fr::autocereal::from_schema_binary(copy, stream), cereal::Exception);
+}
+
+// A record that holds itself, directly or through a std::array, can't
+// come out of a real type. It used to send the migrator round in
+// circles until the stack ran out.
+
+TEST(SchemaBinary, SelfContainedRecordThrows) {
+  using namespace fr::autocereal::detail::schema;
+  for (uint32_t field : {1u, 2u}) {
+    Schema schema;
+    schema.root = 1;
+    schema.types = {{FieldKind::Int, 4}, {FieldKind::Record, 0, 0, 0}, {FieldKind::Array, 0, 2, 1}};
+    schema.records = {{{{"self", field}}}};
+
+    std::stringstream stream;
+    {
+      cereal::BinaryOutputArchive ar(stream);
+      schema.save(ar);
+    }
+    SchemaMessageV1 copy;
+    ASSERT_THROW(fr::autocereal::from_schema_binary(copy, stream), cereal::Exception);
+  }
+}
@@ -0,0 +1,150 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/serialized_size.h>
+#include <cereal/types/array.hpp>
+#include <cereal/types/map.hpp>
+#include <cereal/types/optional.hpp>
+#include <cereal/types/string.hpp>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+enum class SizedColor : uint8_t { Red, Green };
+
+struct SizedPoint {
+  int32_t x;
+  int32_t y;
+};
+
+struct SizedFixed {
+  uint64_t id;
+  SizedColor color;
+  SizedPoint where;
+  std::array<double, 3> scale;
+};
+
+struct SizedDynamic : public SizedPoint {
+  std::string name;
+  std::vector<int16_t> samples;
+  std::vector<SizedPoint> path;
+  std::vector<std::string> tags;
+  std::optional<SizedFixed> fixed;
+  std::optional<std::string> missing;
+  std::unique_ptr<SizedPoint> owned;
+  std::shared_ptr<SizedFixed> first;
+  std::shared_ptr<SizedFixed> second;
+  std::map<std::string, int> counts;
+};
+
+// One pointee reached through a member we walk and through a map
+// cereal writes for us, in both orders
+
+struct SizedSharedMixed {
+  std::shared_ptr<SizedFixed> before;
+  std::map<int, std::shared_ptr<SizedFixed>> byId;
+  std::shared_ptr<SizedFixed> after;
+};
+
+static_assert(fr::autocereal::HasFixedSerializedSize<SizedFixed>);
+static_assert(!fr::autocereal::HasFixedSerializedSize<SizedDynamic>);
+static_assert(fr::autocereal::serialized_size<SizedFixed>() == 8 + 1 + 8 + 24);
+static_assert(fr::autocereal::serialized_size<SizedFixed, cereal::PortableBinaryOutputArchive>() == 42);
+
+static SizedDynamic makeDynamic() {
+  SizedDynamic dynamic;
+  dynamic.x = 1;
+  dynamic.y = 2;
+  dynamic.name = "a name that doesn't fit in the small string buffer";
+  dynamic.samples = {1, 2, 3, 4, 5};
+  dynamic.path = {{1, 2}, {3, 4}};
+  dynamic.tags = {"one", "two", ""};
+  dynamic.fixed = SizedFixed{5, SizedColor::Green, {6, 7}, {1.0, 2.0, 3.0}};
+  dynamic.owned = std::make_unique<SizedPoint>(8, 9);
+  dynamic.first = std::make_shared<SizedFixed>();
+  // Same pointer again, which cereal only writes out once
+  dynamic.second = dynamic.first;
+  dynamic.counts = {{"a", 1}, {"bb", 2}};
+  return dynamic;
+}
+
+TEST(SerializedSize, FixedMatchesOutput) {
+  SizedFixed fixed{1, SizedColor::Red, {2, 3}, {4.0, 5.0, 6.0}};
+  std::ostringstream stream;
+  fr::autocereal::to_binary(fixed, stream);
+  ASSERT_EQ(stream.str().size(), fr::autocereal::serialized_size<SizedFixed>());
+  ASSERT_EQ(fr::autocereal::serialized_size(fixed), stream.str().size());
+
+  auto bytes = fr::autocereal::to_binary_array(fixed);
+  ASSERT_EQ(std::string(bytes.data(), bytes.size()), stream.str());
+}
+
+TEST(SerializedSize, DynamicMatchesOutput) {
+  SizedDynamic dynamic = makeDynamic();
+  std::ostringstream stream;
+  fr::autocereal::to_binary(dynamic, stream);
+  ASSERT_EQ(fr::autocereal::serialized_size(dynamic), stream.str().size());
+}
+
+TEST(SerializedSize, SharedAcrossWalkedAndFallback) {
+  SizedSharedMixed mixed;
+  mixed.before = std::make_shared<SizedFixed>();
+  auto inMapFirst = std::make_shared<SizedFixed>();
+  mixed.byId = {{1, mixed.before}, {2, inMapFirst}};
+  mixed.after = inMapFirst;
+
+  std::ostringstream stream;
+  fr::autocereal::to_binary(mixed, stream);
+  ASSERT_EQ(fr::autocereal::serialized_size(mixed), stream.str().size());
+
+  std::string out;
+  fr::autocereal::to_binary(mixed, out);
+  ASSERT_EQ(out, stream.str());
+}
+
+TEST(SerializedSize, Portable) {
+  SizedDynamic dynamic = makeDynamic();
+  std::ostringstream stream;
+  {
+    cereal::PortableBinaryOutputArchive ar(stream);
+    ar(dynamic);
+  }
+  ASSERT_EQ(fr::autocereal::serialized_size<cereal::PortableBinaryOutputArchive>(dynamic), stream.str().size());
+}
+
+TEST(SerializedSize, ToBinaryString) {
+  SizedDynamic dynamic = makeDynamic();
+  std::ostringstream stream;
+  fr::autocereal::to_binary(dynamic, stream);
+
+  std::string out;
+  fr::autocereal::to_binary(dynamic, out);
+  ASSERT_EQ(out, stream.str());
+
+  // And it reads back like any other to_binary output
+  std::istringstream in(out);
+  SizedDynamic copy;
+  fr::autocereal::from_binary(copy, in);
+  ASSERT_EQ(copy.name, dynamic.name);
+  ASSERT_EQ(copy.first.get(), copy.second.get());
+  ASSERT_EQ(copy.counts.at("bb"), 2);
+}
@@ -0,0 +1,145 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/autocereal.h>
+#include <cereal/types/string.hpp>
+#include <memory>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct SharedPoolLeaf {
+  int value;
+  std::string name;
+};
+
+struct SharedPoolGraph {
+  std::shared_ptr<SharedPoolLeaf> first;
+  std::shared_ptr<SharedPoolLeaf> second;
+  std::shared_ptr<SharedPoolLeaf> missing;
+  std::vector<std::shared_ptr<SharedPoolLeaf>> leaves;
+};
+
+/**
+ * Counts what's currently allocated from it
+ */
+
+class CountingResource : public std::pmr::memory_resource {
+public:
+  size_t live = 0;
+  size_t total = 0;
+
+private:
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    ++live;
+    ++total;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    --live;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+static SharedPoolGraph makeGraph() {
+  SharedPoolGraph graph;
+  graph.first = std::make_shared<SharedPoolLeaf>(1, "first");
+  // Same node twice, which has to stay the same node after loading
+  graph.second = graph.first;
+  for (int i = 0; i < 10; ++i) {
+    graph.leaves.push_back(std::make_shared<SharedPoolLeaf>(i, "leaf " + std::to_string(i)));
+  }
+  graph.leaves.push_back(graph.first);
+  return graph;
+}
+
+static void checkGraph(const SharedPoolGraph& copy) {
+  ASSERT_TRUE(copy.first);
+  ASSERT_EQ(copy.first->value, 1);
+  ASSERT_EQ(copy.first->name, "first");
+  ASSERT_EQ(copy.first.get(), copy.second.get());
+  ASSERT_FALSE(copy.missing);
+  ASSERT_EQ(copy.leaves.size(), 11);
+  ASSERT_EQ(copy.leaves[4]->name, "leaf 4");
+  ASSERT_EQ(copy.leaves[10].get(), copy.first.get());
+}
+
+TEST(SharedPool, BinaryFromCallersResource) {
+  std::stringstream stream;
+  fr::autocereal::to_binary(makeGraph(), stream);
+
+  CountingResource counting;
+  {
+    fr::autocereal::SharedPool pool(&counting);
+    SharedPoolGraph copy;
+    fr::autocereal::from_binary(copy, stream, pool);
+    checkGraph(copy);
+    // first plus the ten leaves, one allocation each
+    ASSERT_EQ(counting.total, 11);
+    ASSERT_EQ(counting.live, 11);
+  }
+  ASSERT_EQ(counting.live, 0);
+}
+
+TEST(SharedPool, JsonFromCallersResource) {
+  std::string json = fr::autocereal::to_json(makeGraph());
+
+  CountingResource counting;
+  fr::autocereal::SharedPool pool(&counting);
+  SharedPoolGraph copy;
+  fr::autocereal::from_json(copy, json, pool);
+  checkGraph(copy);
+  ASSERT_EQ(counting.live, 11);
+}
+
+TEST(SharedPool, OwnPoolOutlivesTheSharedPool) {
+  std::stringstream stream;
+  fr::autocereal::to_binary(makeGraph(), stream);
+
+  SharedPoolGraph copy;
+  {
+    fr::autocereal::SharedPool pool;
+    fr::autocereal::from_binary(copy, stream, pool);
+  }
+  checkGraph(copy);
+  copy.leaves[3]->name = "still here after the pool went away";
+  ASSERT_EQ(copy.leaves[3]->name, "still here after the pool went away");
+}
+
+TEST(SharedPool, NoPoolNoChange) {
+  std::stringstream stream;
+  fr::autocereal::to_binary(makeGraph(), stream);
+
+  CountingResource counting;
+  fr::autocereal::SharedPool pool(&counting);
+  SharedPoolGraph first;
+  fr::autocereal::from_binary(first, stream, pool);
+
+  // Without a pool this time, so nothing more comes from counting
+  std::stringstream again;
+  fr::autocereal::to_binary(makeGraph(), again);
+  SharedPoolGraph second;
+  fr::autocereal::from_binary(second, again);
+  checkGraph(second);
+  ASSERT_EQ(counting.total, 11);
+}
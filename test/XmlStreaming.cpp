@@ -0,0 +1,141 @@
+/**
+ * Copyright 2026 Bruce Ide
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <fr/autocereal/xml.h>
+#include <memory>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct XmlStreamingInner {
+  int a;
+  std::string s;
+};
+
+struct XmlStreamingBase {
+  int id;
+};
+
+struct XmlStreamingRecord : public XmlStreamingBase {
+  std::string text;
+  double ratio;
+  bool flag;
+  std::vector<XmlStreamingInner> inners;
+  std::shared_ptr<XmlStreamingInner> first;
+  std::shared_ptr<XmlStreamingInner> second;
+  std::unique_ptr<XmlStreamingInner> owned;
+  std::unique_ptr<XmlStreamingInner> missing;
+};
+
+static XmlStreamingRecord makeRecord() {
+  XmlStreamingRecord record;
+  record.id = 12;
+  record.text = "  <angle> & \"quoted\"  ";
+  record.ratio = 0.1;
+  record.flag = true;
+  for (int i = 0; i < 50; ++i) {
+    record.inners.push_back({i, "inner " + std::to_string(i)});
+  }
+  record.first = std::make_shared<XmlStreamingInner>(1, "shared");
+  record.second = record.first;
+  record.owned = std::make_unique<XmlStreamingInner>(2, "owned");
+  return record;
+}
+
+// Tiny buffers make sure nothing depends on a tag landing in one read
+
+TEST(XmlStreaming, ReadsToXmlOutput) {
+  XmlStreamingRecord record = makeRecord();
+  std::string xml = fr::autocereal::to_xml(record);
+
+  for (size_t bufferSize : {1, 7, 4096}) {
+    std::stringstream stream(xml);
+    XmlStreamingRecord copy;
+    fr::autocereal::from_xml_streaming(copy, stream, bufferSize);
+
+    ASSERT_EQ(copy.id, record.id);
+    ASSERT_EQ(copy.text, record.text);
+    ASSERT_EQ(copy.ratio, record.ratio);
+    ASSERT_EQ(copy.flag, record.flag);
+    ASSERT_EQ(copy.inners.size(), record.inners.size());
+    ASSERT_EQ(copy.inners[49].s, "inner 49");
+    ASSERT_NE(copy.first, nullptr);
+    ASSERT_EQ(copy.first->s, "shared");
+    ASSERT_EQ(copy.first, copy.second);
+    ASSERT_NE(copy.owned, nullptr);
+    ASSERT_EQ(copy.owned->a, 2);
+    ASSERT_EQ(copy.missing, nullptr);
+  }
+}
+
+// Something a person wrote: members out of order, comments, CDATA,
+// elements we don't know about
+
+TEST(XmlStreaming, HandWritten) {
+  std::stringstream stream(R"(<?xml version="1.0"?>
+<!-- feed -->
+<cereal>
+  <value0>
+    <text><![CDATA[a <b> c]]></text>
+    <unknown><deeper>ignored</deeper></unknown>
+    <inners>
+      <item><s>x &amp; y</s><a>3</a></item>
+      <item/>
+    </inners>
+    <id>
+      5
+    </id>
+  </value0>
+</cereal>
+trailing junk the reader never gets to)");
+
+  XmlStreamingRecord copy;
+  fr::autocereal::from_xml_streaming(copy, stream);
+  ASSERT_EQ(copy.id, 5);
+  ASSERT_EQ(copy.text, "a <b> c");
+  ASSERT_EQ(copy.inners.size(), 2);
+  ASSERT_EQ(copy.inners[0].a, 3);
+  ASSERT_EQ(copy.inners[0].s, "x & y");
+}
+
+struct XmlStreamingPmr {
+  std::pmr::string name;
+  std::pmr::vector<std::pmr::string> lines;
+};
+
+TEST(XmlStreaming, PmrStrings) {
+  XmlStreamingPmr record{"a name & an entity, long enough to allocate", {"one", "two"}};
+  std::stringstream stream(fr::autocereal::to_xml(record));
+
+  XmlStreamingPmr copy;
+  fr::autocereal::from_xml_streaming(copy, stream);
+  ASSERT_EQ(copy.name, record.name);
+  ASSERT_EQ(copy.lines, record.lines);
+}
+
+TEST(XmlStreaming, MalformedThrows) {
+  XmlStreamingRecord copy;
+  std::stringstream mismatched("<cereal><value0><id>1</text></value0></cereal>");
+  ASSERT_THROW(fr::autocereal::from_xml_streaming(copy, mismatched), cereal::Exception);
+
+  std::stringstream truncated("<cereal><value0><id>1</id>");
+  ASSERT_THROW(fr::autocereal::from_xml_streaming(copy, truncated), cereal::Exception);
+
+  std::stringstream badNumber("<cereal><value0><id>one</id></value0></cereal>");
+  ASSERT_THROW(fr::autocereal::from_xml_streaming(copy, badNumber), cereal::Exception);
+}